@@ -0,0 +1,93 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <span>
+#include <array>
+#include <chrono>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Counts leaf nodes copying the board for each child, every leaf is visited so the cost of making moves is measured
+		*/
+		size_t count_nodes_copying(const BoardWithState& _board, int _depth)
+		{
+			if (_depth == 0)
+			{
+				return 1;
+			};
+			std::array<Move, 256> _buffer{};
+			const auto _count = find_possible_moves(_board, _buffer);
+
+			size_t _nodes = 0;
+			for (auto& m : std::span{ _buffer.data(), _count })
+			{
+				auto _child = _board;
+				apply_move(_child, m);
+				_nodes += count_nodes_copying(_child, _depth - 1);
+			};
+			return _nodes;
+		};
+
+		/**
+		 * @brief Counts leaf nodes walking a single board with make/unmake
+		*/
+		size_t count_nodes_unmaking(BoardWithState& _board, int _depth)
+		{
+			if (_depth == 0)
+			{
+				return 1;
+			};
+			std::array<Move, 256> _buffer{};
+			const auto _count = find_possible_moves(_board, _buffer);
+
+			size_t _nodes = 0;
+			for (auto& m : std::span{ _buffer.data(), _count })
+			{
+				const auto _undo = make_move(_board, m);
+				_nodes += count_nodes_unmaking(_board, _depth - 1);
+				unmake_move(_board, m, _undo);
+			};
+			return _nodes;
+		};
+	};
+
+	/**
+	 * @brief Copying the board for every child against make/unmake on a single board
+	*/
+	bool benchmark_apply_move(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+
+		auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		constexpr int _depth = 3;
+
+		// Alternate the two and keep the fastest run of each so warm up doesn't favour either
+		size_t _copyNodes = 0;
+		size_t _unmakeNodes = 0;
+		double _copySeconds = 1e9;
+		double _unmakeSeconds = 1e9;
+		for (int n = 0; n != 3; ++n)
+		{
+			auto _start = clock::now();
+			_copyNodes = count_nodes_copying(_board, _depth);
+			_copySeconds = std::min(_copySeconds, std::chrono::duration<double>(clock::now() - _start).count());
+
+			_start = clock::now();
+			_unmakeNodes = count_nodes_unmaking(_board, _depth);
+			_unmakeSeconds = std::min(_unmakeSeconds, std::chrono::duration<double>(clock::now() - _start).count());
+		};
+
+		lbx::println("copy + apply_move : {:.0f} nodes/s", _copyNodes / _copySeconds);
+		lbx::println("make/unmake       : {:.0f} nodes/s ({:.2f}x)", _unmakeNodes / _unmakeSeconds, _copySeconds / _unmakeSeconds);
+		return true;
+	};
+};
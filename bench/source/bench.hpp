@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+	Timing benchmarks for the chess library. These only report how fast things run, checking
+	that they give the right answers is left to the tests under chess/tests.
+*/
+
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Settings shared by the benchmarks, each only reads the ones it needs
+	*/
+	struct BenchOptions
+	{
+		/**
+		 * @brief Position to search instead of the defaults, needs depth
+		*/
+		std::optional<std::string> fen{};
+
+		/**
+		 * @brief Depth to search to instead of the defaults
+		*/
+		std::optional<int> depth{};
+
+		/**
+		 * @brief Most threads to search with
+		*/
+		size_t max_threads = 32;
+
+		/**
+		 * @brief Transposition table size in megabytes
+		*/
+		size_t hash_mb = 16;
+	};
+
+	/**
+	 * @brief Written to by consume(), being volatile every store to it has to happen
+	*/
+	inline volatile uint64_t bench_sink_v = 0;
+
+	/**
+	 * @brief Keeps a result alive so the optimizer can't throw away the work that made it
+	*/
+	inline void consume(uint64_t _value) noexcept
+	{
+		bench_sink_v = _value;
+	};
+
+	/**
+	 * @brief Slider attack lookups against scanning the path to every square
+	*/
+	bool benchmark_slider_attacks(const BenchOptions& _options);
+
+	/**
+	 * @brief Copying the board for every child against make/unmake on a single board
+	*/
+	bool benchmark_apply_move(const BenchOptions& _options);
+
+	/**
+	 * @brief Rating the children of a node in one batch against making, rating and unmaking each move
+	*/
+	bool benchmark_batch_rating(const BenchOptions& _options);
+
+	/**
+	 * @brief Rating an endgame tree with and without the evaluation cache
+	*/
+	bool benchmark_eval_cache(const BenchOptions& _options);
+
+	/**
+	 * @brief Rating moves with the terms fused into one pass against rating each term on its own
+	*/
+	bool benchmark_fused_rater(const BenchOptions& _options);
+
+	/**
+	 * @brief Full evaluation against lazy evaluation in a narrow window
+	*/
+	bool benchmark_lazy_evaluation(const BenchOptions& _options);
+
+	/**
+	 * @brief Mobility and king safety from attack sets against counting legal moves
+	*/
+	bool benchmark_mobility(const BenchOptions& _options);
+
+	/**
+	 * @brief The legal move generator against filtering attack sets through is_move_valid
+	*/
+	bool benchmark_move_generation(const BenchOptions& _options);
+
+	/**
+	 * @brief Pawn structure evaluation with and without the pawn hash table
+	*/
+	bool benchmark_pawn_structure(const BenchOptions& _options);
+
+	/**
+	 * @brief Time to depth of the Lazy SMP search with a doubling number of threads
+	 * @return False if a search didn't reach its depth
+	*/
+	bool benchmark_parallel_search(const BenchOptions& _options);
+};
@@ -0,0 +1,69 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/eval_cache.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <chrono>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		using CacheBenchRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity>;
+
+		/**
+		 * @brief Rates every move down to a depth the way the tree builder does, returns the sum of the ratings
+		*/
+		template <typename RaterT>
+		int64_t rate_tree(BoardWithState& _board, int _depth, const RaterT& _rater)
+		{
+			int64_t _sum = 0;
+			for (auto& m : find_possible_moves(_board))
+			{
+				_sum += rate_move(_board, m, _rater).get_rating();
+				if (_depth > 1)
+				{
+					const auto _undo = make_move(_board, m);
+					_sum += rate_tree(_board, _depth - 1, _rater);
+					unmake_move(_board, m, _undo);
+				};
+			};
+			return _sum;
+		};
+	};
+
+	/**
+	 * @brief Rating an endgame tree with and without the evaluation cache
+	*/
+	bool benchmark_eval_cache(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+
+		// Rook endgame, lots of transpositions
+		auto _board = create_board_from_fen("8/8/4k3/8/2p5/8/2K1R3/8 w - - 0 1");
+		constexpr int _depth = 5;
+
+		const auto _start = clock::now();
+		consume(rate_tree(_board, _depth, CacheBenchRater{}));
+		const auto _uncachedSeconds = std::chrono::duration<double>(clock::now() - _start).count();
+
+		EvalCache _cache{ 16 };
+		EvalCacheStats _stats{};
+		const BoardRater_Cached<CacheBenchRater> _cached{ _cache, {}, &_stats };
+
+		const auto _cachedStart = clock::now();
+		consume(rate_tree(_board, _depth, _cached));
+		const auto _cachedSeconds = std::chrono::duration<double>(clock::now() - _cachedStart).count();
+
+		const auto _lookups = _stats.hits + _stats.misses;
+		lbx::println("uncached : {:.3f} ms", _uncachedSeconds * 1000.0);
+		lbx::println("cached   : {:.3f} ms ({:.2f}x), {:.1f}% of {} lookups hit",
+			_cachedSeconds * 1000.0, _uncachedSeconds / _cachedSeconds, 100.0 * _stats.hits / _lookups, _lookups);
+		return true;
+	};
+};
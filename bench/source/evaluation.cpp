@@ -0,0 +1,290 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/evaluation.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Rates each term on its own, the way the tree engine's rater used to
+		*/
+		struct SequentialRater
+		{
+			Rating rate(const BoardWithState& _board, Color _player) const
+			{
+				Rating _checkmate = 0;
+				if (is_checkmate(_board, _player))
+				{
+					_checkmate = -1000000;
+				}
+				else if (is_checkmate(_board, !_player))
+				{
+					_checkmate = 1000000;
+				};
+
+				const auto _final = lbx::chess::rate<BoardRater_PieceSquare>(_board, _player) + _checkmate +
+					lbx::chess::rate(_board, _player, BoardRater_CastleOpportunity{ 20, 20 });
+				return std::clamp(_final, -1000000, 1000000);
+			};
+		};
+
+		/**
+		 * @brief Same terms as SequentialRater, fused
+		*/
+		struct FusedRater
+		{
+			Rating rate(const BoardWithState& _board, Color _player) const
+			{
+				return std::clamp(this->terms_.rate(_board, _player), -1000000, 1000000);
+			};
+
+			BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity> terms_
+			{
+				BoardRater_PieceSquare{}, BoardRater_Checkmate{}, BoardRater_CastleOpportunity{ 20, 20 }
+			};
+		};
+
+		/**
+		 * @brief Collects positions by playing random games from kiwipete
+		*/
+		std::vector<BoardWithState> make_rating_positions()
+		{
+			std::vector<BoardWithState> _out{};
+
+			// Fixed seed so runs can be compared
+			std::mt19937 _rng{ 11 };
+			const auto _start = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+			for (int _game = 0; _game != 20; ++_game)
+			{
+				auto _board = _start;
+				for (int _ply = 0; _ply != 60; ++_ply)
+				{
+					_out.push_back(_board);
+					const auto _moves = find_possible_moves(_board);
+					if (_moves.empty())
+					{
+						break;
+					};
+					apply_move(_board, _moves.at(_rng() % _moves.size()));
+				};
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Rates every move from every position, the same work the tree builder does per node
+		*/
+		template <typename RaterT>
+		Rating rate_all_moves(std::vector<BoardWithState>& _positions, const RaterT& _rater)
+		{
+			Rating _sum = 0;
+			for (auto& b : _positions)
+			{
+				for (auto& m : find_possible_moves(b))
+				{
+					_sum += rate_move(b, m, _rater).get_rating();
+				};
+			};
+			return _sum;
+		};
+
+		/**
+		 * @brief Seconds since a point in time
+		*/
+		double seconds_since(std::chrono::steady_clock::time_point _start)
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+		};
+	};
+
+	/**
+	 * @brief Rating moves with the terms fused into one pass against rating each term on its own
+	*/
+	bool benchmark_fused_rater(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+		auto _positions = make_rating_positions();
+
+		// Alternate the two and keep the fastest run of each so warm up doesn't favour either
+		double _sequentialSeconds = 1e9;
+		double _fusedSeconds = 1e9;
+		for (int n = 0; n != 3; ++n)
+		{
+			auto _start = clock::now();
+			consume(rate_all_moves(_positions, SequentialRater{}));
+			_sequentialSeconds = std::min(_sequentialSeconds, seconds_since(_start));
+
+			_start = clock::now();
+			consume(rate_all_moves(_positions, FusedRater{}));
+			_fusedSeconds = std::min(_fusedSeconds, seconds_since(_start));
+		};
+
+		lbx::println("sequential terms : {:.3f} ms", _sequentialSeconds * 1000.0);
+		lbx::println("fused terms      : {:.3f} ms ({:.2f}x)", _fusedSeconds * 1000.0, _sequentialSeconds / _fusedSeconds);
+		return true;
+	};
+
+	/**
+	 * @brief Rating the children of a node in one batch against making, rating and unmaking each move
+	*/
+	bool benchmark_batch_rating(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+		using Terms = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity>;
+
+		auto _positions = make_rating_positions();
+		const auto _scalar = [&]()
+		{
+			Rating _sum = 0;
+			for (auto& b : _positions)
+			{
+				auto _moves = find_possible_moves(b);
+				for (size_t n = 0; n != _moves.size(); ++n)
+				{
+					_sum += rate_move(b, _moves[n], Terms{}).get_rating();
+				};
+			};
+			return _sum;
+		};
+		const auto _batched = [&]()
+		{
+			Rating _sum = 0;
+			for (auto& b : _positions)
+			{
+				auto _moves = find_possible_moves(b);
+				rate_children(b, _moves, Terms{});
+				for (size_t n = 0; n != _moves.size(); ++n)
+				{
+					_sum += _moves.score(n);
+				};
+			};
+			return _sum;
+		};
+
+		double _scalarSeconds = 1e9;
+		double _batchedSeconds = 1e9;
+		for (int n = 0; n != 3; ++n)
+		{
+			auto _start = clock::now();
+			consume(_scalar());
+			_scalarSeconds = std::min(_scalarSeconds, seconds_since(_start));
+
+			_start = clock::now();
+			consume(_batched());
+			_batchedSeconds = std::min(_batchedSeconds, seconds_since(_start));
+		};
+
+		lbx::println("make, rate, unmake : {:.3f} ms", _scalarSeconds * 1000.0);
+		lbx::println("rate_children      : {:.3f} ms ({:.2f}x)", _batchedSeconds * 1000.0, _scalarSeconds / _batchedSeconds);
+		return true;
+	};
+
+	/**
+	 * @brief Mobility and king safety from attack sets against counting legal moves
+	*/
+	bool benchmark_mobility(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+
+		const auto _positions = make_rating_positions();
+		const BoardRater_Fused<BoardRater_Mobility, BoardRater_KingSafety> _fused{};
+		constexpr int _repeats = 200;
+
+		double _best = 1e9;
+		for (int n = 0; n != 3; ++n)
+		{
+			Rating _sum = 0;
+			const auto _start = clock::now();
+			for (int r = 0; r != _repeats; ++r)
+			{
+				for (auto& b : _positions)
+				{
+					_sum += _fused.rate(b, b.turn);
+				};
+			};
+			_best = std::min(_best, seconds_since(_start));
+			consume(_sum);
+		};
+
+		// The same boards counting legal moves instead, what mobility would cost using move generation
+		size_t _moves = 0;
+		const auto _start = clock::now();
+		for (auto& b : _positions)
+		{
+			_moves += RatingContext{ b }.legal_move_count();
+		};
+		const auto _legalSeconds = seconds_since(_start);
+		consume(_moves);
+
+		const auto _boards = static_cast<double>(_positions.size());
+		lbx::println("mobility + king safety : {:.1f} ns/board", (_best * 1e9) / (_boards * _repeats));
+		lbx::println("legal move count       : {:.1f} ns/board", (_legalSeconds * 1e9) / _boards);
+		return true;
+	};
+
+	/**
+	 * @brief Full evaluation against lazy evaluation in a narrow window
+	*/
+	bool benchmark_lazy_evaluation(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+		using AllTerms = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity,
+			BoardRater_Mobility, BoardRater_KingSafety>;
+
+		const auto _positions = make_rating_positions();
+		const AllTerms _rater{};
+		constexpr int _repeats = 100;
+
+		// A window a pawn wide around level, as a search near equality would use
+		const RatingWindow _window{ -50, 50 };
+
+		LazyEvalStats _stats{};
+		double _fullSeconds = 1e9;
+		double _lazySeconds = 1e9;
+		for (int n = 0; n != 3; ++n)
+		{
+			_stats = {};
+			Rating _fullSum = 0;
+			auto _start = clock::now();
+			for (int r = 0; r != _repeats; ++r)
+			{
+				for (auto& b : _positions)
+				{
+					_fullSum += _rater.rate(b, b.turn);
+				};
+			};
+			_fullSeconds = std::min(_fullSeconds, seconds_since(_start));
+			consume(_fullSum);
+
+			Rating _lazySum = 0;
+			_start = clock::now();
+			for (int r = 0; r != _repeats; ++r)
+			{
+				for (auto& b : _positions)
+				{
+					_lazySum += _rater.rate(b, b.turn, _window, &_stats);
+				};
+			};
+			_lazySeconds = std::min(_lazySeconds, seconds_since(_start));
+			consume(_lazySum);
+		};
+
+		const auto _boards = static_cast<double>(_positions.size()) * _repeats;
+		lbx::println("full evaluation : {:.1f} ns/board", (_fullSeconds * 1e9) / _boards);
+		lbx::println("lazy evaluation : {:.1f} ns/board ({:.2f}x), {:.1f}% exited early",
+			(_lazySeconds * 1e9) / _boards, _fullSeconds / _lazySeconds, 100.0 * _stats.lazy_exits / _stats.evaluations);
+		return true;
+	};
+};
@@ -0,0 +1,172 @@
+/*
+	Runs the timing benchmarks for the chess library, these are kept out of the tests as they
+	take a while and check nothing.
+*/
+
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <string>
+#include <vector>
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+	/**
+	 * @brief A benchmark that can be picked by name from the command line
+	*/
+	struct Benchmark
+	{
+		std::string_view name;
+		bool(*run)(const lbx::chess::BenchOptions&);
+	};
+
+	/**
+	 * @brief Every benchmark in the order they run when none are named
+	*/
+	constexpr Benchmark benchmarks_v[] =
+	{
+		{ "slider_attacks", &lbx::chess::benchmark_slider_attacks },
+		{ "apply_move", &lbx::chess::benchmark_apply_move },
+		{ "move_generation", &lbx::chess::benchmark_move_generation },
+		{ "fused_rater", &lbx::chess::benchmark_fused_rater },
+		{ "eval_cache", &lbx::chess::benchmark_eval_cache },
+		{ "pawn_structure", &lbx::chess::benchmark_pawn_structure },
+		{ "batch_rating", &lbx::chess::benchmark_batch_rating },
+		{ "lazy_evaluation", &lbx::chess::benchmark_lazy_evaluation },
+		{ "mobility", &lbx::chess::benchmark_mobility },
+		{ "parallel_search", &lbx::chess::benchmark_parallel_search },
+	};
+
+	void print_usage()
+	{
+		lbx::println("usage: deeper_blue-bench [options] [benchmarks...]");
+		lbx::println("\t--fen <fen>          position to search, defaults to kiwipete and perft position 3");
+		lbx::println("\t--depth <n>          depth to search to, needed with --fen");
+		lbx::println("\t--max-threads <n>    most threads to search with, doubling from 1, defaults to 32");
+		lbx::println("\t--hash <mb>          transposition table size, defaults to 16");
+		lbx::println("benchmarks, all of them run if none are named:");
+		for (auto& b : benchmarks_v)
+		{
+			lbx::println("\t{}", b.name);
+		};
+	};
+
+	template <typename T>
+	std::optional<T> parse_number(std::string_view _str)
+	{
+		T _value{};
+		const auto _result = std::from_chars(_str.data(), _str.data() + _str.size(), _value);
+		if (_result.ec != std::errc{} || _result.ptr != _str.data() + _str.size())
+		{
+			return std::nullopt;
+		};
+		return _value;
+	};
+
+	const Benchmark* find_benchmark(std::string_view _name)
+	{
+		for (auto& b : benchmarks_v)
+		{
+			if (b.name == _name)
+			{
+				return &b;
+			};
+		};
+		return nullptr;
+	};
+};
+
+int main(int _nargs, char* _vargs[])
+{
+	lbx::chess::BenchOptions _options{};
+	std::vector<const Benchmark*> _selected{};
+
+	for (int n = 1; n < _nargs; ++n)
+	{
+		const std::string_view _arg = _vargs[n];
+		if (_arg == "--help" || _arg == "-h")
+		{
+			print_usage();
+			return 0;
+		};
+
+		if (!_arg.starts_with("--"))
+		{
+			const auto _benchmark = find_benchmark(_arg);
+			if (!_benchmark)
+			{
+				lbx::println("unrecognized benchmark \"{}\"", _arg);
+				print_usage();
+				return -1;
+			};
+			_selected.push_back(_benchmark);
+			continue;
+		};
+
+		if (n + 1 >= _nargs)
+		{
+			lbx::println("missing value for {}", _arg);
+			return -1;
+		};
+		const std::string_view _value = _vargs[++n];
+
+		if (_arg == "--fen")
+		{
+			_options.fen = std::string{ _value };
+		}
+		else if (_arg == "--depth" || _arg == "--max-threads" || _arg == "--hash")
+		{
+			const auto _number = parse_number<size_t>(_value);
+			if (!_number || *_number == 0)
+			{
+				lbx::println("expected a positive number for {}", _arg);
+				return -1;
+			};
+
+			if (_arg == "--depth")
+			{
+				_options.depth = static_cast<int>(*_number);
+			}
+			else if (_arg == "--max-threads")
+			{
+				_options.max_threads = *_number;
+			}
+			else
+			{
+				_options.hash_mb = *_number;
+			};
+		}
+		else
+		{
+			lbx::println("unrecognized option \"{}\"", _arg);
+			print_usage();
+			return -1;
+		};
+	};
+
+	if (_options.fen && !_options.depth)
+	{
+		lbx::println("--fen needs a --depth");
+		return -1;
+	};
+
+	if (_selected.empty())
+	{
+		for (auto& b : benchmarks_v)
+		{
+			_selected.push_back(&b);
+		};
+	};
+
+	bool _passed = true;
+	for (auto b : _selected)
+	{
+		lbx::println("== {} ==", b->name);
+		_passed = b->run(_options) && _passed;
+	};
+	return (_passed) ? 0 : 1;
+};
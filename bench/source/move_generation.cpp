@@ -0,0 +1,129 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+#include <lambdex/chess/move_validation.hpp>
+
+#include <span>
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Positions with castling, en passant, promotions and pins
+		*/
+		constexpr auto generation_positions_v = std::array
+		{
+			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+			"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+			"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+			"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+			"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+			"rnbqkbnr/4p1p1/p1p5/1pPp1p1p/3PP3/1QN5/PP1BNPPP/1R2KB1R w Kkq d6 0 11",
+		};
+
+		/**
+		 * @brief Move generation the old way, attack sets filtered by is_move_valid
+		*/
+		size_t find_moves_by_validation(const BoardWithState& _board, std::span<Move> _buffer)
+		{
+			const auto _occupied = _board.as_bits_with_pieces();
+			size_t _count = 0;
+			for (Position _from{}; _from != Position::end(); ++_from)
+			{
+				const auto _piece = _board.get(_from);
+				if (_piece == Piece::empty || get_color(_piece) != _board.turn)
+				{
+					continue;
+				};
+
+				BitBoard _candidates{};
+				switch (as_white(_piece))
+				{
+				case Piece::pawn:
+					_candidates = pawn_attacks(_board.turn, _from) | bits_in_file(PositionPair{ _from }.file());
+					break;
+				case Piece::knight:
+					_candidates = knight_attacks(_from);
+					break;
+				case Piece::bishop:
+					_candidates = bishop_attacks(_from, _occupied);
+					break;
+				case Piece::rook:
+					_candidates = rook_attacks(_from, _occupied);
+					break;
+				case Piece::queen:
+					_candidates = queen_attacks(_from, _occupied);
+					break;
+				case Piece::king:
+					_candidates = king_attacks(_from) | rook_attacks(_from, _occupied);
+					break;
+				default:
+					break;
+				};
+
+				while (_candidates.any())
+				{
+					const Move _move{ _from, _candidates.pop_first() };
+					if (is_move_valid(_board, _move, _board.turn) == MoveValidity::valid && _count != _buffer.size())
+					{
+						_buffer[_count++] = _move;
+					};
+				};
+			};
+			return _count;
+		};
+	};
+
+	/**
+	 * @brief The legal move generator against filtering attack sets through is_move_valid
+	*/
+	bool benchmark_move_generation(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+
+		std::vector<BoardWithState> _boards{};
+		for (auto& _fen : generation_positions_v)
+		{
+			_boards.push_back(create_board_from_fen(_fen));
+		};
+
+		std::array<Move, 256> _buffer{};
+		const auto time_generator = [&](auto&& _fn)
+		{
+			constexpr int _rounds = 200;
+			size_t _sink = 0;
+			const auto _start = clock::now();
+			for (int n = 0; n != _rounds; ++n)
+			{
+				for (auto& b : _boards)
+				{
+					_sink += _fn(b, _buffer);
+				};
+			};
+			const auto _elapsed = std::chrono::duration<double, std::micro>(clock::now() - _start);
+			consume(_sink);
+			return _elapsed.count() / static_cast<double>(_rounds * _boards.size());
+		};
+
+		const auto _validationUs = time_generator([](const BoardWithState& b, std::span<Move> _out)
+			{
+				return find_moves_by_validation(b, _out);
+			});
+		const auto _legalUs = time_generator([](const BoardWithState& b, std::span<Move> _out)
+			{
+				return find_possible_moves(b, _out);
+			});
+
+		lbx::println("validate each move : {:.2f} us per position", _validationUs);
+		lbx::println("legal generator    : {:.2f} us per position ({:.1f}x)", _legalUs, _validationUs / _legalUs);
+		return true;
+	};
+};
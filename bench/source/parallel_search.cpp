@@ -0,0 +1,101 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/parallel_search.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		using BenchRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_CastleOpportunity, BoardRater_Mobility>;
+
+		/**
+		 * @brief A position to search and the depth to search it to
+		*/
+		struct BenchPosition
+		{
+			std::string fen;
+			int depth;
+		};
+
+		/**
+		 * @brief Positions searched when none is given, kiwipete and perft position 3
+		*/
+		const BenchPosition default_positions_v[] =
+		{
+			{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 5 },
+			{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 9 },
+		};
+
+		/**
+		 * @brief Times a search to a fixed depth with a doubling number of threads
+		 * @return True if every search reached the depth
+		*/
+		bool run_speedup(const BenchPosition& _position, size_t _maxThreads, size_t _hashMB)
+		{
+			using clock = std::chrono::steady_clock;
+
+			// Long enough that the depth is always reached
+			constexpr TimeBudget untimed_v{ std::chrono::hours{ 24 }, std::chrono::hours{ 24 } };
+
+			const auto _board = create_board_from_fen(_position.fen);
+			lbx::println("{} depth {}", _position.fen, _position.depth);
+
+			bool _passed = true;
+			double _single = 0.0;
+			for (size_t _threads = 1; _threads <= _maxThreads; _threads *= 2)
+			{
+				TranspositionTable _table{ _hashMB };
+				ParallelSearcher<BenchRater> _searcher{ _table, _threads };
+
+				const auto _start = clock::now();
+				const auto _result = _searcher.search(_board, _position.depth, untimed_v);
+				const auto _seconds = std::chrono::duration<double>(clock::now() - _start).count();
+				_passed = _passed && _result.best_move && _result.depth == _position.depth;
+
+				if (_threads == 1)
+				{
+					_single = _seconds;
+				};
+				lbx::println("\t{:>2} threads : {:>9.3f}ms speedup {:>5.2f} {:>10} nodes, hit rate {:.1f}%",
+					_threads, _seconds * 1000.0, _single / _seconds, _result.stats.nodes, _result.stats.table.hit_rate() * 100.0);
+			};
+			return _passed;
+		};
+	};
+
+	/**
+	 * @brief Time to depth of the Lazy SMP search with a doubling number of threads
+	 * @return False if a search didn't reach its depth
+	*/
+	bool benchmark_parallel_search(const BenchOptions& _options)
+	{
+		std::vector<BenchPosition> _positions{};
+		if (_options.fen)
+		{
+			_positions.push_back(BenchPosition{ *_options.fen, _options.depth.value_or(5) });
+		}
+		else
+		{
+			for (auto& p : default_positions_v)
+			{
+				_positions.push_back(BenchPosition{ p.fen, _options.depth.value_or(p.depth) });
+			};
+		};
+
+		lbx::println("time to depth with {} hardware threads", std::thread::hardware_concurrency());
+		bool _passed = true;
+		for (auto& p : _positions)
+		{
+			_passed = run_speedup(p, _options.max_threads, _options.hash_mb) && _passed;
+		};
+		return _passed;
+	};
+};
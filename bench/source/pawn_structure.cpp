@@ -0,0 +1,86 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/pawn_structure.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <chrono>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Rates every node of the move tree down to a depth, returns the sum of the ratings
+		*/
+		template <typename RaterT>
+		int64_t rate_tree(BoardWithState& _board, int _depth, const RaterT& _rater, size_t& _nodes)
+		{
+			++_nodes;
+			int64_t _sum = _rater.rate(_board, _board.turn);
+			if (_depth == 0)
+			{
+				return _sum;
+			};
+			for (auto& m : find_possible_moves(_board))
+			{
+				const auto _undo = make_move(_board, m);
+				_sum += rate_tree(_board, _depth - 1, _rater, _nodes);
+				unmake_move(_board, m, _undo);
+			};
+			return _sum;
+		};
+
+		/**
+		 * @brief Rates nothing, walking the tree costs the same for every rater so it is timed alone to be taken out
+		*/
+		struct BoardRater_None
+		{
+			Rating rate(const BoardWithState&, Color) const { return 0; };
+		};
+	};
+
+	/**
+	 * @brief Pawn structure evaluation with and without the pawn hash table
+	*/
+	bool benchmark_pawn_structure(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+
+		auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		constexpr int _depth = 3;
+
+		PawnHashTable _table{};
+		const BoardRater_PawnStructure _cached{ &_table };
+		const BoardRater_PawnStructure _uncached{};
+
+		const auto _time = [&](const auto& _rater)
+		{
+			double _best = 1e9;
+			for (int n = 0; n != 3; ++n)
+			{
+				size_t _nodes = 0;
+				const auto _start = clock::now();
+				consume(rate_tree(_board, _depth, _rater, _nodes));
+				_best = std::min(_best, std::chrono::duration<double>(clock::now() - _start).count() * 1e9 / _nodes);
+			};
+			return _best;
+		};
+
+		const auto _walkNs = _time(BoardRater_None{});
+		const auto _uncachedNs = _time(_uncached) - _walkNs;
+		const auto _cachedNs = _time(_cached) - _walkNs;
+
+		const auto _hits = _table.stats().hits;
+		const auto _lookups = _hits + _table.stats().misses;
+		lbx::println("tree walk     : {:.1f} ns/node", _walkNs);
+		lbx::println("without table : {:.1f} ns/node", _uncachedNs);
+		lbx::println("with table    : {:.1f} ns/node ({:.2f}x), {:.1f}% of {} lookups hit",
+			_cachedNs, _uncachedNs / _cachedNs, 100.0 * _hits / _lookups, _lookups);
+		return true;
+	};
+};
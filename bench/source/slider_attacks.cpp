@@ -0,0 +1,126 @@
+#include "bench.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/move_validation.hpp>
+#include <lambdex/chess/board/piece_board.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief A board with some random squares filled in along with its occupancy bits
+		*/
+		struct RandomOccupancy
+		{
+			PieceBoard board{};
+			BitBoard bits{};
+		};
+
+		std::vector<RandomOccupancy> make_random_occupancies(size_t _count)
+		{
+			// Fixed seed so runs can be compared
+			std::mt19937_64 _rng{ 0x5EED };
+			std::vector<RandomOccupancy> _out(_count);
+			for (auto& o : _out)
+			{
+				// Mix of sparse and crowded boards
+				auto _bits = _rng() & _rng();
+				if (_rng() & 1)
+				{
+					_bits &= _rng();
+				};
+				o.bits = BitBoard{ _bits };
+				for (Position p{}; p != Position::end(); ++p)
+				{
+					if (o.bits.at(p))
+					{
+						o.board[p] = Piece::pawn_white;
+					};
+				};
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Finds the squares a slider attacks the way move generation used to, by
+		 * classifying every square and scanning the path to it.
+		*/
+		BitBoard path_scan_attacks(const PieceBoard& _board, Position _from, bool _orthogonal, bool _diagonal)
+		{
+			BitBoard _out{};
+			for (Position _to{}; _to != Position::end(); ++_to)
+			{
+				if (_to == _from)
+				{
+					continue;
+				};
+
+				const auto _class = classify_movement(_from, _to);
+				const bool _slides =
+					(_class == MovementClass::diagonal && _diagonal) ||
+					((_class == MovementClass::file || _class == MovementClass::rank) && _orthogonal);
+				if (_slides && !find_piece_in_path(_board, _from, _to, _class))
+				{
+					_out.set(_to);
+				};
+			};
+			return _out;
+		};
+	};
+
+	/**
+	 * @brief Slider attack lookups against scanning the path to every square
+	*/
+	bool benchmark_slider_attacks(const BenchOptions&)
+	{
+		using clock = std::chrono::steady_clock;
+		const auto _occupancies = make_random_occupancies(2000);
+
+		const auto time_queen_attacks = [&](auto&& _fn)
+		{
+			BitBoard::binary_type _sink = 0;
+			const auto _start = clock::now();
+			for (auto& o : _occupancies)
+			{
+				for (Position p{}; p != Position::end(); ++p)
+				{
+					_sink ^= _fn(o, p).bits();
+				};
+			};
+			const auto _elapsed = std::chrono::duration<double, std::nano>(clock::now() - _start);
+			consume(_sink);
+			return _elapsed.count() / static_cast<double>(_occupancies.size() * 64);
+		};
+
+		const auto _pathScanNs = time_queen_attacks([](const RandomOccupancy& o, Position p)
+			{
+				return path_scan_attacks(o.board, p, true, true);
+			});
+		lbx::println("path scan : {:.2f} ns per queen", _pathScanNs);
+
+		const auto _defaultBackend = get_slider_attack_backend();
+		for (auto _backend : { SliderAttackBackend::magic, SliderAttackBackend::pext })
+		{
+			if (!set_slider_attack_backend(_backend))
+			{
+				lbx::println("{} : not supported on this CPU", (_backend == SliderAttackBackend::magic) ? "magic    " : "pext     ");
+				continue;
+			};
+			const auto _ns = time_queen_attacks([](const RandomOccupancy& o, Position p)
+				{
+					return queen_attacks(p, o.bits);
+				});
+			lbx::println("{} : {:.2f} ns per queen ({:.1f}x)",
+				(_backend == SliderAttackBackend::magic) ? "magic    " : "pext     ", _ns, _pathScanNs / _ns);
+		};
+		set_slider_attack_backend(_defaultBackend);
+		return true;
+	};
+};
@@ -9,6 +9,81 @@
 
 namespace lbx::chess
 {
+	/**
+	 * @brief The state lost when a move is made, enough to revert the move with unmake_move()
+	*/
+	struct UndoInfo
+	{
+		/**
+		 * @brief Zobrist key of the board before the move
+		*/
+		ZobristKey key = 0;
+
+		/**
+		 * @brief Half move counter before the move
+		*/
+		uint16_t half_move_counter = 0;
+
+		/**
+		 * @brief Piece that was captured, Piece::empty if nothing was
+		*/
+		Piece captured = Piece::empty;
+
+		/**
+		 * @brief Kind of move that was made, as worked out by pack_move()
+		*/
+		MoveKind kind = MoveKind::quiet;
+
+		/**
+		 * @brief En passant square before the move, Position::end() if there wasn't one
+		*/
+		Position en_passant = Position::end();
+
+		/**
+		 * @brief Castling flags before the move, see BoardWithState::get_castle_flags()
+		*/
+		uint8_t castle_flags = 0;
+	};
+
+	/**
+	 * @brief Works out the kind of a move from the board it is about to be made on
+	 * @param _board Board the move will be made on
+	 * @param _move Move to pack, a pawn reaching the back rank without a promotion piece promotes to a queen
+	 * @return Packed move
+	*/
+	PackedMove pack_move(const BoardWithState& _board, const Move& _move);
+
+	/**
+	 * @brief Applies a move to a chess board without checking for validity
+	 * @param _board Board to apply move on
+	 * @param _move Move to apply, must have been packed by pack_move() for this board
+	 * @return Information needed to undo the move with unmake_move()
+	*/
+	UndoInfo make_move(BoardWithState& _board, PackedMove _move);
+
+	/**
+	 * @brief Applies a move to a chess board without checking for validity
+	 * @param _board Board to apply move on
+	 * @param _move Move to apply, must be made by the player whose turn it is
+	 * @return Information needed to undo the move with unmake_move()
+	*/
+	inline UndoInfo make_move(BoardWithState& _board, const Move& _move)
+	{
+		return make_move(_board, pack_move(_board, _move));
+	};
+
+	/**
+	 * @brief Reverts a move applied by make_move().
+	 *
+	 * Moves must be unmade in the reverse order they were made, this lets search
+	 * walk a single board instead of copying it for every node.
+	 *
+	 * @param _board Board the move was applied to, must not have been changed since
+	 * @param _move The move that was made
+	 * @param _undo Value returned by make_move()
+	*/
+	void unmake_move(BoardWithState& _board, const Move& _move, const UndoInfo& _undo);
+
 	/**
 	 * @brief Applies a move to a chess board without checking for validity
 	 * @param _board Board to apply move on
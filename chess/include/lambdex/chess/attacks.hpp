@@ -0,0 +1,319 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_ATTACKS_HPP
+#define LAMBDEX_CHESS_ATTACKS_HPP
+
+/*
+	Provides lookup tables for the squares attacked by each kind of piece.
+
+	The slider and line tables are built once at program startup, so do not call
+	these from other static initializers.
+*/
+
+#include "position.hpp"
+#include "piece_movement.hpp"
+#include "board/bit_board.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Ways of turning a (square, occupancy) pair into an index into the slider attack tables
+	*/
+	enum class SliderAttackBackend : uint8_t
+	{
+		/**
+		 * @brief Multiplies the relevant occupancy by a magic number and shifts, works everywhere
+		*/
+		magic,
+
+		/**
+		 * @brief Gathers the relevant occupancy bits with the BMI2 PEXT instruction
+		*/
+		pext,
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Lookup information for the attacks of a slider on a single square
+		*/
+		struct SliderAttackEntry
+		{
+			/**
+			 * @brief Squares whose occupancy can change the attack set, excludes the board edges
+			*/
+			BitBoard::binary_type mask;
+
+			/**
+			 * @brief Magic multiplier for the magic backend
+			*/
+			BitBoard::binary_type magic;
+
+			/**
+			 * @brief Attack sets indexed using the magic backend
+			*/
+			const BitBoard* magic_attacks;
+
+			/**
+			 * @brief Attack sets indexed using the PEXT backend
+			*/
+			const BitBoard* pext_attacks;
+
+			/**
+			 * @brief Right shift applied after the magic multiply
+			*/
+			uint8_t shift;
+		};
+
+		extern std::array<SliderAttackEntry, 64> rook_attack_entries;
+		extern std::array<SliderAttackEntry, 64> bishop_attack_entries;
+
+		/**
+		 * @brief The backend currently used by the lookups
+		*/
+		extern SliderAttackBackend slider_attack_backend;
+
+		/**
+		 * @brief Extracts the bits of a value selected by a mask using PEXT.
+		 *
+		 * Only call this if the pext backend is supported.
+		*/
+		uint64_t pext_index(uint64_t _value, uint64_t _mask) noexcept;
+
+		inline BitBoard lookup_slider_attacks(const SliderAttackEntry& _entry, BitBoard _occupancy) noexcept
+		{
+			if (slider_attack_backend == SliderAttackBackend::pext)
+			{
+				return _entry.pext_attacks[pext_index(_occupancy.bits(), _entry.mask)];
+			}
+			else
+			{
+				return _entry.magic_attacks[((_occupancy.bits() & _entry.mask) * _entry.magic) >> _entry.shift];
+			};
+		};
+	};
+
+	namespace impl
+	{
+		consteval std::array<BitBoard, 64> make_knight_attack_table()
+		{
+			std::array<BitBoard, 64> _out{};
+			for (Position p{}; p != Position::end(); ++p)
+			{
+				_out[p.get()] = get_knight_movement_bits(p);
+			};
+			return _out;
+		};
+		consteval std::array<BitBoard, 64> make_king_attack_table()
+		{
+			std::array<BitBoard, 64> _out{};
+			for (Position p{}; p != Position::end(); ++p)
+			{
+				_out[p.get()] = get_king_movement_bits(p);
+			};
+			return _out;
+		};
+		consteval std::array<BitBoard, 64> make_pawn_attack_table(Color _color)
+		{
+			std::array<BitBoard, 64> _out{};
+			const int _forward = (_color == Color::white) ? 1 : -1;
+			for (Position p{}; p != Position::end(); ++p)
+			{
+				const PositionPair _pair{ p };
+				const auto _rank = static_cast<int>(_pair.rank()) + _forward;
+				const auto _file = static_cast<int>(_pair.file());
+				if (_rank < 0 || _rank > 7)
+				{
+					continue;
+				};
+				if (_file != 0)
+				{
+					_out[p.get()].set(((Rank)_rank, (File)(_file - 1)));
+				};
+				if (_file != 7)
+				{
+					_out[p.get()].set(((Rank)_rank, (File)(_file + 1)));
+				};
+			};
+			return _out;
+		};
+
+		constexpr inline auto knight_attack_table = make_knight_attack_table();
+		constexpr inline auto king_attack_table = make_king_attack_table();
+		constexpr inline std::array<std::array<BitBoard, 64>, 2> pawn_attack_table
+		{
+			make_pawn_attack_table(Color::white),
+			make_pawn_attack_table(Color::black)
+		};
+
+		extern std::array<std::array<BitBoard, 64>, 64> between_table;
+		extern std::array<std::array<BitBoard, 64>, 64> line_table;
+	};
+
+	/**
+	 * @brief Gets the squares a knight attacks
+	 * @param _square Square the knight is on
+	 * @return Attacked squares
+	*/
+	constexpr inline BitBoard knight_attacks(Position _square) noexcept
+	{
+		return impl::knight_attack_table[_square.get()];
+	};
+
+	/**
+	 * @brief Gets the squares a king attacks, castling isn't included
+	 * @param _square Square the king is on
+	 * @return Attacked squares
+	*/
+	constexpr inline BitBoard king_attacks(Position _square) noexcept
+	{
+		return impl::king_attack_table[_square.get()];
+	};
+
+	/**
+	 * @brief Gets the squares a pawn attacks diagonally
+	 * @param _color Color of the pawn
+	 * @param _square Square the pawn is on
+	 * @return Attacked squares
+	*/
+	constexpr inline BitBoard pawn_attacks(Color _color, Position _square) noexcept
+	{
+		return impl::pawn_attack_table[jc::to_underlying(_color)][_square.get()];
+	};
+
+	static_assert(knight_attacks((File::a, Rank::r1)) == BitBoard{ 0x0000000000020400 });
+	static_assert(king_attacks((File::e, Rank::r1)) == BitBoard{ 0x0000000000003828 });
+	static_assert(pawn_attacks(Color::white, (File::a, Rank::r2)) == BitBoard{ 0x0000000000020000 });
+	static_assert(pawn_attacks(Color::black, (File::b, Rank::r7)) == BitBoard{ 0x0000050000000000 });
+
+	/**
+	 * @brief Gets the squares strictly between two squares on the same rank, file or diagonal
+	 * @param _from First square
+	 * @param _to Second square
+	 * @return Squares between, empty if the squares don't share a line
+	*/
+	inline BitBoard between_squares(Position _from, Position _to) noexcept
+	{
+		return impl::between_table[_from.get()][_to.get()];
+	};
+
+	/**
+	 * @brief Gets the full rank, file or diagonal running through two squares
+	 * @param _from First square
+	 * @param _to Second square
+	 * @return Squares on the line edge to edge, empty if the squares don't share a line
+	*/
+	inline BitBoard line_through(Position _from, Position _to) noexcept
+	{
+		return impl::line_table[_from.get()][_to.get()];
+	};
+
+	/**
+	 * @brief Gets the squares a rook attacks.
+	 *
+	 * The first piece in each direction is included, regardless of its color.
+	 *
+	 * @param _square Square the rook is on
+	 * @param _occupancy Squares holding pieces
+	 * @return Attacked squares
+	*/
+	inline BitBoard rook_attacks(Position _square, BitBoard _occupancy) noexcept
+	{
+		JCLIB_ASSERT(_square < Position::end());
+		return impl::lookup_slider_attacks(impl::rook_attack_entries[_square.get()], _occupancy);
+	};
+
+	/**
+	 * @brief Gets the squares a bishop attacks.
+	 *
+	 * The first piece in each direction is included, regardless of its color.
+	 *
+	 * @param _square Square the bishop is on
+	 * @param _occupancy Squares holding pieces
+	 * @return Attacked squares
+	*/
+	inline BitBoard bishop_attacks(Position _square, BitBoard _occupancy) noexcept
+	{
+		JCLIB_ASSERT(_square < Position::end());
+		return impl::lookup_slider_attacks(impl::bishop_attack_entries[_square.get()], _occupancy);
+	};
+
+	/**
+	 * @brief Gets the squares a queen attacks.
+	 *
+	 * The first piece in each direction is included, regardless of its color.
+	 *
+	 * @param _square Square the queen is on
+	 * @param _occupancy Squares holding pieces
+	 * @return Attacked squares
+	*/
+	inline BitBoard queen_attacks(Position _square, BitBoard _occupancy) noexcept
+	{
+		return rook_attacks(_square, _occupancy) | bishop_attacks(_square, _occupancy);
+	};
+
+	/**
+	 * @brief Finds the pieces of a player attacking a square.
+	 *
+	 * Works outward from the square: the knight, king and pawn patterns and the slider
+	 * rays from the square are masked with the attacker's pieces of that kind.
+	 *
+	 * @param _board Board to look at
+	 * @param _square Square being attacked, may be empty
+	 * @param _attacker Player doing the attacking
+	 * @param _occupied Squares that block sliders, lets callers lift pieces off the board
+	 * @return Squares holding attacking pieces
+	*/
+	inline BitBoard square_attacked_by(const BoardWithState& _board, Position _square, Color _attacker, BitBoard _occupied) noexcept
+	{
+		return
+			(pawn_attacks(!_attacker, _square) & _board.as_bits_with_pieces(Piece::pawn | _attacker)) |
+			(knight_attacks(_square) & _board.as_bits_with_pieces(Piece::knight | _attacker)) |
+			(king_attacks(_square) & _board.as_bits_with_pieces(Piece::king | _attacker)) |
+			(bishop_attacks(_square, _occupied) & _board.diagonal_sliders(_attacker)) |
+			(rook_attacks(_square, _occupied) & _board.orthogonal_sliders(_attacker));
+	};
+
+	/**
+	 * @brief Finds the pieces of a player attacking a square
+	 * @param _board Board to look at
+	 * @param _square Square being attacked, may be empty
+	 * @param _attacker Player doing the attacking
+	 * @return Squares holding attacking pieces
+	*/
+	inline BitBoard square_attacked_by(const BoardWithState& _board, Position _square, Color _attacker) noexcept
+	{
+		return square_attacked_by(_board, _square, _attacker, _board.as_bits_with_pieces());
+	};
+
+	/**
+	 * @brief Checks if the running CPU supports a slider attack backend
+	 * @param _backend Backend to check
+	 * @return True if supported, false otherwise
+	*/
+	bool is_slider_attack_backend_supported(SliderAttackBackend _backend) noexcept;
+
+	/**
+	 * @brief Gets the backend used for slider attack lookups.
+	 *
+	 * This defaults to pext when supported and magic otherwise.
+	 *
+	 * @return Backend in use
+	*/
+	SliderAttackBackend get_slider_attack_backend() noexcept;
+
+	/**
+	 * @brief Sets the backend used for slider attack lookups, this is not thread safe.
+	 *
+	 * Some CPUs implement PEXT in microcode, on those the magic backend is faster.
+	 *
+	 * @param _backend Backend to use
+	 * @return True if the backend was set, false if it isn't supported
+	*/
+	bool set_slider_attack_backend(SliderAttackBackend _backend) noexcept;
+
+};
+
+#endif // LAMBDEX_CHESS_ATTACKS_HPP
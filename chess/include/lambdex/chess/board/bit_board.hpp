@@ -10,6 +10,7 @@
 #include "lambdex/chess/basic.hpp"
 #include "lambdex/chess/position.hpp"
 
+#include <bit>
 #include <span>
 #include <array>
 #include <ranges>
@@ -210,6 +211,42 @@ namespace lbx::chess
 			return this->bits() == 0;
 		};
 
+		/**
+		 * @brief Gets the number of bits set to "true"
+		 * @return Number of set bits
+		*/
+		constexpr size_type count() const noexcept
+		{
+			return static_cast<size_type>(std::popcount(this->bits()));
+		};
+
+		/**
+		 * @brief Gets the lowest square whose bit is set to "true"
+		 * 
+		 * any() MUST RETURN TRUE
+		 * 
+		 * @return Position of the lowest set bit
+		*/
+		constexpr Position first() const noexcept
+		{
+			JCLIB_ASSERT(this->any());
+			return Position{ static_cast<Position::value_type>(std::countr_zero(this->bits())) };
+		};
+
+		/**
+		 * @brief Resets the lowest set bit and returns its position
+		 * 
+		 * any() MUST RETURN TRUE
+		 * 
+		 * @return Position of the bit that was reset
+		*/
+		constexpr Position pop_first() noexcept
+		{
+			const auto _out = this->first();
+			this->bits_ &= this->bits_ - 1;
+			return _out;
+		};
+
 
 
 #pragma region OPERATOR_OVERLOADS
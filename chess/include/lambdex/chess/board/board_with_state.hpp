@@ -4,23 +4,358 @@
 
 #include "piece_board.hpp"
 #include "bit_board.hpp"
+#include "zobrist.hpp"
+#include "piece_square.hpp"
 
 #include <jclib/config.h>
 
 #include <array>
+#include <algorithm>
 #include <iosfwd>
 #include <string>
 #include <optional>
+#include <cstdint>
+
+/**
+ * @brief Set to 1 to check incrementally updated board state (like the Zobrist key or material)
+ * against a full recalculation after every move, defaults to on in debug builds.
+*/
+#ifndef LAMBDEX_CHESS_VERIFY_INCREMENTAL
+	#ifdef NDEBUG
+		#define LAMBDEX_CHESS_VERIFY_INCREMENTAL 0
+	#else
+		#define LAMBDEX_CHESS_VERIFY_INCREMENTAL 1
+	#endif
+#endif
 
 namespace lbx::chess
 {
+	/**
+	 * @brief Count of each piece on a board packed 4 bits per piece, see BoardWithState::material_key()
+	*/
+	using MaterialKey = uint64_t;
+
 	/**
 	 * @brief Describes a board of pieces with game state
+	 * 
+	 * Alongside the piece array this keeps a bit board for each of the 12 pieces and
+	 * for each player's occupancy. These are kept in sync by routing all piece changes
+	 * through place_piece(), remove_piece() and move_piece() (or the SquareReference
+	 * returned by the mutable element accessors).
+	 * 
+	 * The same functions keep a Zobrist key of the pieces up to date, see zobrist_key() and
+	 * pawn_key(), along
+	 * with each player's material and piece-square totals and the game phase, see get_piece_values(),
+	 * and the count of each piece, see material_key().
 	*/
 	class BoardWithState : public PieceBoard
 	{
+	private:
+
+		/**
+		 * @brief Gets the index into the per-piece bit board array for a piece
+		 * 
+		 * Piece values run from 0b0010 (white pawn) to 0b1011 (black queen) with the
+		 * kings being 0b1110 and 0b1111, so kings are shifted down to sit right after
+		 * the queens.
+		 * 
+		 * @param _piece Piece to get index for, MUST NOT BE EMPTY
+		 * @return Index into piece_bits_
+		*/
+		constexpr static size_t piece_bits_index(Piece _piece) noexcept
+		{
+			JCLIB_ASSERT(_piece != Piece::empty);
+			const auto _value = jc::to_underlying(_piece);
+			return _value - 2 - (((_value >> 2) & (_value >> 3) & 0b1) * 2);
+		};
+
+		/**
+		 * @brief Gets the Zobrist key for a piece on a square
+		 * @param _piece Piece, MUST NOT BE EMPTY
+		 * @param _pos Square the piece is on
+		 * @return Zobrist key
+		*/
+		constexpr static ZobristKey piece_key(Piece _piece, Position _pos) noexcept
+		{
+			return zobrist_keys.pieces[piece_bits_index(_piece)][_pos.get()];
+		};
+
+		/**
+		 * @brief Gets the pawn key part for a piece on a square, 0 for anything but pawns
+		 * @param _piece Piece, MUST NOT BE EMPTY
+		 * @param _pos Square the piece is on
+		 * @return Zobrist key
+		*/
+		constexpr static ZobristKey pawn_piece_key(Piece _piece, Position _pos) noexcept
+		{
+			return (as_white(_piece) == Piece::pawn) ? piece_key(_piece, _pos) : 0;
+		};
+
+		/**
+		 * @brief Adds or removes a piece's value from the running totals
+		 * @param _piece Piece, MUST NOT BE EMPTY
+		 * @param _pos Square the piece is on
+		 * @param _sign 1 to add the piece, -1 to remove it
+		*/
+		constexpr void update_piece_values(Piece _piece, Position _pos, int _sign) noexcept
+		{
+			const auto _index = piece_bits_index(_piece);
+			const auto _color = jc::to_underlying(get_color(_piece));
+			this->values_.material[_color] += _sign * piece_square_values.material[_index];
+			this->values_.midgame[_color] += _sign * piece_square_values.midgame[_index][_pos.get()];
+			this->values_.endgame[_color] += _sign * piece_square_values.endgame[_index][_pos.get()];
+			this->values_.phase += _sign * piece_square_values.phase[_index];
+		};
+
 	public:
 
+		/**
+		 * @brief Reference to a single square of the board that keeps the bit boards in sync on assignment
+		*/
+		class SquareReference
+		{
+		public:
+
+			constexpr operator Piece() const noexcept
+			{
+				return this->board_->get(this->pos_);
+			};
+
+			constexpr SquareReference& operator=(Piece _piece) noexcept
+			{
+				this->board_->set_piece(this->pos_, _piece);
+				return *this;
+			};
+			constexpr SquareReference& operator=(const SquareReference& _other) noexcept
+			{
+				return (*this) = static_cast<Piece>(_other);
+			};
+
+			constexpr SquareReference(BoardWithState& _board, Position _pos) noexcept :
+				board_{ &_board }, pos_{ _pos }
+			{};
+
+		private:
+			BoardWithState* board_;
+			Position pos_;
+		};
+
+		/**
+		 * @brief Gets the piece at a given board position
+		 * @param _pos Position to get piece from
+		 * @return Piece at position
+		*/
+		constexpr Piece get(Position _pos) const noexcept
+		{
+			return PieceBoard::at(_pos);
+		};
+
+		// Element access, mutable versions return a SquareReference so writes keep the bit boards in sync
+
+		using PieceBoard::at;
+		using PieceBoard::operator[];
+
+		constexpr SquareReference at(Position _pos) noexcept
+		{
+			JCLIB_ASSERT(_pos < Position::end());
+			return SquareReference{ *this, _pos };
+		};
+		constexpr SquareReference at(size_type _pos) noexcept
+		{
+			return this->at(Position{ _pos });
+		};
+		constexpr SquareReference operator[](Position _pos) noexcept
+		{
+			return this->at(_pos);
+		};
+		constexpr SquareReference operator[](size_type _pos) noexcept
+		{
+			return this->at(_pos);
+		};
+
+		// Only allow read-only iteration as writes through iterators would skip the bit boards
+
+		constexpr const_iterator begin() const noexcept
+		{
+			return PieceBoard::begin();
+		};
+		constexpr const_iterator end() const noexcept
+		{
+			return PieceBoard::end();
+		};
+		constexpr const_pointer data() const noexcept
+		{
+			return PieceBoard::data();
+		};
+
+		/**
+		 * @brief Sets the piece on a square, replacing whatever was there
+		 * @param _pos Square to set
+		 * @param _piece Piece to place, may be Piece::empty to clear the square
+		*/
+		constexpr void set_piece(Position _pos, Piece _piece) noexcept
+		{
+			if (this->get(_pos) != Piece::empty)
+			{
+				this->remove_piece(_pos);
+			};
+			if (_piece != Piece::empty)
+			{
+				this->place_piece(_pos, _piece);
+			};
+		};
+
+		/**
+		 * @brief Places a piece onto an empty square
+		 * @param _pos Square to place on, MUST BE EMPTY
+		 * @param _piece Piece to place, MUST NOT BE EMPTY
+		*/
+		constexpr void place_piece(Position _pos, Piece _piece) noexcept
+		{
+			JCLIB_ASSERT(this->get(_pos) == Piece::empty);
+			PieceBoard::at(_pos) = _piece;
+			this->piece_bits_[piece_bits_index(_piece)].set(_pos);
+			this->color_bits_[jc::to_underlying(get_color(_piece))].set(_pos);
+			this->key_ ^= piece_key(_piece, _pos);
+			this->pawn_key_ ^= pawn_piece_key(_piece, _pos);
+			this->material_key_ += material_key_unit(_piece);
+			this->update_piece_values(_piece, _pos, 1);
+		};
+
+		/**
+		 * @brief Removes the piece from a square
+		 * @param _pos Square to clear, MUST NOT BE EMPTY
+		 * @return The piece that was removed
+		*/
+		constexpr Piece remove_piece(Position _pos) noexcept
+		{
+			const auto _piece = this->get(_pos);
+			JCLIB_ASSERT(_piece != Piece::empty);
+			PieceBoard::at(_pos) = Piece::empty;
+			this->piece_bits_[piece_bits_index(_piece)].reset(_pos);
+			this->color_bits_[jc::to_underlying(get_color(_piece))].reset(_pos);
+			this->key_ ^= piece_key(_piece, _pos);
+			this->pawn_key_ ^= pawn_piece_key(_piece, _pos);
+			this->material_key_ -= material_key_unit(_piece);
+			this->update_piece_values(_piece, _pos, -1);
+			return _piece;
+		};
+
+		/**
+		 * @brief Moves a piece onto an empty square
+		 * @param _from Square the piece is on, MUST NOT BE EMPTY
+		 * @param _to Square to move to, MUST BE EMPTY
+		*/
+		constexpr void move_piece(Position _from, Position _to) noexcept
+		{
+			const auto _piece = this->get(_from);
+			JCLIB_ASSERT(_piece != Piece::empty);
+			JCLIB_ASSERT(this->get(_to) == Piece::empty);
+
+			PieceBoard::at(_to) = _piece;
+			PieceBoard::at(_from) = Piece::empty;
+
+			const auto _bits = BitBoard{ (BitBoard::binary_type{ 1 } << _from.get()) | (BitBoard::binary_type{ 1 } << _to.get()) };
+			this->piece_bits_[piece_bits_index(_piece)] ^= _bits;
+			this->color_bits_[jc::to_underlying(get_color(_piece))] ^= _bits;
+			this->key_ ^= piece_key(_piece, _from) ^ piece_key(_piece, _to);
+			this->pawn_key_ ^= pawn_piece_key(_piece, _from) ^ pawn_piece_key(_piece, _to);
+
+			const auto _index = piece_bits_index(_piece);
+			const auto _color = jc::to_underlying(get_color(_piece));
+			const auto& _midgame = piece_square_values.midgame[_index];
+			const auto& _endgame = piece_square_values.endgame[_index];
+			this->values_.midgame[_color] += _midgame[_to.get()] - _midgame[_from.get()];
+			this->values_.endgame[_color] += _endgame[_to.get()] - _endgame[_from.get()];
+		};
+
+		/**
+		 * @brief Makes a bit board with each square set to true if a piece is present
+		 * @return Bit board
+		*/
+		constexpr BitBoard as_bits_with_pieces() const noexcept
+		{
+			return this->color_bits_[0] | this->color_bits_[1];
+		};
+
+		/**
+		 * @brief Makes a bit board with each square set to true if a piece of the player is present
+		 * @param _player Player to get pieces of
+		 * @return Bit board
+		*/
+		constexpr BitBoard as_bits_with_pieces(Color _player) const noexcept
+		{
+			return this->color_bits_[jc::to_underlying(_player)];
+		};
+
+		/**
+		 * @brief Makes a bit board with each square set to true if the given piece is present
+		 * @param _piece Piece to get squares of, MUST NOT BE EMPTY
+		 * @return Bit board
+		*/
+		constexpr BitBoard as_bits_with_pieces(Piece _piece) const noexcept
+		{
+			return this->piece_bits_[piece_bits_index(_piece)];
+		};
+
+		/**
+		 * @brief Gets the squares holding a player's bishops and queens
+		 * @param _player Player to get pieces of
+		 * @return Bit board
+		*/
+		constexpr BitBoard diagonal_sliders(Color _player) const noexcept
+		{
+			return this->as_bits_with_pieces(Piece::bishop | _player) | this->as_bits_with_pieces(Piece::queen | _player);
+		};
+
+		/**
+		 * @brief Gets the squares holding a player's rooks and queens
+		 * @param _player Player to get pieces of
+		 * @return Bit board
+		*/
+		constexpr BitBoard orthogonal_sliders(Color _player) const noexcept
+		{
+			return this->as_bits_with_pieces(Piece::rook | _player) | this->as_bits_with_pieces(Piece::queen | _player);
+		};
+
+		/**
+		 * @brief Finds the first square holding a piece
+		 * @param _piece Piece to look for
+		 * @return Position of the piece, or nullopt if it isn't on the board
+		*/
+		constexpr std::optional<PositionPair> find(Piece _piece) const noexcept
+		{
+			const auto _bits = this->as_bits_with_pieces(_piece);
+			if (_bits.any())
+			{
+				return _bits.first();
+			}
+			else
+			{
+				return std::nullopt;
+			};
+		};
+
+		/**
+		 * @brief Gets the number of pieces on the board
+		 * @return Number of non-empty squares
+		*/
+		constexpr size_t count_pieces() const noexcept
+		{
+			return this->as_bits_with_pieces().count();
+		};
+
+		/**
+		 * @brief Gets the number of a given piece on the board
+		 * @param _piece Piece to count, MUST NOT BE EMPTY
+		 * @return Number of squares holding the piece
+		*/
+		constexpr size_t count_pieces(Piece _piece) const noexcept
+		{
+			return this->as_bits_with_pieces(_piece).count();
+		};
+
+
 		/**
 		 * @brief Checks if an en passant is possible
 		 * @return True if possible false otherwise
@@ -52,7 +387,9 @@ namespace lbx::chess
 		*/
 		constexpr void set_en_passant(Position _pos)
 		{
+			this->clear_en_passant();
 			this->en_passant_ = _pos;
+			this->key_ ^= en_passant_key(_pos);
 		};
 
 		/**
@@ -60,7 +397,11 @@ namespace lbx::chess
 		*/
 		constexpr void clear_en_passant()
 		{
-			this->en_passant_ = Position::end();
+			if (this->has_en_passant())
+			{
+				this->key_ ^= en_passant_key(this->en_passant_);
+				this->en_passant_ = Position::end();
+			};
 		};
 
 		/**
@@ -118,6 +459,192 @@ namespace lbx::chess
 
 
 
+		/**
+		 * @brief Gets the four castling flags packed into the low bits of a byte.
+		 * 
+		 * Bits are (white kingside, white queenside, black kingside, black queenside) from
+		 * lowest to highest.
+		 * 
+		 * @return Packed castling flags
+		*/
+		constexpr uint8_t get_castle_flags() const noexcept
+		{
+			return static_cast<uint8_t>(
+				(static_cast<uint8_t>(this->white_can_castle_kingside) << 0) |
+				(static_cast<uint8_t>(this->white_can_castle_queenside) << 1) |
+				(static_cast<uint8_t>(this->black_can_castle_kingside) << 2) |
+				(static_cast<uint8_t>(this->black_can_castle_queenside) << 3));
+		};
+
+		/**
+		 * @brief Sets all four castling flags from a value returned by get_castle_flags()
+		 * @param _flags Packed castling flags
+		*/
+		constexpr void set_castle_flags(uint8_t _flags) noexcept
+		{
+			this->white_can_castle_kingside = (_flags >> 0) & 1;
+			this->white_can_castle_queenside = (_flags >> 1) & 1;
+			this->black_can_castle_kingside = (_flags >> 2) & 1;
+			this->black_can_castle_queenside = (_flags >> 3) & 1;
+		};
+
+		/**
+		 * @brief Gets the Zobrist key identifying this position.
+		 * 
+		 * Covers the pieces, side to move, castling flags and en passant file. The piece
+		 * and en passant parts are kept up to date as the board changes, the turn and
+		 * castling flags are public so they are folded in here with a couple of XORs.
+		 * 
+		 * @return Zobrist key
+		*/
+		constexpr ZobristKey zobrist_key() const noexcept
+		{
+			auto _key = this->key_ ^ zobrist_keys.castling[this->get_castle_flags()];
+			if (this->turn == Color::black)
+			{
+				_key ^= zobrist_keys.black_to_move;
+			};
+			return _key;
+		};
+
+		/**
+		 * @brief Gets the Zobrist key of just the pawns.
+		 * 
+		 * Pawn structure changes far less often than the rest of the position, so this is
+		 * used to cache pawn evaluation.
+		 * 
+		 * @return Zobrist key
+		*/
+		constexpr ZobristKey pawn_key() const noexcept
+		{
+			return this->pawn_key_;
+		};
+
+		/**
+		 * @brief Gets the amount of one piece that makes up a material key.
+		 * 
+		 * A material key holds the count of each piece other than the kings in 4 bits, so the
+		 * key of a set of pieces is the sum of their units. Kings are always there and add 0.
+		 * 
+		 * @param _piece Piece, MUST NOT BE EMPTY
+		 * @return Material key of just that piece
+		*/
+		constexpr static MaterialKey material_key_unit(Piece _piece) noexcept
+		{
+			const auto _index = piece_bits_index(_piece);
+			return (_index < 10) ? (MaterialKey{ 1 } << (_index * 4)) : 0;
+		};
+
+		/**
+		 * @brief Gets the material key, the count of each piece on the board.
+		 * 
+		 * Two boards have the same key exactly when they have the same pieces, which makes it
+		 * a cheap way to match material signatures like KRK, see material_key_unit().
+		 * 
+		 * @return Material key
+		*/
+		constexpr MaterialKey material_key() const noexcept
+		{
+			return this->material_key_;
+		};
+
+		/**
+		 * @brief Recalculates the material key from scratch, used to check the incremental one
+		 * @return Material key
+		*/
+		constexpr MaterialKey compute_material_key() const noexcept
+		{
+			return BoardWithState{ static_cast<const PieceBoard&>(*this) }.material_key();
+		};
+
+		/**
+		 * @brief Recalculates the pawn key from scratch, used to check the incremental one
+		 * @return Zobrist key
+		*/
+		constexpr ZobristKey compute_pawn_key() const noexcept
+		{
+			return BoardWithState{ static_cast<const PieceBoard&>(*this) }.pawn_key();
+		};
+
+		/**
+		 * @brief Recalculates the Zobrist key from scratch, used to check the incremental one
+		 * @return Zobrist key
+		*/
+		constexpr ZobristKey compute_zobrist_key() const noexcept
+		{
+			BoardWithState _fresh{ static_cast<const PieceBoard&>(*this) };
+			_fresh.black_can_castle_kingside = this->black_can_castle_kingside;
+			_fresh.black_can_castle_queenside = this->black_can_castle_queenside;
+			_fresh.white_can_castle_kingside = this->white_can_castle_kingside;
+			_fresh.white_can_castle_queenside = this->white_can_castle_queenside;
+			_fresh.turn = this->turn;
+			if (this->has_en_passant())
+			{
+				_fresh.set_en_passant(this->get_en_passant());
+			};
+			return _fresh.zobrist_key();
+		};
+
+		/**
+		 * @brief Gets the running material, piece-square and game phase totals for the board
+		 * @return Piece value totals
+		*/
+		constexpr const PieceValueTotals& get_piece_values() const noexcept
+		{
+			return this->values_;
+		};
+
+		/**
+		 * @brief Recalculates the piece value totals from scratch, used to check the incremental ones
+		 * @return Piece value totals
+		*/
+		constexpr PieceValueTotals compute_piece_values() const noexcept
+		{
+			return BoardWithState{ static_cast<const PieceBoard&>(*this) }.get_piece_values();
+		};
+
+		/**
+		 * @brief Gets the total material value of a player's pieces, see piece_square_values
+		 * @param _player Player to get material of
+		 * @return Material value in centipawns
+		*/
+		constexpr int get_material(Color _player) const noexcept
+		{
+			return this->values_.material[jc::to_underlying(_player)];
+		};
+
+		/**
+		 * @brief Gets the game phase, max_game_phase_v at the start and 0 with only kings and pawns left
+		 * @return Game phase clamped to [0, max_game_phase_v]
+		*/
+		constexpr int get_phase() const noexcept
+		{
+			return std::min(this->values_.phase, max_game_phase_v);
+		};
+
+		/**
+		 * @brief Checks the incrementally updated state against a full recalculation.
+		 * 
+		 * Does nothing unless LAMBDEX_CHESS_VERIFY_INCREMENTAL is set.
+		*/
+		constexpr void verify_incremental_state() const noexcept
+		{
+#if LAMBDEX_CHESS_VERIFY_INCREMENTAL
+			if (this->zobrist_key() != this->compute_zobrist_key() || this->pawn_key() != this->compute_pawn_key() ||
+				this->material_key() != this->compute_material_key())
+			{
+				JCLIB_ABORT();
+			};
+
+			if (this->get_piece_values() != this->compute_piece_values())
+			{
+				JCLIB_ABORT();
+			};
+#endif
+		};
+
+
+
 		bool black_can_castle_kingside = true;
 		bool black_can_castle_queenside = true;
 		bool white_can_castle_kingside = true;
@@ -137,21 +664,102 @@ namespace lbx::chess
 		uint16_t full_move_counter = 1;
 
 
-		// Pull down special member functions
+		// Special member functions
 
-		using PieceBoard::PieceBoard;
-		using PieceBoard::operator=;
+		constexpr BoardWithState() = default;
 
 		constexpr BoardWithState(PieceBoard&& other) :
 			PieceBoard{ std::move(other) }
-		{};
+		{
+			this->rebuild_bitboards();
+		};
 		constexpr BoardWithState(const PieceBoard& other) :
 			PieceBoard{ other }
-		{};
+		{
+			this->rebuild_bitboards();
+		};
 
+		/**
+		 * @brief Replaces the pieces on the board, keeps the rest of the state as is
+		*/
+		constexpr BoardWithState& operator=(const PieceBoard& other)
+		{
+			PieceBoard::operator=(other);
+			this->rebuild_bitboards();
+			return *this;
+		};
 
 	private:
 
+		/**
+		 * @brief Gets the Zobrist key for an en passant square
+		 * @param _pos En passant square
+		 * @return Zobrist key for its file
+		*/
+		constexpr static ZobristKey en_passant_key(Position _pos) noexcept
+		{
+			return zobrist_keys.en_passant_file[_pos.get() % 8];
+		};
+
+		/**
+		 * @brief Recalculates the bit boards and piece key from the piece array
+		*/
+		constexpr void rebuild_bitboards() noexcept
+		{
+			this->piece_bits_ = {};
+			this->color_bits_ = {};
+			this->key_ = (this->has_en_passant()) ? en_passant_key(this->en_passant_) : 0;
+			this->pawn_key_ = 0;
+			this->material_key_ = 0;
+			this->values_ = {};
+
+			Position p{};
+			for (auto& s : *this)
+			{
+				if (s != Piece::empty)
+				{
+					this->piece_bits_[piece_bits_index(s)].set(p);
+					this->color_bits_[jc::to_underlying(get_color(s))].set(p);
+					this->key_ ^= piece_key(s, p);
+					this->pawn_key_ ^= pawn_piece_key(s, p);
+					this->material_key_ += material_key_unit(s);
+					this->update_piece_values(s, p, 1);
+				};
+				++p;
+			};
+		};
+
+		/**
+		 * @brief Squares holding each piece, see piece_bits_index()
+		*/
+		std::array<BitBoard, 12> piece_bits_{};
+
+		/**
+		 * @brief Squares holding each player's pieces, indexed by color
+		*/
+		std::array<BitBoard, 2> color_bits_{};
+
+		/**
+		 * @brief Zobrist key of the pieces and en passant file, see zobrist_key()
+		*/
+		ZobristKey key_ = 0;
+
+		/**
+		 * @brief Zobrist key of just the pawns, see pawn_key()
+		*/
+		ZobristKey pawn_key_ = 0;
+
+		/**
+		 * @brief Count of each piece, see material_key()
+		*/
+		MaterialKey material_key_ = 0;
+
+		/**
+		 * @brief Material, piece-square and game phase totals, see get_piece_values()
+		*/
+		PieceValueTotals values_{};
+
+
 		/**
 		 * @brief En passant position
 		 * 
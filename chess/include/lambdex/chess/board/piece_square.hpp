@@ -0,0 +1,258 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_PIECE_SQUARE_HPP
+#define LAMBDEX_CHESS_PIECE_SQUARE_HPP
+
+/*
+	Provides the material values and piece-square tables used for incremental evaluation.
+
+	Each piece on the board is worth its material value plus a bonus for the square it
+	stands on. Square bonuses come in a midgame and an endgame flavour which are blended
+	by the game phase, a count of the minor and major pieces left on the board.
+	BoardWithState keeps a running sum of all of these so that rating a position does
+	not need to look at the pieces at all.
+*/
+
+#include "lambdex/chess/basic.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace lbx::chess
+{
+	namespace impl
+	{
+		/**
+		 * @brief Table of a value for each square, laid out as seen by white with a8 first and h1 last
+		*/
+		using SquareTable = std::array<int, 64>;
+
+		/**
+		 * @brief Values for each piece on each square from its owner's point of view
+		*/
+		struct PieceSquareValues
+		{
+			/**
+			 * @brief Material value of each piece, the piece index matches BoardWithState's bit boards
+			*/
+			std::array<int, 12> material;
+
+			/**
+			 * @brief Midgame square bonus for each piece on each square, indexed by piece then board position
+			*/
+			std::array<std::array<int, 64>, 12> midgame;
+
+			/**
+			 * @brief Endgame square bonus for each piece on each square, indexed by piece then board position
+			*/
+			std::array<std::array<int, 64>, 12> endgame;
+
+			/**
+			 * @brief Game phase weight of each piece
+			*/
+			std::array<int, 12> phase;
+		};
+
+		// Material values in centipawns, kings are never captured so they are left at 0
+
+		constexpr inline int pawn_value_v = 100;
+		constexpr inline int knight_value_v = 320;
+		constexpr inline int bishop_value_v = 330;
+		constexpr inline int rook_value_v = 500;
+		constexpr inline int queen_value_v = 900;
+		constexpr inline int king_value_v = 0;
+
+		// Game phase weights, the starting position adds up to max_game_phase_v
+
+		constexpr inline int knight_phase_v = 1;
+		constexpr inline int bishop_phase_v = 1;
+		constexpr inline int rook_phase_v = 2;
+		constexpr inline int queen_phase_v = 4;
+
+		// Midgame tables
+
+		constexpr inline SquareTable pawn_squares
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 50,  50,  50,  50,  50,  50,  50,  50,
+			 10,  10,  20,  30,  30,  20,  10,  10,
+			  5,   5,  10,  25,  25,  10,   5,   5,
+			  0,   0,   0,  20,  20,   0,   0,   0,
+			  5,  -5, -10,   0,   0, -10,  -5,   5,
+			  5,  10,  10, -20, -20,  10,  10,   5,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		};
+		constexpr inline SquareTable knight_squares
+		{
+			-50, -40, -30, -30, -30, -30, -40, -50,
+			-40, -20,   0,   0,   0,   0, -20, -40,
+			-30,   0,  10,  15,  15,  10,   0, -30,
+			-30,   5,  15,  20,  20,  15,   5, -30,
+			-30,   0,  15,  20,  20,  15,   0, -30,
+			-30,   5,  10,  15,  15,  10,   5, -30,
+			-40, -20,   0,   5,   5,   0, -20, -40,
+			-50, -40, -30, -30, -30, -30, -40, -50,
+		};
+		constexpr inline SquareTable bishop_squares
+		{
+			-20, -10, -10, -10, -10, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,  10,  10,   5,   0, -10,
+			-10,   5,   5,  10,  10,   5,   5, -10,
+			-10,   0,  10,  10,  10,  10,   0, -10,
+			-10,  10,  10,  10,  10,  10,  10, -10,
+			-10,   5,   0,   0,   0,   0,   5, -10,
+			-20, -10, -10, -10, -10, -10, -10, -20,
+		};
+		constexpr inline SquareTable rook_squares
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  5,  10,  10,  10,  10,  10,  10,   5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			 -5,   0,   0,   0,   0,   0,   0,  -5,
+			  0,   0,   0,   5,   5,   0,   0,   0,
+		};
+		constexpr inline SquareTable queen_squares
+		{
+			-20, -10, -10,  -5,  -5, -10, -10, -20,
+			-10,   0,   0,   0,   0,   0,   0, -10,
+			-10,   0,   5,   5,   5,   5,   0, -10,
+			 -5,   0,   5,   5,   5,   5,   0,  -5,
+			  0,   0,   5,   5,   5,   5,   0,  -5,
+			-10,   5,   5,   5,   5,   5,   0, -10,
+			-10,   0,   5,   0,   0,   0,   0, -10,
+			-20, -10, -10,  -5,  -5, -10, -10, -20,
+		};
+		constexpr inline SquareTable king_squares
+		{
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-30, -40, -40, -50, -50, -40, -40, -30,
+			-20, -30, -30, -40, -40, -30, -30, -20,
+			-10, -20, -20, -20, -20, -20, -20, -10,
+			 20,  20,   0,   0,   0,   0,  20,  20,
+			 20,  30,  10,   0,   0,  10,  30,  20,
+		};
+
+		// Endgame tables, pieces without one use their midgame table
+
+		constexpr inline SquareTable pawn_endgame_squares
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 80,  80,  80,  80,  80,  80,  80,  80,
+			 50,  50,  50,  50,  50,  50,  50,  50,
+			 30,  30,  30,  30,  30,  30,  30,  30,
+			 20,  20,  20,  20,  20,  20,  20,  20,
+			 10,  10,  10,  10,  10,  10,  10,  10,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		};
+		constexpr inline SquareTable rook_endgame_squares
+		{
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			 10,  10,  10,  10,  10,  10,  10,  10,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+			  0,   0,   0,   0,   0,   0,   0,   0,
+		};
+		constexpr inline SquareTable king_endgame_squares
+		{
+			-50, -40, -30, -20, -20, -30, -40, -50,
+			-30, -20, -10,   0,   0, -10, -20, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  30,  40,  40,  30, -10, -30,
+			-30, -10,  20,  30,  30,  20, -10, -30,
+			-30, -30,   0,   0,   0,   0, -30, -30,
+			-50, -30, -30, -30, -30, -30, -30, -50,
+		};
+
+		consteval PieceSquareValues make_piece_square_values()
+		{
+			// Ordered the same as BoardWithState::piece_bits_index(), white then black for each piece
+			constexpr auto _material = std::array
+			{
+				pawn_value_v, knight_value_v, bishop_value_v, rook_value_v, queen_value_v, king_value_v
+			};
+			constexpr auto _phase = std::array
+			{
+				0, knight_phase_v, bishop_phase_v, rook_phase_v, queen_phase_v, 0
+			};
+			constexpr auto _midgame = std::array
+			{
+				&pawn_squares, &knight_squares, &bishop_squares, &rook_squares, &queen_squares, &king_squares
+			};
+			constexpr auto _endgame = std::array
+			{
+				&pawn_endgame_squares, &knight_squares, &bishop_squares, &rook_endgame_squares, &queen_squares, &king_endgame_squares
+			};
+
+			PieceSquareValues _out{};
+			for (size_t p = 0; p != _midgame.size(); ++p)
+			{
+				_out.material[p * 2] = _material[p];
+				_out.material[p * 2 + 1] = _material[p];
+				_out.phase[p * 2] = _phase[p];
+				_out.phase[p * 2 + 1] = _phase[p];
+
+				for (size_t s = 0; s != 64; ++s)
+				{
+					// Board positions start at a1 while the tables start at a8, black sees the board flipped
+					_out.midgame[p * 2][s] = (*_midgame[p])[s ^ 56];
+					_out.midgame[p * 2 + 1][s] = (*_midgame[p])[s];
+					_out.endgame[p * 2][s] = (*_endgame[p])[s ^ 56];
+					_out.endgame[p * 2 + 1][s] = (*_endgame[p])[s];
+				};
+			};
+			return _out;
+		};
+	};
+
+	/**
+	 * @brief Game phase of the starting position, phases count down towards 0 as pieces are traded
+	*/
+	constexpr inline int max_game_phase_v =
+		4 * impl::knight_phase_v + 4 * impl::bishop_phase_v + 4 * impl::rook_phase_v + 2 * impl::queen_phase_v;
+
+	/**
+	 * @brief Running totals of piece values for a board, see BoardWithState::get_piece_values()
+	*/
+	struct PieceValueTotals
+	{
+		/**
+		 * @brief Material value of each player's pieces, indexed by color
+		*/
+		std::array<int, 2> material{};
+
+		/**
+		 * @brief Midgame square bonus of each player's pieces, indexed by color
+		*/
+		std::array<int, 2> midgame{};
+
+		/**
+		 * @brief Endgame square bonus of each player's pieces, indexed by color
+		*/
+		std::array<int, 2> endgame{};
+
+		/**
+		 * @brief Game phase of both players' pieces combined, may exceed max_game_phase_v after promotions
+		*/
+		int phase = 0;
+
+		constexpr bool operator==(const PieceValueTotals&) const noexcept = default;
+	};
+
+	/**
+	 * @brief Material and square values used for incremental evaluation
+	*/
+	constexpr inline impl::PieceSquareValues piece_square_values = impl::make_piece_square_values();
+
+};
+
+#endif // LAMBDEX_CHESS_PIECE_SQUARE_HPP
@@ -0,0 +1,111 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_ZOBRIST_HPP
+#define LAMBDEX_CHESS_ZOBRIST_HPP
+
+/*
+	Provides the random keys used to build Zobrist hashes of chess positions.
+
+	A position's key is the XOR of the key for each (piece, square) pair on the board
+	along with keys for the side to move, castling rights and en passant file. Moving a
+	piece only needs a couple of XORs to update the key.
+*/
+
+#include "lambdex/chess/basic.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief 64-bit hash identifying a chess position
+	*/
+	using ZobristKey = uint64_t;
+
+	namespace impl
+	{
+		/**
+		 * @brief Random keys for each part of a position
+		*/
+		struct ZobristKeys
+		{
+			/**
+			 * @brief Key for each piece on each square, the piece index matches BoardWithState's bit boards
+			*/
+			std::array<std::array<ZobristKey, 64>, 12> pieces;
+
+			/**
+			 * @brief Key that is included when it is black's turn
+			*/
+			ZobristKey black_to_move;
+
+			/**
+			 * @brief Key for each combination of castling flags.
+			 *
+			 * Bits are (white kingside, white queenside, black kingside, black queenside) from
+			 * lowest to highest, each entry is the XOR of the keys of its set bits.
+			*/
+			std::array<ZobristKey, 16> castling;
+
+			/**
+			 * @brief Key for the file of the en passant square, if there is one
+			*/
+			std::array<ZobristKey, 8> en_passant_file;
+		};
+
+		/**
+		 * @brief splitmix64, used to fill the key tables at compile time
+		*/
+		constexpr uint64_t zobrist_next_random(uint64_t& _state) noexcept
+		{
+			_state += 0x9E3779B97F4A7C15ull;
+			auto _z = _state;
+			_z = (_z ^ (_z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			_z = (_z ^ (_z >> 27)) * 0x94D049BB133111EBull;
+			return _z ^ (_z >> 31);
+		};
+
+		consteval ZobristKeys make_zobrist_keys(uint64_t _seed)
+		{
+			ZobristKeys _out{};
+			for (auto& p : _out.pieces)
+			{
+				for (auto& k : p)
+				{
+					k = zobrist_next_random(_seed);
+				};
+			};
+			_out.black_to_move = zobrist_next_random(_seed);
+
+			std::array<ZobristKey, 4> _castleFlagKeys{};
+			for (auto& k : _castleFlagKeys)
+			{
+				k = zobrist_next_random(_seed);
+			};
+			for (size_t n = 0; n != _out.castling.size(); ++n)
+			{
+				for (size_t b = 0; b != _castleFlagKeys.size(); ++b)
+				{
+					if (n & (size_t{ 1 } << b))
+					{
+						_out.castling[n] ^= _castleFlagKeys[b];
+					};
+				};
+			};
+
+			for (auto& k : _out.en_passant_file)
+			{
+				k = zobrist_next_random(_seed);
+			};
+			return _out;
+		};
+	};
+
+	/**
+	 * @brief The keys used for Zobrist hashing, these are fixed so keys can be stored between runs
+	*/
+	constexpr inline impl::ZobristKeys zobrist_keys = impl::make_zobrist_keys(0x1D5A2C9F00D5EEDull);
+
+};
+
+#endif // LAMBDEX_CHESS_ZOBRIST_HPP
@@ -0,0 +1,161 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_ENDGAME_HPP
+#define LAMBDEX_CHESS_ENDGAME_HPP
+
+/*
+	Provides specialised evaluation for simple endgames. Boards are matched to an endgame by
+	their material key, so a lookup is a piece count and a few compares.
+*/
+
+#include "evaluation.hpp"
+#include "board/board_with_state.hpp"
+
+#include <string_view>
+#include <optional>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Rating given to a won endgame on top of the mop up terms, well clear of anything
+	 * the normal evaluation gives but below a checkmate.
+	*/
+	constexpr inline Rating endgame_win_v = 20000;
+
+	/**
+	 * @brief Most pieces, kings included, that any of the known endgames have
+	*/
+	constexpr inline size_t max_endgame_pieces_v = 4;
+
+	/**
+	 * @brief Makes the material key for a signature like "KRK" or "KBNK".
+	 *
+	 * The first king and the pieces after it belong to the strong side, the pieces after
+	 * the second king to the weak side.
+	 *
+	 * @param _signature Material signature, uses the letters KQRBNP
+	 * @param _strong Color of the strong side
+	 * @return Material key matching BoardWithState::material_key()
+	*/
+	constexpr MaterialKey make_material_key(std::string_view _signature, Color _strong)
+	{
+		MaterialKey _key = 0;
+		auto _color = !_strong;
+		for (auto c : _signature)
+		{
+			Piece _piece = Piece::king;
+			switch (c)
+			{
+			case 'K':
+				_color = !_color;
+				continue;
+			case 'Q':
+				_piece = Piece::queen;
+				break;
+			case 'R':
+				_piece = Piece::rook;
+				break;
+			case 'B':
+				_piece = Piece::bishop;
+				break;
+			case 'N':
+				_piece = Piece::knight;
+				break;
+			case 'P':
+				_piece = Piece::pawn;
+				break;
+			default:
+				JCLIB_ABORT();
+				break;
+			};
+			_key += BoardWithState::material_key_unit(_piece | _color);
+		};
+		return _key;
+	};
+
+	/**
+	 * @brief Function rating an endgame from the strong side's POV
+	*/
+	using EndgameFunction = Rating(*)(const BoardWithState& _board, Color _strong);
+
+	/**
+	 * @brief A known endgame for one color as the strong side
+	*/
+	struct Endgame
+	{
+		/**
+		 * @brief Material key of boards in this endgame
+		*/
+		MaterialKey key;
+
+		/**
+		 * @brief Rates the board from the strong side's POV
+		*/
+		EndgameFunction evaluate;
+
+		/**
+		 * @brief Color of the strong side
+		*/
+		Color strong;
+
+		/**
+		 * @brief Material signature, for display
+		*/
+		std::string_view name;
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Looks up the endgame for a material key
+		 * @param _key Material key
+		 * @return Endgame, or nullptr if there is no specialised evaluation for the key
+		*/
+		const Endgame* find_endgame(MaterialKey _key) noexcept;
+	};
+
+	/**
+	 * @brief Finds the specialised evaluation for a board's material, if any
+	 * @param _board Board to find endgame for
+	 * @return Endgame, or nullptr if the board isn't a known endgame
+	*/
+	inline const Endgame* find_endgame(const BoardWithState& _board) noexcept
+	{
+		if (_board.count_pieces() > max_endgame_pieces_v)
+		{
+			return nullptr;
+		};
+		return impl::find_endgame(_board.material_key());
+	};
+
+	/**
+	 * @brief Rates a board with the specialised evaluation for its material.
+	 *
+	 * Stalemates rate as a draw. Checkmates are left to the normal evaluation.
+	 *
+	 * @param _context Context for the board to rate
+	 * @param _player Player whose POV to rate from
+	 * @return Rating, or nullopt if the board isn't a known endgame or is checkmate
+	*/
+	std::optional<Rating> rate_endgame(const RatingContext& _context, Color _player);
+
+	/**
+	 * @brief Rates a board with the specialised evaluation for its material.
+	 *
+	 * Stalemates rate as a draw. Checkmates are left to the normal evaluation.
+	 *
+	 * @param _board Board to rate
+	 * @param _player Player whose POV to rate from
+	 * @return Rating, or nullopt if the board isn't a known endgame or is checkmate
+	*/
+	inline std::optional<Rating> rate_endgame(const BoardWithState& _board, Color _player)
+	{
+		if (!find_endgame(_board))
+		{
+			return std::nullopt;
+		};
+		return rate_endgame(RatingContext{ _board }, _player);
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_ENDGAME_HPP
@@ -0,0 +1,241 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_EVAL_CACHE_HPP
+#define LAMBDEX_CHESS_EVAL_CACHE_HPP
+
+/*
+	Provides a fixed size cache of board ratings keyed by Zobrist key, safe to share
+	between threads without locking.
+*/
+
+#include "evaluation.hpp"
+#include "board/zobrist.hpp"
+
+#include <span>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <optional>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Hit and miss counts for an evaluation cache
+	*/
+	struct EvalCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+
+		constexpr EvalCacheStats& operator+=(const EvalCacheStats& rhs) noexcept
+		{
+			this->hits += rhs.hits;
+			this->misses += rhs.misses;
+			return *this;
+		};
+	};
+
+	/**
+	 * @brief Fixed size table of ratings keyed by position.
+	 *
+	 * Each entry is a single 64-bit word holding the upper half of the key alongside the
+	 * rating, so reads and writes from different threads never tear and no locking is
+	 * needed. Newer ratings simply replace whatever was in their slot.
+	 *
+	 * A cache must only ever hold ratings from a single rater.
+	*/
+	class EvalCache
+	{
+	public:
+
+		/**
+		 * @brief Looks up a rating
+		 * @param _key Zobrist key of the board
+		 * @param _player Player whose POV the rating is from
+		 * @return Cached rating, or nullopt on a miss
+		*/
+		std::optional<Rating> probe(ZobristKey _key, Color _player) const noexcept
+		{
+			_key = pov_key(_key, _player);
+			const auto _data = this->entries_[_key & this->mask_].load(std::memory_order_relaxed);
+			if ((_data & key_mask_v) == (_key & key_mask_v))
+			{
+				return static_cast<Rating>(static_cast<int32_t>(static_cast<uint32_t>(_data)));
+			};
+			return std::nullopt;
+		};
+
+		/**
+		 * @brief Stores a rating, replacing whatever was in its slot
+		 * @param _key Zobrist key of the board
+		 * @param _player Player whose POV the rating is from
+		 * @param _rating Rating to store, must fit in 32 bits
+		*/
+		void store(ZobristKey _key, Color _player, Rating _rating) noexcept
+		{
+			_key = pov_key(_key, _player);
+			const auto _data = (_key & key_mask_v) | static_cast<uint32_t>(static_cast<int32_t>(_rating));
+			this->entries_[_key & this->mask_].store(_data, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Adds to the running hit and miss totals
+		 * @param _stats Counts to add, usually gathered by a single thread
+		*/
+		void add_stats(const EvalCacheStats& _stats) noexcept
+		{
+			this->hits_.fetch_add(_stats.hits, std::memory_order_relaxed);
+			this->misses_.fetch_add(_stats.misses, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Gets the running hit and miss totals
+		 * @return Totals since construction
+		*/
+		EvalCacheStats stats() const noexcept
+		{
+			return EvalCacheStats{ this->hits_.load(std::memory_order_relaxed), this->misses_.load(std::memory_order_relaxed) };
+		};
+
+		/**
+		 * @brief Gets the number of entries in the table
+		*/
+		size_t size() const noexcept
+		{
+			return this->mask_ + 1;
+		};
+
+		/**
+		 * @brief Empties the table, must not be called while other threads are using it
+		*/
+		void clear() noexcept;
+
+		/**
+		 * @brief Allocates the table
+		 * @param _megabytes Table size, rounded down to a power of two entries
+		*/
+		explicit EvalCache(size_t _megabytes);
+
+	private:
+
+		/**
+		 * @brief Bits of the key stored in an entry, the rest holds the rating
+		*/
+		constexpr static uint64_t key_mask_v = 0xFFFFFFFF00000000ull;
+
+		/**
+		 * @brief Folds the rating POV into the key so both players can share the table
+		*/
+		constexpr static ZobristKey pov_key(ZobristKey _key, Color _player) noexcept
+		{
+			return (_player == Color::black) ? _key ^ 0x6A09E667F3BCC909ull : _key;
+		};
+
+		std::unique_ptr<std::atomic<uint64_t>[]> entries_;
+		size_t mask_ = 0;
+
+		alignas(64) std::atomic<uint64_t> hits_{ 0 };
+		std::atomic<uint64_t> misses_{ 0 };
+	};
+
+	/**
+	 * @brief Board rater that looks ratings up in an EvalCache before asking another rater.
+	 *
+	 * Hits and misses are counted into an optional EvalCacheStats owned by the caller,
+	 * this should belong to a single thread. Hand it to EvalCache::add_stats() when done.
+	 *
+	 * @tparam RaterT Rater to cache
+	*/
+	template <cx_board_rater RaterT>
+	class BoardRater_Cached
+	{
+	public:
+
+		/**
+		 * @brief Rates the board, using the cache when possible
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			const auto _key = _board.zobrist_key();
+			if (const auto _cached = this->cache_->probe(_key, _player); _cached)
+			{
+				if (this->stats_) { ++this->stats_->hits; };
+				return *_cached;
+			};
+
+			const auto _rating = this->rater_.rate(_board, _player);
+			this->cache_->store(_key, _player, _rating);
+			if (this->stats_) { ++this->stats_->misses; };
+			return _rating;
+		};
+
+		/**
+		 * @brief Rates many boards, using the cache when possible
+		 *
+		 * Boards missing from the cache are handed to the cached rater in runs of
+		 * neighbouring misses, so a batch rater still sees batches.
+		 *
+		 * @param _boards Boards to rate
+		 * @param _player Player whose POV to rate from
+		 * @param _out Where to write the ratings, must be at least as long as _boards
+		*/
+		void rate_batch(std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out) const
+		{
+			JCLIB_ASSERT(_out.size() >= _boards.size());
+
+			size_t n = 0;
+			while (n != _boards.size())
+			{
+				if (const auto _cached = this->cache_->probe(_boards[n].zobrist_key(), _player); _cached)
+				{
+					if (this->stats_) { ++this->stats_->hits; };
+					_out[n] = *_cached;
+					++n;
+					continue;
+				};
+
+				// Find the end of this run of misses
+				auto _end = n + 1;
+				while (_end != _boards.size() && !this->cache_->probe(_boards[_end].zobrist_key(), _player))
+				{
+					++_end;
+				};
+
+				const auto _count = _end - n;
+				chess::rate_batch(_boards.subspan(n, _count), _player, _out.subspan(n, _count), this->rater_);
+				for (; n != _end; ++n)
+				{
+					this->cache_->store(_boards[n].zobrist_key(), _player, _out[n]);
+				};
+				if (this->stats_) { this->stats_->misses += _count; };
+			};
+		};
+
+		/**
+		 * @brief Gets the cached rater
+		*/
+		constexpr const RaterT& rater() const noexcept { return this->rater_; };
+
+		/**
+		 * @brief Constructs the caching rater
+		 * @param _cache Cache to use, must outlive this
+		 * @param _rater Rater to cache
+		 * @param _stats Optional counts to add hits and misses to, must outlive this
+		*/
+		explicit BoardRater_Cached(EvalCache& _cache, RaterT _rater = RaterT{}, EvalCacheStats* _stats = nullptr) :
+			cache_{ &_cache },
+			rater_{ std::move(_rater) },
+			stats_{ _stats }
+		{};
+
+	private:
+		EvalCache* cache_;
+		RaterT rater_;
+		EvalCacheStats* stats_;
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_EVAL_CACHE_HPP
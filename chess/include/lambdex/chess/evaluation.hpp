@@ -9,12 +9,21 @@
 #include "board/piece_board.hpp"
 #include "board/board_with_state.hpp"
 
+#include "move_list.hpp"
 #include "apply_move.hpp"
 #include "move_validation.hpp"
 
 #include <jclib/type.h>
 #include <jclib/concepts.h>
 
+#include <span>
+#include <array>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <algorithm>
+
 namespace lbx::chess
 {
 	/**
@@ -47,6 +56,237 @@ namespace lbx::chess
 		{ _rater.rate(_board, _player) } -> jc::cx_same_as<Rating>;
 	};
 
+	/**
+	 * @brief Pieces that AttackInfo keeps per piece counts for, in the order they are indexed
+	*/
+	constexpr inline auto attack_info_pieces = std::array
+	{
+		Piece::knight, Piece::bishop, Piece::rook, Piece::queen
+	};
+
+	/**
+	 * @brief Pseudo-legal attack sets of both players, pins and checks are ignored.
+	 *
+	 * Everything is indexed by color, per piece counts are then indexed in the order of
+	 * attack_info_pieces.
+	*/
+	struct AttackInfo
+	{
+		/**
+		 * @brief Squares attacked by each player's pawns
+		*/
+		std::array<BitBoard, 2> pawn_attacks{};
+
+		/**
+		 * @brief Squares attacked by any of each player's pieces, pawns and king included
+		*/
+		std::array<BitBoard, 2> attacked{};
+
+		/**
+		 * @brief Each player's king square and the squares around it
+		*/
+		std::array<BitBoard, 2> king_zone{};
+
+		/**
+		 * @brief Number of squares each player's pieces attack that are not held by their own pieces
+		 * or attacked by enemy pawns, summed over the pieces of each kind
+		*/
+		std::array<std::array<int, 4>, 2> mobility{};
+
+		/**
+		 * @brief Number of squares in the enemy king zone attacked by each player's pieces, summed over
+		 * the pieces of each kind
+		*/
+		std::array<std::array<int, 4>, 2> king_zone_attacks{};
+	};
+
+	/**
+	 * @brief Works out the attack sets of both players
+	 * @param _board Board to look at
+	 * @return Attack sets
+	*/
+	AttackInfo compute_attack_info(const BoardWithState& _board);
+
+	namespace impl
+	{
+		/**
+		 * @brief Bounds a per piece term by the number of pieces on the board.
+		 *
+		 * Each piece of the kinds in attack_info_pieces adds at most "_perPiece" to its owner's
+		 * total, so neither total can be more than that times the number of pieces the player
+		 * has other than pawns and the king. Cheap enough to run every node.
+		 *
+		 * @param _board Board to bound the term for
+		 * @param _perPiece Most a single piece can add
+		 * @return Bound on either player's total, and so on the difference between them
+		*/
+		inline Rating bound_by_piece_count(const BoardWithState& _board, Rating _perPiece)
+		{
+			size_t _most = 0;
+			for (auto c : { Color::white, Color::black })
+			{
+				const auto _pieces = _board.as_bits_with_pieces(c) &
+					~(_board.as_bits_with_pieces(Piece::pawn | c) | _board.as_bits_with_pieces(Piece::king | c));
+				_most = std::max(_most, static_cast<size_t>(_pieces.count()));
+			};
+			return static_cast<Rating>(_most) * std::abs(_perPiece);
+		};
+	};
+
+	/**
+	 * @brief Data about a board that is expensive to find and may be wanted by several raters.
+	 *
+	 * Everything is worked out the first time it is asked for and then reused, so a rater
+	 * made of several terms only pays for it once per board. The board must be a position
+	 * reached by legal moves, ie. the player who just moved is not in check.
+	*/
+	class RatingContext
+	{
+	public:
+
+		/**
+		 * @brief Gets the board being rated
+		*/
+		constexpr const BoardWithState& board() const noexcept
+		{
+			return *this->board_;
+		};
+
+		/**
+		 * @brief Checks if the player whose turn it is is in check
+		 * @return True if in check
+		*/
+		bool in_check() const;
+
+		/**
+		 * @brief Gets the number of legal moves for the player whose turn it is
+		 * @return Legal move count
+		*/
+		size_t legal_move_count() const;
+
+		/**
+		 * @brief Checks if a player is checkmated, a player without a king counts as checkmated
+		 * @param _player Player to test for checkmate of
+		 * @return True if checkmate
+		*/
+		bool is_checkmate(Color _player) const;
+
+		/**
+		 * @brief Gets the pseudo-legal attack sets of both players
+		 * @return Attack sets
+		*/
+		const AttackInfo& attack_info() const;
+
+		constexpr explicit RatingContext(const BoardWithState& _board) noexcept :
+			board_{ &_board }
+		{};
+
+	private:
+		const BoardWithState* board_;
+
+		mutable std::optional<bool> in_check_{};
+		mutable std::optional<size_t> legal_move_count_{};
+		mutable std::optional<AttackInfo> attack_info_{};
+	};
+
+	/**
+	 * @brief The range of ratings a search still cares about, anything at or outside the bounds is a cutoff
+	*/
+	struct RatingWindow
+	{
+		Rating alpha = std::numeric_limits<Rating>::min();
+		Rating beta = std::numeric_limits<Rating>::max();
+
+		/**
+		 * @brief Checks if a rating lies strictly inside the window
+		*/
+		constexpr bool contains(Rating _rating) const noexcept
+		{
+			return _rating > this->alpha && _rating < this->beta;
+		};
+	};
+
+	/**
+	 * @brief Counts of how often a windowed rating stopped early
+	*/
+	struct LazyEvalStats
+	{
+		/**
+		 * @brief Number of boards rated with a window
+		*/
+		uint64_t evaluations = 0;
+
+		/**
+		 * @brief Number of those that stopped before rating every term
+		*/
+		uint64_t lazy_exits = 0;
+
+		constexpr LazyEvalStats& operator+=(const LazyEvalStats& rhs) noexcept
+		{
+			this->evaluations += rhs.evaluations;
+			this->lazy_exits += rhs.lazy_exits;
+			return *this;
+		};
+	};
+
+	/**
+	 * @brief Defines a board rater that can stop early once the rating is known to be outside a window.
+	 *
+	 * If the true rating lies inside the window the same value as "rate" must be given,
+	 * otherwise any value on the same side of the window as the true rating may be.
+	*/
+	template <typename T>
+	concept cx_windowed_rater = cx_board_rater<T> && requires(const T & _rater, const BoardWithState & _board, Color _player, RatingWindow _window)
+	{
+		{ _rater.rate(_board, _player, _window) } -> jc::cx_same_as<Rating>;
+	};
+
+	/**
+	 * @brief Defines a board rater that can be asked how far from zero its rating can possibly get
+	*/
+	template <typename T>
+	concept cx_bounded_rater = cx_board_rater<T> && requires(const T & _rater, const RatingContext & _context)
+	{
+		{ _rater.rating_bound(_context) } -> jc::cx_same_as<Rating>;
+	};
+
+	/**
+	 * @brief Defines a board rater that can read from a shared RatingContext instead of working things out itself
+	*/
+	template <typename T>
+	concept cx_context_rater = cx_board_rater<T> && requires(const T & _rater, const RatingContext & _context, Color _player)
+	{
+		{ _rater.rate(_context, _player) } -> jc::cx_same_as<Rating>;
+	};
+
+	/**
+	 * @brief Defines a board rater whose rating is a sum over the pieces on the board.
+	 *
+	 * "rate_square" gives the contribution of a single piece, summing it over every
+	 * occupied square must give the same value as "rate". This lets several of these be
+	 * fused into one pass over the board, see BoardRater_Fused.
+	*/
+	template <typename T>
+	concept cx_square_rater = cx_board_rater<T> &&
+		requires(const T & _rater, const RatingContext & _context, Position _pos, Piece _piece, Color _player)
+	{
+		{ _rater.rate_square(_context, _pos, _piece, _player) } -> jc::cx_same_as<Rating>;
+	};
+
+	/**
+	 * @brief Defines a board rater that can rate many boards in one call.
+	 *
+	 * "rate_batch" must give the same ratings as calling "rate" on each board, it
+	 * exists so raters can lay their inputs out side by side and rate them in tight
+	 * loops the compiler can vectorise. See rate_batch() and rate_children().
+	*/
+	template <typename T>
+	concept cx_batch_rater = cx_board_rater<T> &&
+		requires(const T & _rater, std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out)
+	{
+		_rater.rate_batch(_boards, _player, _out);
+	};
+
 	/**
 	 * @brief Simple board rater taking only material into account
 	*/
@@ -103,6 +343,27 @@ namespace lbx::chess
 			return _value;
 		};
 
+		/**
+		 * @brief Gets the total piece value of a player's existing pieces using the board's bit boards
+		 * @param _board Board to get pieces from
+		 * @param _player Player to get value of
+		 * @return Total value
+		*/
+		int get_player_material(const BoardWithState& _board, Color _player) const
+		{
+			constexpr auto _pieces = std::array
+			{
+				Piece::pawn, Piece::knight, Piece::bishop, Piece::rook, Piece::queen, Piece::king
+			};
+
+			int _value = 0;
+			for (auto& p : _pieces)
+			{
+				_value += static_cast<int>(_board.count_pieces(p | _player)) * this->get_piece_value(p);
+			};
+			return _value;
+		};
+
 		/**
 		 * @brief Rates the board using only material value
 		 * @param _board Board to get pieces from
@@ -113,11 +374,372 @@ namespace lbx::chess
 		{
 			return this->get_player_material(_board, _player) - this->get_player_material(_board, !_player);
 		};
+
+		/**
+		 * @brief Rates the board using only material value
+		 * @param _board Board to get pieces from
+		 * @param _player Player to get value of
+		 * @return Total value
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return this->get_player_material(_board, _player) - this->get_player_material(_board, !_player);
+		};
 	};
 
 	// Check that the concept was fufilled
 	static_assert(cx_board_rater<BoardRater_Material>);
 
+	/**
+	 * @brief Board rater using material and tapered piece-square tables.
+	 *
+	 * Midgame and endgame square bonuses are blended by the game phase. The totals
+	 * and phase are kept up to date by the board as pieces move, so rating never
+	 * looks at the pieces. See piece_square_values for the values used.
+	*/
+	struct BoardRater_PieceSquare
+	{
+	public:
+
+		/**
+		 * @brief Blends midgame and endgame values by game phase
+		 * @param _midgame Value in the midgame
+		 * @param _endgame Value in the endgame
+		 * @param _phase Game phase in [0, max_game_phase_v]
+		 * @return Blended value
+		*/
+		constexpr static Rating taper(Rating _midgame, Rating _endgame, int _phase) noexcept
+		{
+			return (_midgame * _phase + _endgame * (max_game_phase_v - _phase)) / max_game_phase_v;
+		};
+
+		/**
+		 * @brief Rates the board using material and piece placement
+		 * @param _board Board to get pieces from
+		 * @param _player Player to get value of
+		 * @return Total value
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			const auto& _values = _board.get_piece_values();
+#if LAMBDEX_CHESS_VERIFY_INCREMENTAL
+			if (_values != _board.compute_piece_values())
+			{
+				JCLIB_ABORT();
+			};
+#endif
+			const auto _me = jc::to_underlying(_player);
+			const auto _them = jc::to_underlying(!_player);
+			const auto _material = _values.material[_me] - _values.material[_them];
+			const auto _midgame = _values.midgame[_me] - _values.midgame[_them];
+			const auto _endgame = _values.endgame[_me] - _values.endgame[_them];
+			return _material + taper(_midgame, _endgame, _board.get_phase());
+		};
+
+		/**
+		 * @brief Rates many boards using material and piece placement
+		 *
+		 * The totals are gathered into arrays a chunk at a time so the tapering is a
+		 * straight loop over plain integers.
+		 *
+		 * @param _boards Boards to rate
+		 * @param _player Player whose POV to rate from
+		 * @param _out Where to write the ratings, must be at least as long as _boards
+		*/
+		void rate_batch(std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out) const
+		{
+			JCLIB_ASSERT(_out.size() >= _boards.size());
+
+			constexpr size_t _lanes = 64;
+			std::array<Rating, _lanes> _material;
+			std::array<Rating, _lanes> _midgame;
+			std::array<Rating, _lanes> _endgame;
+			std::array<Rating, _lanes> _phase;
+
+			const auto _me = jc::to_underlying(_player);
+			const auto _them = jc::to_underlying(!_player);
+			for (size_t _base = 0; _base < _boards.size(); _base += _lanes)
+			{
+				const auto _count = std::min(_lanes, _boards.size() - _base);
+				for (size_t n = 0; n != _count; ++n)
+				{
+					const auto& _board = _boards[_base + n];
+					const auto& _values = _board.get_piece_values();
+#if LAMBDEX_CHESS_VERIFY_INCREMENTAL
+					if (_values != _board.compute_piece_values())
+					{
+						JCLIB_ABORT();
+					};
+#endif
+					_material[n] = _values.material[_me] - _values.material[_them];
+					_midgame[n] = _values.midgame[_me] - _values.midgame[_them];
+					_endgame[n] = _values.endgame[_me] - _values.endgame[_them];
+					_phase[n] = _board.get_phase();
+				};
+				for (size_t n = 0; n != _count; ++n)
+				{
+					_out[_base + n] = _material[n] + taper(_midgame[n], _endgame[n], _phase[n]);
+				};
+			};
+		};
+	};
+	static_assert(cx_batch_rater<BoardRater_PieceSquare>);
+
+	/**
+	 * @brief Rates a board by how many squares each player's pieces can move to.
+	 *
+	 * Squares held by the player's own pieces or attacked by enemy pawns don't count.
+	 * The attack sets come from the RatingContext so they can be shared with other terms.
+	*/
+	struct BoardRater_Mobility
+	{
+	public:
+
+		/**
+		 * @brief Rating for each square a piece can move to, in the order of attack_info_pieces
+		*/
+		std::array<Rating, 4> weights{ 4, 5, 2, 1 };
+
+		/**
+		 * @brief Most squares a piece of each kind can attack, in the order of attack_info_pieces
+		*/
+		constexpr static std::array<Rating, 4> max_squares_v{ 8, 13, 14, 27 };
+
+		/**
+		 * @brief Gets the furthest from zero the rating can be for a board
+		 * @param _context Context for the board
+		 * @return Bound on the absolute rating
+		*/
+		Rating rating_bound(const RatingContext& _context) const
+		{
+			Rating _perPiece = 0;
+			for (size_t n = 0; n != this->weights.size(); ++n)
+			{
+				_perPiece = std::max(_perPiece, std::abs(this->weights[n]) * max_squares_v[n]);
+			};
+			return impl::bound_by_piece_count(_context.board(), _perPiece);
+		};
+
+		/**
+		 * @brief Rates a board by piece mobility
+		 * @param _context Context for the board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const RatingContext& _context, Color _player) const
+		{
+			const auto& _info = _context.attack_info();
+			const auto& _mine = _info.mobility[jc::to_underlying(_player)];
+			const auto& _theirs = _info.mobility[jc::to_underlying(!_player)];
+
+			Rating _sum = 0;
+			for (size_t n = 0; n != this->weights.size(); ++n)
+			{
+				_sum += this->weights[n] * (_mine[n] - _theirs[n]);
+			};
+			return _sum;
+		};
+
+		/**
+		 * @brief Rates a board by piece mobility
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return this->rate(RatingContext{ _board }, _player);
+		};
+	};
+	static_assert(cx_context_rater<BoardRater_Mobility>);
+	static_assert(cx_bounded_rater<BoardRater_Mobility>);
+
+	/**
+	 * @brief Rates a board by how heavily each king's surroundings are attacked.
+	 *
+	 * Each square next to a king attacked by an enemy piece costs the king's owner,
+	 * more for heavier pieces. This fades out with the game phase as the queens and
+	 * rooks come off. Shares its attack sets with BoardRater_Mobility through the
+	 * RatingContext.
+	*/
+	struct BoardRater_KingSafety
+	{
+	public:
+
+		/**
+		 * @brief Penalty for each king zone square an enemy piece attacks, in the order of attack_info_pieces
+		*/
+		std::array<Rating, 4> weights{ 8, 8, 12, 20 };
+
+		/**
+		 * @brief Gets the furthest from zero the rating can be for a board
+		 * @param _context Context for the board
+		 * @return Bound on the absolute rating
+		*/
+		Rating rating_bound(const RatingContext& _context) const
+		{
+			// A king zone is 9 squares, no piece can attack more than that of it
+			const auto& _board = _context.board();
+			Rating _perPiece = 0;
+			for (auto& w : this->weights)
+			{
+				_perPiece = std::max(_perPiece, std::abs(w) * 9);
+			};
+			return (impl::bound_by_piece_count(_board, _perPiece) * _board.get_phase()) / max_game_phase_v;
+		};
+
+		/**
+		 * @brief Rates a board by king safety
+		 * @param _context Context for the board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const RatingContext& _context, Color _player) const
+		{
+			const auto& _info = _context.attack_info();
+			const auto& _onTheirs = _info.king_zone_attacks[jc::to_underlying(_player)];
+			const auto& _onMine = _info.king_zone_attacks[jc::to_underlying(!_player)];
+
+			Rating _sum = 0;
+			for (size_t n = 0; n != this->weights.size(); ++n)
+			{
+				_sum += this->weights[n] * (_onTheirs[n] - _onMine[n]);
+			};
+			return (_sum * _context.board().get_phase()) / max_game_phase_v;
+		};
+
+		/**
+		 * @brief Rates a board by king safety
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return this->rate(RatingContext{ _board }, _player);
+		};
+	};
+	static_assert(cx_context_rater<BoardRater_KingSafety>);
+	static_assert(cx_bounded_rater<BoardRater_KingSafety>);
+
+	/**
+	 * @brief Rates a board based on if castling is possible for the players.
+	*/
+	struct BoardRater_CastleOpportunity
+	{
+	public:
+
+		/**
+		 * @brief The rating value for being able to castle kingside.
+		*/
+		Rating kingside_value = 1;
+
+		/**
+		 * @brief The rating value for being able to castle queenside.
+		*/
+		Rating queenside_value = 1;
+
+		/**
+		 * @brief Rates a board based on if castling is possible for the players.
+		 *
+		 * @param _board Board to rate.
+		 * @param _player Player whose POV to rate from.
+		 *
+		 * @return Rating based on opportunity to castle.
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			const auto _myPoints =
+				(this->queenside_value * _board.can_player_castle_queenside(_player)) +
+				(this->kingside_value * _board.can_player_castle_kingside(_player));
+			const auto _opponentPoints =
+				(this->queenside_value * _board.can_player_castle_queenside(!_player)) +
+				(this->kingside_value * _board.can_player_castle_kingside(!_player));
+			return _myPoints - _opponentPoints;
+		};
+
+		/**
+		 * @brief Gets the furthest from zero the rating can be
+		 * @return Bound on the absolute rating
+		*/
+		Rating rating_bound(const RatingContext&) const
+		{
+			return std::abs(this->kingside_value) + std::abs(this->queenside_value);
+		};
+	};
+	static_assert(cx_bounded_rater<BoardRater_CastleOpportunity>);
+
+	/**
+	 * @brief Rates a board based on if a player is in checkmate.
+	*/
+	struct BoardRater_Checkmate
+	{
+	public:
+
+		/**
+		 * @brief The rating value for putting the opponent in checkmate.
+		*/
+		Rating checkmate_value = 1000000;
+
+		/**
+		 * @brief Rates a board based on if any of the players are in checkmate.
+		 *
+		 * @param _context Context for the board to rate.
+		 * @param _player Player whose POV to rate from.
+		 *
+		 * @return Rating based on checkmates.
+		*/
+		Rating rate(const RatingContext& _context, Color _player) const
+		{
+			if (_context.is_checkmate(_player))
+			{
+				return -this->checkmate_value;
+			}
+			else if (_context.is_checkmate(!_player))
+			{
+				return this->checkmate_value;
+			}
+			else
+			{
+				return 0;
+			};
+		};
+
+		/**
+		 * @brief Rates a board based on if any of the players are in checkmate.
+		 *
+		 * @param _board Board to rate.
+		 * @param _player Player whose POV to rate from.
+		 *
+		 * @return Rating based on checkmates.
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return this->rate(RatingContext{ _board }, _player);
+		};
+
+		/**
+		 * @brief Gets the furthest from zero the rating can be for a board
+		 *
+		 * Only the player whose turn it is can be checkmated, so this is 0 unless they are
+		 * in check or a king is missing.
+		 *
+		 * @param _context Context for the board
+		 * @return Bound on the absolute rating
+		*/
+		Rating rating_bound(const RatingContext& _context) const
+		{
+			const auto& _board = _context.board();
+			const bool _kingsPresent =
+				_board.as_bits_with_pieces(Piece::king | Color::white).any() &&
+				_board.as_bits_with_pieces(Piece::king | Color::black).any();
+			return (_kingsPresent && !_context.in_check()) ? 0 : std::abs(this->checkmate_value);
+		};
+
+	};
+	static_assert(cx_context_rater<BoardRater_Checkmate>);
+	static_assert(cx_bounded_rater<BoardRater_Checkmate>);
+
 	/**
 	 * @brief Rates a board.
 	 * 
@@ -131,6 +753,52 @@ namespace lbx::chess
 		return _rater.rate(_board, _player);
 	};
 
+	/**
+	 * @brief Rates a board, letting the rater stop early if it supports rating within a window.
+	 *
+	 * @param _board The board to rate.
+	 * @param _player The player whose POV we are rating the board from.
+	 * @param _window Ratings the caller cares about, outside of this only the side of the window is exact.
+	 * @param _rater Board rater.
+	*/
+	template <cx_board_rater RaterT = BoardRater_Material>
+	inline Rating rate(const BoardWithState& _board, const Color _player, RatingWindow _window, const RaterT& _rater = RaterT{})
+	{
+		if constexpr (cx_windowed_rater<RaterT>)
+		{
+			return _rater.rate(_board, _player, _window);
+		}
+		else
+		{
+			return _rater.rate(_board, _player);
+		};
+	};
+
+	/**
+	 * @brief Rates many boards, using the rater's batch rating if it has one.
+	 *
+	 * @param _boards The boards to rate.
+	 * @param _player The player whose POV we are rating the boards from.
+	 * @param _out Where to write the ratings, must be at least as long as _boards.
+	 * @param _rater Board rater.
+	*/
+	template <cx_board_rater RaterT = BoardRater_Material>
+	inline void rate_batch(std::span<const BoardWithState> _boards, const Color _player, std::span<Rating> _out, const RaterT& _rater = RaterT{})
+	{
+		JCLIB_ASSERT(_out.size() >= _boards.size());
+		if constexpr (cx_batch_rater<RaterT>)
+		{
+			_rater.rate_batch(_boards, _player, _out);
+		}
+		else
+		{
+			for (size_t n = 0; n != _boards.size(); ++n)
+			{
+				_out[n] = _rater.rate(_boards[n], _player);
+			};
+		};
+	};
+
 	/**
 	 * @brief Represents a move that has been given a ranking
 	*/
@@ -194,7 +862,64 @@ namespace lbx::chess
 		return RatedMove{ _move, _rating };
 	};
 
+	/**
+	 * @brief Constructs a rated move without copying the board
+	 * @param _board Board state PRIOR to the move, the move is made then unmade so this is left unchanged
+	 * @param _move Move that is being rated
+	 * @param _rater Board rater, this is given the board AFTER applying the move
+	*/
+	template <cx_board_rater RaterT = BoardRater_Material>
+	inline RatedMove rate_move(BoardWithState& _board, const Move& _move, const RaterT& _rater = RaterT{})
+	{
+		const auto _player = _board.turn;
+		const auto _undo = make_move(_board, _move);
+		const auto _rating = _rater.rate(_board, _player);
+		unmake_move(_board, _move, _undo);
+		return RatedMove{ _move, _rating };
+	};
 
+	/**
+	 * @brief Rates the board after each move, storing the ratings as the move scores.
+	 *
+	 * Batch raters are given the child boards in chunks, anything else has each move
+	 * made, rated and unmade in turn.
+	 *
+	 * @param _board Board state PRIOR to the moves, this is left unchanged
+	 * @param _moves Moves to rate, their scores are overwritten
+	 * @param _rater Board rater, this is given the boards AFTER applying the moves
+	*/
+	template <cx_board_rater RaterT = BoardRater_Material>
+	inline void rate_children(BoardWithState& _board, MoveList& _moves, const RaterT& _rater = RaterT{})
+	{
+		const auto _player = _board.turn;
+		if constexpr (cx_batch_rater<RaterT>)
+		{
+			constexpr size_t _chunk = 32;
+			std::array<BoardWithState, _chunk> _children;
+			std::array<Rating, _chunk> _ratings;
+			for (size_t _base = 0; _base < _moves.size(); _base += _chunk)
+			{
+				const auto _count = std::min(_chunk, _moves.size() - _base);
+				for (size_t n = 0; n != _count; ++n)
+				{
+					_children[n] = _board;
+					make_move(_children[n], _moves[_base + n]);
+				};
+				_rater.rate_batch(std::span{ _children.data(), _count }, _player, _ratings);
+				for (size_t n = 0; n != _count; ++n)
+				{
+					_moves.set_score(_base + n, _ratings[n]);
+				};
+			};
+		}
+		else
+		{
+			for (size_t n = 0; n != _moves.size(); ++n)
+			{
+				_moves.set_score(n, rate_move(_board, _moves[n], _rater).get_rating());
+			};
+		};
+	};
 
 	/**
 	 * @brief Rates the overall complexity of the board based on which pieces are present.
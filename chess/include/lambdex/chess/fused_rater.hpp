@@ -0,0 +1,327 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_FUSED_RATER_HPP
+#define LAMBDEX_CHESS_FUSED_RATER_HPP
+
+/*
+	Provides a board rater built from several other raters, sharing the work between them
+*/
+
+#include "evaluation.hpp"
+
+#include <span>
+#include <array>
+#include <tuple>
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <utility>
+
+namespace lbx::chess
+{
+	namespace impl
+	{
+		/**
+		 * @brief True if a term is rated by its own batch function when the fused rater rates a batch
+		*/
+		template <typename RaterT>
+		constexpr bool is_fused_batch_term_v = cx_batch_rater<RaterT> && !cx_square_rater<RaterT>;
+
+		/**
+		 * @brief Gets the part of a term's rating that isn't given square by square
+		 * @tparam SkipBatchV If true, terms rated by batch are skipped as well
+		*/
+		template <bool SkipBatchV, cx_board_rater RaterT>
+		constexpr Rating rate_fused_term(const RaterT& _rater, const RatingContext& _context, Color _player)
+		{
+			if constexpr (cx_square_rater<RaterT> || (SkipBatchV && is_fused_batch_term_v<RaterT>))
+			{
+				return 0;
+			}
+			else if constexpr (cx_context_rater<RaterT>)
+			{
+				return _rater.rate(_context, _player);
+			}
+			else
+			{
+				return _rater.rate(_context.board(), _player);
+			};
+		};
+
+		/**
+		 * @brief Gets a term's contribution for a single piece, 0 for terms that don't rate squares
+		*/
+		template <cx_board_rater RaterT>
+		constexpr Rating rate_fused_square(const RaterT& _rater, const RatingContext& _context, Position _pos, Piece _piece, Color _player)
+		{
+			if constexpr (cx_square_rater<RaterT>)
+			{
+				return _rater.rate_square(_context, _pos, _piece, _player);
+			}
+			else
+			{
+				return 0;
+			};
+		};
+
+		/**
+		 * @brief Bound used for terms that can't say how large their rating gets, large enough that
+		 * nothing can be skipped while one is left to rate but small enough to add up safely
+		*/
+		constexpr inline int64_t unbounded_rating_v = int64_t{ 1 } << 40;
+
+		/**
+		 * @brief Gets how far from zero a term's rating can be
+		*/
+		template <cx_board_rater RaterT>
+		inline int64_t fused_term_bound(const RaterT& _rater, const RatingContext& _context)
+		{
+			if constexpr (cx_bounded_rater<RaterT>)
+			{
+				return _rater.rating_bound(_context);
+			}
+			else
+			{
+				return unbounded_rating_v;
+			};
+		};
+
+		/**
+		 * @brief Adds a term's batch ratings onto the ratings in _out, does nothing for other terms
+		*/
+		template <cx_board_rater RaterT>
+		inline void add_fused_batch_term(const RaterT& _rater, std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out)
+		{
+			if constexpr (is_fused_batch_term_v<RaterT>)
+			{
+				constexpr size_t _chunk = 64;
+				std::array<Rating, _chunk> _ratings;
+				for (size_t _base = 0; _base < _boards.size(); _base += _chunk)
+				{
+					const auto _count = std::min(_chunk, _boards.size() - _base);
+					_rater.rate_batch(_boards.subspan(_base, _count), _player, _ratings);
+					for (size_t n = 0; n != _count; ++n)
+					{
+						_out[_base + n] += _ratings[n];
+					};
+				};
+			};
+		};
+	};
+
+	/**
+	 * @brief Board rater that sums a set of other raters.
+	 *
+	 * Terms that rate square by square (cx_square_rater) are fused into a single pass
+	 * over the occupied squares. Terms that can use a RatingContext (cx_context_rater)
+	 * all share one, so things like checkmate detection are only worked out once.
+	 * Everything else is rated as normal. When rating a batch, terms that can rate
+	 * batches (cx_batch_rater) do so across all the boards.
+	 *
+	 * When rating within a window the terms are rated in order, with the square by square
+	 * terms last, stopping once the terms left can't bring the rating back inside the window.
+	 * Cheap terms should come first, and terms that can bound their rating (cx_bounded_rater)
+	 * should do so, a term without a bound stops any early exit until it has been rated.
+	 *
+	 * @tparam RaterTs Terms to sum
+	*/
+	template <cx_board_rater... RaterTs>
+	class BoardRater_Fused
+	{
+	public:
+
+		/**
+		 * @brief True if any term rates square by square
+		*/
+		constexpr static bool has_square_terms_v = (cx_square_rater<RaterTs> || ...);
+
+		/**
+		 * @brief Rates the board as the sum of the terms
+		 * @param _context Context for the board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Total rating
+		*/
+		Rating rate(const RatingContext& _context, Color _player) const
+		{
+			return this->rate_terms<false>(_context, _player);
+		};
+
+		/**
+		 * @brief Rates the board as the sum of the terms
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Total rating
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return this->rate(RatingContext{ _board }, _player);
+		};
+
+		/**
+		 * @brief Rates the board as the sum of the terms, stopping early once it is known to be outside a window
+		 * @param _context Context for the board to rate
+		 * @param _player Player whose POV to rate from
+		 * @param _window Ratings the caller cares about
+		 * @param _stats Optional counts to add to
+		 * @return Total rating if inside the window, otherwise a bound on the same side of the window
+		*/
+		Rating rate(const RatingContext& _context, Color _player, RatingWindow _window, LazyEvalStats* _stats = nullptr) const
+		{
+			return this->rate_lazy(_context, _player, _window, _stats, std::index_sequence_for<RaterTs...>{});
+		};
+
+		/**
+		 * @brief Rates the board as the sum of the terms, stopping early once it is known to be outside a window
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @param _window Ratings the caller cares about
+		 * @param _stats Optional counts to add to
+		 * @return Total rating if inside the window, otherwise a bound on the same side of the window
+		*/
+		Rating rate(const BoardWithState& _board, Color _player, RatingWindow _window, LazyEvalStats* _stats = nullptr) const
+		{
+			return this->rate(RatingContext{ _board }, _player, _window, _stats);
+		};
+
+		/**
+		 * @brief Rates many boards as the sum of the terms
+		 * @param _boards Boards to rate
+		 * @param _player Player whose POV to rate from
+		 * @param _out Where to write the ratings, must be at least as long as _boards
+		*/
+		void rate_batch(std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out) const
+		{
+			JCLIB_ASSERT(_out.size() >= _boards.size());
+			for (size_t n = 0; n != _boards.size(); ++n)
+			{
+				_out[n] = this->rate_terms<true>(RatingContext{ _boards[n] }, _player);
+			};
+			std::apply([&](const auto&... _terms)
+				{
+					(impl::add_fused_batch_term(_terms, _boards, _player, _out), ...);
+				}, this->terms_);
+		};
+
+		/**
+		 * @brief Gets one of the terms
+		 * @tparam N Index of the term
+		 * @return Reference to the term
+		*/
+		template <size_t N>
+		constexpr auto& get() noexcept { return std::get<N>(this->terms_); };
+
+		/**
+		 * @brief Gets one of the terms
+		 * @tparam N Index of the term
+		 * @return Reference to the term
+		*/
+		template <size_t N>
+		constexpr const auto& get() const noexcept { return std::get<N>(this->terms_); };
+
+		constexpr BoardRater_Fused() = default;
+		constexpr explicit BoardRater_Fused(RaterTs... _terms) :
+			terms_{ std::move(_terms)... }
+		{};
+
+	private:
+
+		/**
+		 * @brief Rates the terms in order, stopping once the terms left can't bring the rating back into the window
+		*/
+		template <size_t... Is>
+		Rating rate_lazy(const RatingContext& _context, Color _player, RatingWindow _window, LazyEvalStats* _stats,
+			std::index_sequence<Is...>) const
+		{
+			// Square terms are rated together in one pass at the end
+			const std::array<int64_t, sizeof...(RaterTs)> _bounds
+			{
+				impl::fused_term_bound(std::get<Is>(this->terms_), _context)...
+			};
+			int64_t _remaining = (int64_t{ 0 } + ... + _bounds[Is]);
+			int64_t _sum = 0;
+			bool _exited = false;
+
+			const auto _outside = [&]() -> bool
+			{
+				_exited = (_sum + _remaining <= _window.alpha) || (_sum - _remaining >= _window.beta);
+				return _exited;
+			};
+			const auto _rateTerm = [&](const auto& _term, int64_t _bound) -> bool
+			{
+				if constexpr (cx_square_rater<std::remove_cvref_t<decltype(_term)>>)
+				{
+					return true;
+				}
+				else
+				{
+					if (_outside())
+					{
+						return false;
+					};
+					_sum += impl::rate_fused_term<false>(_term, _context, _player);
+					_remaining -= _bound;
+					return true;
+				};
+			};
+
+			if ((_rateTerm(std::get<Is>(this->terms_), _bounds[Is]) && ...) && !(has_square_terms_v && _outside()))
+			{
+				_sum += this->rate_squares(_context, _player);
+			};
+
+			if (_stats)
+			{
+				++_stats->evaluations;
+				_stats->lazy_exits += _exited;
+			};
+			if (_exited)
+			{
+				_sum += (_sum + _remaining <= _window.alpha) ? _remaining : -_remaining;
+			};
+			return static_cast<Rating>(std::clamp<int64_t>(_sum,
+				std::numeric_limits<Rating>::min(), std::numeric_limits<Rating>::max()));
+		};
+
+		/**
+		 * @brief Sums the square by square terms over the occupied squares
+		*/
+		Rating rate_squares(const RatingContext& _context, Color _player) const
+		{
+			Rating _sum = 0;
+			if constexpr (has_square_terms_v)
+			{
+				const auto& _board = _context.board();
+				auto _bits = _board.as_bits_with_pieces();
+				while (_bits.any())
+				{
+					const auto _pos = _bits.pop_first();
+					const auto _piece = _board.get(_pos);
+					_sum += std::apply([&](const auto&... _terms)
+						{
+							return (Rating{ 0 } + ... + impl::rate_fused_square(_terms, _context, _pos, _piece, _player));
+						}, this->terms_);
+				};
+			};
+			return _sum;
+		};
+
+		/**
+		 * @brief Sums the terms for a single board
+		 * @tparam SkipBatchV If true, terms that rate batches are left out
+		*/
+		template <bool SkipBatchV>
+		Rating rate_terms(const RatingContext& _context, Color _player) const
+		{
+			return this->rate_squares(_context, _player) + std::apply([&](const auto&... _terms)
+				{
+					return (Rating{ 0 } + ... + impl::rate_fused_term<SkipBatchV>(_terms, _context, _player));
+				}, this->terms_);
+		};
+
+		std::tuple<RaterTs...> terms_;
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_FUSED_RATER_HPP
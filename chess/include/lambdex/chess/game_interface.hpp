@@ -10,8 +10,54 @@
 #include "move.hpp"
 #include "board.hpp"
 
+#include <chrono>
+#include <string>
+#include <optional>
+
 namespace lbx::chess
 {
+	/**
+	 * @brief Time left on each player's clock and what they gain per move
+	*/
+	struct GameClock
+	{
+		/**
+		 * @brief Time left on white's clock
+		*/
+		std::chrono::milliseconds white_time{};
+
+		/**
+		 * @brief Time left on black's clock
+		*/
+		std::chrono::milliseconds black_time{};
+
+		/**
+		 * @brief Time added to white's clock after each move
+		*/
+		std::chrono::milliseconds white_increment{};
+
+		/**
+		 * @brief Time added to black's clock after each move
+		*/
+		std::chrono::milliseconds black_increment{};
+
+		/**
+		 * @brief Gets the time left on a player's clock
+		*/
+		constexpr std::chrono::milliseconds time(Color _player) const noexcept
+		{
+			return (_player == Color::white) ? this->white_time : this->black_time;
+		};
+
+		/**
+		 * @brief Gets the time a player gains per move
+		*/
+		constexpr std::chrono::milliseconds increment(Color _player) const noexcept
+		{
+			return (_player == Color::white) ? this->white_increment : this->black_increment;
+		};
+	};
+
 	/**
 	 * @brief Interface for chess engines to interact with the game through
 	*/
@@ -57,6 +103,13 @@ namespace lbx::chess
 		*/
 		virtual std::string get_game_name() { return std::string{}; };
 
+		/**
+		 * @brief Optional method allowing the interface to provide the game clock
+		 * @return The clock as of the engine's turn, or nullopt if the game isn't timed or this is
+		 * unimplemented (default behavior).
+		*/
+		virtual std::optional<GameClock> get_clock() { return std::nullopt; };
+
 	protected:
 
 		// Disallow deletion through pointer to base
@@ -56,6 +56,230 @@ namespace lbx::chess
 
 
 
+	/**
+	 * @brief What kind of move a PackedMove is.
+	 *
+	 * Bit 2 is set for captures and bit 3 for promotions, the low two bits of a
+	 * promotion pick the piece.
+	*/
+	enum class MoveKind : uint8_t
+	{
+		quiet = 0,
+		double_pawn_push = 1,
+		king_castle = 2,
+		queen_castle = 3,
+		capture = 4,
+		en_passant = 5,
+
+		knight_promotion = 8,
+		bishop_promotion = 9,
+		rook_promotion = 10,
+		queen_promotion = 11,
+
+		knight_promotion_capture = 12,
+		bishop_promotion_capture = 13,
+		rook_promotion_capture = 14,
+		queen_promotion_capture = 15,
+	};
+
+	/**
+	 * @brief A move packed into 16 bits, 6 bits each for the from and to squares and 4 for the MoveKind.
+	 *
+	 * Converting to and from Move is lossless, though promotions are stored without a color
+	 * (apply_move() ignores it anyways). Moves converted straight from a Move only know if they
+	 * are a promotion, use pack_move() to get the other kinds from a board.
+	*/
+	class PackedMove
+	{
+	public:
+
+		/**
+		 * @brief Underlying integer type
+		*/
+		using value_type = uint16_t;
+
+	private:
+
+		constexpr static value_type to_shift = 6;
+		constexpr static value_type kind_shift = 12;
+		constexpr static value_type square_mask = 0b111111;
+
+		/**
+		 * @brief Promotion pieces in the order of the low bits of a promotion MoveKind
+		*/
+		constexpr static std::array<Piece, 4> promotion_pieces
+		{
+			Piece::knight, Piece::bishop, Piece::rook, Piece::queen
+		};
+
+		/**
+		 * @brief Gets the MoveKind bits for a promotion piece
+		 * @param _promotion Promotion piece, may be Piece::empty
+		 * @return Kind bits, quiet if there is no promotion
+		*/
+		constexpr static value_type promotion_kind(Piece _promotion) noexcept
+		{
+			switch (as_white(_promotion))
+			{
+			case Piece::knight:
+				return jc::to_underlying(MoveKind::knight_promotion);
+			case Piece::bishop:
+				return jc::to_underlying(MoveKind::bishop_promotion);
+			case Piece::rook:
+				return jc::to_underlying(MoveKind::rook_promotion);
+			case Piece::queen:
+				return jc::to_underlying(MoveKind::queen_promotion);
+			default:
+				JCLIB_ASSERT(_promotion == Piece::empty);
+				return jc::to_underlying(MoveKind::quiet);
+			};
+		};
+
+	public:
+
+		/**
+		 * @brief Gets the packed value
+		 * @return 16 bit packed move
+		*/
+		constexpr value_type get() const noexcept
+		{
+			return this->value_;
+		};
+
+		/**
+		 * @brief Gets the square the piece moves from
+		*/
+		constexpr PositionPair from() const noexcept
+		{
+			return PositionPair{ Position{ static_cast<Position::value_type>(this->value_ & square_mask) } };
+		};
+
+		/**
+		 * @brief Gets the square the piece moves to
+		*/
+		constexpr PositionPair to() const noexcept
+		{
+			return PositionPair{ Position{ static_cast<Position::value_type>((this->value_ >> to_shift) & square_mask) } };
+		};
+
+		/**
+		 * @brief Gets the kind of move
+		*/
+		constexpr MoveKind kind() const noexcept
+		{
+			return MoveKind(this->value_ >> kind_shift);
+		};
+
+		/**
+		 * @brief Checks if this move captures a piece, including en passant
+		*/
+		constexpr bool is_capture() const noexcept
+		{
+			return (jc::to_underlying(this->kind()) & 0b0100) != 0;
+		};
+
+		/**
+		 * @brief Checks if this move promotes a pawn
+		*/
+		constexpr bool is_promotion() const noexcept
+		{
+			return (jc::to_underlying(this->kind()) & 0b1000) != 0;
+		};
+
+		/**
+		 * @brief Checks if this move is a castle, the king's move is the one stored
+		*/
+		constexpr bool is_castle() const noexcept
+		{
+			return this->kind() == MoveKind::king_castle || this->kind() == MoveKind::queen_castle;
+		};
+
+		/**
+		 * @brief Gets the piece a pawn is promoted to
+		 * @return White promotion piece, or Piece::empty if this isn't a promotion
+		*/
+		constexpr Piece promotion() const noexcept
+		{
+			if (this->is_promotion())
+			{
+				return promotion_pieces[jc::to_underlying(this->kind()) & 0b0011];
+			}
+			else
+			{
+				return Piece::empty;
+			};
+		};
+
+		/**
+		 * @brief Unpacks into a move
+		 * @return Unpacked move
+		*/
+		constexpr Move unpack() const noexcept
+		{
+			return Move{ this->from(), this->to(), this->promotion() };
+		};
+
+		/**
+		 * @brief Allows implicit conversion to an unpacked move
+		*/
+		constexpr operator Move() const noexcept
+		{
+			return this->unpack();
+		};
+
+		constexpr bool operator==(const PackedMove& rhs) const noexcept = default;
+
+		/**
+		 * @brief Null move, a1 to a1
+		*/
+		constexpr PackedMove() noexcept = default;
+
+		/**
+		 * @brief Constructs from a previously packed value
+		 * @param _value Value returned by get()
+		*/
+		constexpr explicit PackedMove(value_type _value) noexcept :
+			value_{ _value }
+		{};
+
+		/**
+		 * @brief Packs a move
+		 * @param _from Square the piece moves from, must be on the board
+		 * @param _to Square the piece moves to, must be on the board
+		 * @param _kind Kind of move
+		*/
+		constexpr PackedMove(PositionPair _from, PositionPair _to, MoveKind _kind) noexcept :
+			value_
+			{
+				static_cast<value_type>(
+					Position{ _from }.get() |
+					(Position{ _to }.get() << to_shift) |
+					(jc::to_underlying(_kind) << kind_shift))
+			}
+		{
+			JCLIB_ASSERT(_from.good() && _to.good());
+		};
+
+		/**
+		 * @brief Packs a move, the kind is only set for promotions as the rest need a board
+		 * @param _move Move to pack, its squares must be on the board
+		*/
+		constexpr explicit PackedMove(const Move& _move) noexcept :
+			PackedMove{ _move.from, _move.to, MoveKind(promotion_kind(_move.promotion)) }
+		{};
+
+	private:
+		value_type value_ = 0;
+	};
+
+	static_assert(sizeof(PackedMove) == 2);
+	static_assert(PackedMove{ Move{ (File::e, Rank::r7), (File::e, Rank::r8), Piece::knight } }.unpack() ==
+		Move{ (File::e, Rank::r7), (File::e, Rank::r8), Piece::knight });
+	static_assert(PackedMove{ (File::e, Rank::r1), (File::g, Rank::r1), MoveKind::king_castle }.is_castle());
+	static_assert(PackedMove{ (File::d, Rank::r7), (File::c, Rank::r8), MoveKind::rook_promotion_capture }.promotion() == Piece::rook);
+
+
+
 
 	/**
 	 * @brief Array of positions with pseudo-dynamic sizing using an end sentinal
@@ -163,8 +387,8 @@ namespace lbx::chess
 				_value.promotion = Piece::bishop;
 				++_result.ptr;
 				break;
-			case 'k':
-				_value.promotion = Piece::king;
+			case 'n':
+				_value.promotion = Piece::knight;
 				++_result.ptr;
 				break;
 			default:
@@ -186,7 +410,62 @@ namespace lbx::chess
 		{
 			return _result;
 		};
-		return to_chars(_result.ptr, _end, _value.to);
+		_result = to_chars(_result.ptr, _end, _value.to);
+		if (_result.ec != std::errc{} || _value.promotion == Piece::empty)
+		{
+			return _result;
+		};
+
+		// Promotion suffix
+		if (_result.ptr == _end)
+		{
+			return std::to_chars_result{ _end, std::errc::value_too_large };
+		};
+		switch (as_white(_value.promotion))
+		{
+		case Piece::queen:
+			*_result.ptr = 'q';
+			break;
+		case Piece::rook:
+			*_result.ptr = 'r';
+			break;
+		case Piece::bishop:
+			*_result.ptr = 'b';
+			break;
+		case Piece::knight:
+			*_result.ptr = 'n';
+			break;
+		default:
+			return std::to_chars_result{ _result.ptr, std::errc::invalid_argument };
+		};
+		++_result.ptr;
+		return _result;
+	};
+
+	/**
+	 * @brief Reads a UCI move string, the kind is only set for promotions
+	*/
+	inline std::from_chars_result from_chars(const char* _begin, const char* _end, PackedMove& _value)
+	{
+		Move _move{};
+		const auto _result = from_chars(_begin, _end, _move);
+		if (_result.ec == std::errc{})
+		{
+			_value = PackedMove{ _move };
+		};
+		return _result;
+	};
+	inline std::from_chars_result from_chars(std::string_view _str, PackedMove& _value)
+	{
+		return from_chars(_str.data(), _str.data() + _str.size(), _value);
+	};
+
+	/**
+	 * @brief Writes a move as a UCI move string
+	*/
+	inline std::to_chars_result to_chars(char* _begin, char* _end, const PackedMove& _value)
+	{
+		return to_chars(_begin, _end, _value.unpack());
 	};
 
 	/**
@@ -195,7 +474,7 @@ namespace lbx::chess
 	*/
 	inline std::string Move::to_string() const
 	{
-		std::string _buffer(4, '\0');
+		std::string _buffer(5, '\0');
 		auto _result = to_chars(_buffer.data(), _buffer.data() + _buffer.size(), *this);
 		JCLIB_ASSERT(_result.ec == std::errc{});
 		_buffer.resize(_result.ptr - _buffer.data());
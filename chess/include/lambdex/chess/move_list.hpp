@@ -0,0 +1,176 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_MOVE_LIST_HPP
+#define LAMBDEX_CHESS_MOVE_LIST_HPP
+
+/*
+	Provides a fixed capacity list of moves that lives on the stack, so generating
+	moves for a node never touches the heap.
+*/
+
+#include "move.hpp"
+
+#include <span>
+#include <array>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Fixed capacity list of moves, each with a score that can be used for ordering
+	*/
+	class MoveList
+	{
+	public:
+
+		// Standard container aliases
+
+		using value_type = Move;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using const_pointer = const value_type*;
+		using const_reference = const value_type&;
+
+		using iterator = pointer;
+		using const_iterator = const_pointer;
+
+		using size_type = size_t;
+
+		/**
+		 * @brief Type used for move scores, higher is better
+		*/
+		using score_type = int;
+
+		/**
+		 * @brief Maximum number of moves, no legal position has more than 218
+		*/
+		constexpr static size_type capacity_v = 256;
+
+		constexpr static size_type capacity() noexcept { return capacity_v; };
+		constexpr size_type size() const noexcept { return this->size_; };
+		constexpr bool empty() const noexcept { return this->size_ == 0; };
+
+		constexpr pointer data() noexcept { return this->moves_.data(); };
+		constexpr const_pointer data() const noexcept { return this->moves_.data(); };
+
+		constexpr iterator begin() noexcept { return this->data(); };
+		constexpr const_iterator begin() const noexcept { return this->data(); };
+		constexpr const_iterator cbegin() const noexcept { return this->data(); };
+
+		constexpr iterator end() noexcept { return this->data() + this->size(); };
+		constexpr const_iterator end() const noexcept { return this->data() + this->size(); };
+		constexpr const_iterator cend() const noexcept { return this->data() + this->size(); };
+
+		constexpr reference operator[](size_type _index) noexcept
+		{
+			JCLIB_ASSERT(_index < this->size());
+			return this->moves_[_index];
+		};
+		constexpr const_reference operator[](size_type _index) const noexcept
+		{
+			JCLIB_ASSERT(_index < this->size());
+			return this->moves_[_index];
+		};
+
+		constexpr reference at(size_type _index) noexcept { return (*this)[_index]; };
+		constexpr const_reference at(size_type _index) const noexcept { return (*this)[_index]; };
+
+		constexpr reference front() noexcept { return (*this)[0]; };
+		constexpr const_reference front() const noexcept { return (*this)[0]; };
+
+		/**
+		 * @brief Gets the score for a move
+		 * @param _index Index of the move
+		 * @return Score value
+		*/
+		constexpr score_type score(size_type _index) const noexcept
+		{
+			JCLIB_ASSERT(_index < this->size());
+			return this->scores_[_index];
+		};
+
+		/**
+		 * @brief Sets the score for a move
+		 * @param _index Index of the move
+		 * @param _score Score value
+		*/
+		constexpr void set_score(size_type _index, score_type _score) noexcept
+		{
+			JCLIB_ASSERT(_index < this->size());
+			this->scores_[_index] = _score;
+		};
+
+		/**
+		 * @brief Adds a move to the end of the list, the list MUST NOT BE FULL
+		 * @param _move Move to add
+		 * @param _score Score for the move
+		*/
+		constexpr void push_back(const Move& _move, score_type _score = 0) noexcept
+		{
+			JCLIB_ASSERT(this->size() != this->capacity());
+			this->moves_[this->size_] = _move;
+			this->scores_[this->size_] = _score;
+			++this->size_;
+		};
+
+		/**
+		 * @brief Removes all moves
+		*/
+		constexpr void clear() noexcept
+		{
+			this->size_ = 0;
+		};
+
+		/**
+		 * @brief Gets the whole backing buffer so a generator can write into it, follow up with resize()
+		 * @return Span over the full capacity
+		*/
+		constexpr std::span<Move, capacity_v> storage() noexcept
+		{
+			return std::span<Move, capacity_v>{ this->moves_ };
+		};
+
+		/**
+		 * @brief Sets the number of moves held, any new moves have a score of 0
+		 * @param _size New size, must not exceed the capacity
+		*/
+		constexpr void resize(size_type _size) noexcept
+		{
+			JCLIB_ASSERT(_size <= this->capacity());
+			if (_size > this->size_)
+			{
+				std::fill(this->scores_.begin() + this->size_, this->scores_.begin() + _size, score_type{});
+			};
+			this->size_ = _size;
+		};
+
+		/**
+		 * @brief Sorts the moves from highest to lowest score, moves with equal scores keep their order
+		*/
+		constexpr void sort_by_score() noexcept
+		{
+			// Insertion sort, lists are short and usually close to sorted
+			for (size_type i = 1; i < this->size_; ++i)
+			{
+				const auto _move = this->moves_[i];
+				const auto _score = this->scores_[i];
+				auto j = i;
+				for (; j != 0 && this->scores_[j - 1] < _score; --j)
+				{
+					this->moves_[j] = this->moves_[j - 1];
+					this->scores_[j] = this->scores_[j - 1];
+				};
+				this->moves_[j] = _move;
+				this->scores_[j] = _score;
+			};
+		};
+
+		constexpr MoveList() noexcept = default;
+
+	private:
+		std::array<Move, capacity_v> moves_{};
+		std::array<score_type, capacity_v> scores_{};
+		size_type size_ = 0;
+	};
+};
+
+#endif // LAMBDEX_CHESS_MOVE_LIST_HPP
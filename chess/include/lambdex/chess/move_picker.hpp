@@ -0,0 +1,121 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_MOVE_PICKER_HPP
+#define LAMBDEX_CHESS_MOVE_PICKER_HPP
+
+/*
+	Provides a legal move generator that hands out moves one at a time in stages, so
+	a search that cuts off early never generates the moves it doesn't look at.
+*/
+
+#include "move.hpp"
+#include "board/board_with_state.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Gets the most valuable victim / least valuable attacker score for a move.
+	 *
+	 * Higher scores should be searched first. Promotions count the promoted piece
+	 * as part of the victim, and en passant captures a pawn.
+	 *
+	 * @param _board Board the move will be made on
+	 * @param _move Capture or promotion
+	 * @return Ordering score
+	*/
+	int mvv_lva_score(const BoardWithState& _board, const Move& _move);
+
+	/**
+	 * @brief Yields the legal moves for the player who's turn it is in stages.
+	 *
+	 * The best move (ie. from a previous search) comes first if it is legal, then
+	 * captures and promotions in MVV-LVA order, then the quiet moves. Each stage is
+	 * only generated once the previous one runs out. The best move is not repeated.
+	 *
+	 * The board must outlive the picker and must not change while it is in use.
+	*/
+	class MovePicker
+	{
+	public:
+
+		/**
+		 * @brief The stages moves are picked in
+		*/
+		enum class Stage : uint8_t
+		{
+			best_move,
+			generate_captures,
+			captures,
+			generate_quiets,
+			quiets,
+			done,
+		};
+
+		/**
+		 * @brief Gets the next move
+		 * @return Next move, or nullopt once every legal move has been picked
+		*/
+		std::optional<Move> next();
+
+		/**
+		 * @brief Gets the stage the picker is in, mostly useful for testing
+		 * @return Current stage
+		*/
+		Stage stage() const noexcept
+		{
+			return this->stage_;
+		};
+
+		/**
+		 * @brief Constructs the picker without a best move
+		 * @param _board Board to pick moves for
+		*/
+		explicit MovePicker(const BoardWithState& _board) noexcept;
+
+		/**
+		 * @brief Constructs the picker
+		 * @param _board Board to pick moves for
+		 * @param _bestMove Move to try first, ignored if it isn't legal
+		*/
+		MovePicker(const BoardWithState& _board, const Move& _bestMove) noexcept;
+
+	private:
+
+		/**
+		 * @brief Checks if the best move can be played, it may come from a different position
+		*/
+		bool is_best_move_legal() const;
+
+		/**
+		 * @brief Picks the highest scored move left in the buffer
+		*/
+		std::optional<Move> pick_best_scored();
+
+		/**
+		 * @brief Picks the next move left in the buffer in the order it was generated
+		*/
+		std::optional<Move> pick_in_order();
+
+		const BoardWithState* board_;
+		std::optional<Move> best_move_;
+
+		/**
+		 * @brief Moves generated for the current stage
+		*/
+		std::array<Move, 256> moves_;
+
+		/**
+		 * @brief Ordering score for each generated capture
+		*/
+		std::array<int, 256> scores_;
+
+		size_t count_ = 0;
+		size_t index_ = 0;
+		Stage stage_ = Stage::best_move;
+	};
+};
+
+#endif // LAMBDEX_CHESS_MOVE_PICKER_HPP
@@ -200,10 +200,24 @@ namespace lbx::chess
 
 
 	/**
-	 * @brief Determines if a piece is being immediately threatened by an enemy piece
+	 * @brief Determines if a piece is being immediately threatened by an enemy piece.
+	 * 
+	 * Use square_attacked_by() from attacks.hpp to get every attacker.
+	 * 
+	 * @param _board Board to check on
+	 * @param _position Position of the piece to check for threat
+	 * @return Position of an enemy piece that is directly threatening this piece, or nullopt if there isnt one
+	*/
+	std::optional<PositionPair> is_piece_threatened(const BoardWithState& _board, PositionPair _position);
+
+	/**
+	 * @brief Determines if a piece is being immediately threatened by an enemy piece.
+	 * 
+	 * Prefer the BoardWithState overload, this one has to build the bit boards first.
+	 * 
 	 * @param _board Board to check on
 	 * @param _position Position of the piece to check for threat
-	 * @return Position of the enemy piece that is directly threatening this piece, or nullopt if there isnt one
+	 * @return Position of an enemy piece that is directly threatening this piece, or nullopt if there isnt one
 	*/
 	std::optional<PositionPair> is_piece_threatened(const PieceBoard& _board, PositionPair _position);
 
@@ -0,0 +1,147 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_PARALLEL_SEARCH_HPP
+#define LAMBDEX_CHESS_PARALLEL_SEARCH_HPP
+
+/*
+	Provides a Lazy SMP parallel search, several threads search the same position and
+	only share what they find through a transposition table.
+*/
+
+#include "search.hpp"
+#include "transposition_table.hpp"
+
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Lazy SMP search using several threads.
+	 *
+	 * The calling thread runs the main search while helper threads search the same root,
+	 * every other helper starting a depth ahead so the threads drift apart instead of
+	 * walking the same nodes in step. The threads don't talk to each other, a helper is only
+	 * useful through the results it leaves in the shared transposition table for the others
+	 * to cut off on. Once the main search finishes the helpers are told to stop.
+	 *
+	 * Each thread's search state lives on its own cache lines so the threads don't slow each
+	 * other down through false sharing.
+	 *
+	 * @tparam RaterT Board rater, rates from the POV of the player given
+	*/
+	template <cx_board_rater RaterT>
+	class ParallelSearcher
+	{
+	public:
+
+		/**
+		 * @brief Searches a position one depth at a time until the time budget runs out, see Searcher::search()
+		 * @param _board Board to search, it is copied
+		 * @param _maxDepth Deepest depth to search to, at least 1
+		 * @param _budget Time the search may take
+		 * @param _threads Threads to search with this time, the calling thread included, clamped to [1, thread_count()]
+		 * @return Result from whichever thread completed the deepest depth, stats are summed over every thread used
+		*/
+		SearchResult search(const BoardWithState& _board, int _maxDepth, const TimeBudget& _budget,
+			size_t _threads = std::numeric_limits<size_t>::max())
+		{
+			this->stop_.store(false, std::memory_order_relaxed);
+			_threads = std::clamp<size_t>(_threads, 1, this->threads_.size());
+
+			std::vector<std::thread> _helpers{};
+			_helpers.reserve(_threads - 1);
+			for (size_t n = 1; n < _threads; ++n)
+			{
+				_helpers.emplace_back([this, &_board, _maxDepth, &_budget, n]()
+				{
+					auto& _thread = this->threads_[n];
+					const auto _firstDepth = std::min(1 + static_cast<int>(n % 2), _maxDepth);
+					_thread.result = _thread.searcher.search(_board, _maxDepth, _budget, _firstDepth);
+				});
+			};
+
+			auto& _main = this->threads_.front();
+			_main.result = _main.searcher.search(_board, _maxDepth, _budget);
+
+			this->stop_.store(true, std::memory_order_relaxed);
+			for (auto& _helper : _helpers)
+			{
+				_helper.join();
+			};
+
+			SearchResult _out = _main.result;
+			for (size_t n = 1; n < _threads; ++n)
+			{
+				const auto& _result = this->threads_[n].result;
+				if (_result.best_move && _result.depth > _out.depth)
+				{
+					_out.best_move = _result.best_move;
+					_out.rating = _result.rating;
+					_out.depth = _result.depth;
+				};
+				_out.stats += _result.stats;
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Gets the most threads a search can use, the calling thread included
+		*/
+		size_t thread_count() const noexcept
+		{
+			return this->threads_.size();
+		};
+
+		/**
+		 * @brief Constructs the searcher
+		 * @param _table Table shared by the threads, must outlive this
+		 * @param _threads Most threads to search with, the calling thread included, at least 1
+		 * @param _rater Board rater, copied for each thread
+		*/
+		ParallelSearcher(TranspositionTable& _table, size_t _threads, const RaterT& _rater = RaterT{}) :
+			threads_{}
+		{
+			JCLIB_ASSERT(_threads >= 1);
+			this->threads_.reserve(_threads);
+			for (size_t n = 0; n != _threads; ++n)
+			{
+				this->threads_.emplace_back(_table, _rater);
+				if (n != 0)
+				{
+					this->threads_.back().searcher.set_stop_signal(&this->stop_);
+				};
+			};
+		};
+
+		ParallelSearcher(const ParallelSearcher&) = delete;
+		ParallelSearcher& operator=(const ParallelSearcher&) = delete;
+
+	private:
+
+		/**
+		 * @brief State for one thread, aligned so no two threads share a cache line
+		*/
+		struct alignas(64) Thread
+		{
+			Searcher<RaterT> searcher;
+			SearchResult result{};
+
+			Thread(TranspositionTable& _table, const RaterT& _rater) :
+				searcher{ _table, _rater }
+			{};
+		};
+
+		std::vector<Thread> threads_;
+
+		/**
+		 * @brief Raised once the main search finishes to stop the helpers
+		*/
+		alignas(64) std::atomic<bool> stop_{ false };
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_PARALLEL_SEARCH_HPP
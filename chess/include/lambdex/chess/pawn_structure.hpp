@@ -0,0 +1,236 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_PAWN_STRUCTURE_HPP
+#define LAMBDEX_CHESS_PAWN_STRUCTURE_HPP
+
+/*
+	Provides pawn structure evaluation (doubled, isolated and passed pawns) along with a
+	hash table to cache it by pawn key, as the pawns change far less often than the rest
+	of the board.
+*/
+
+#include "evaluation.hpp"
+#include "board/bit_board.hpp"
+#include "board/board_with_state.hpp"
+
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+namespace lbx::chess
+{
+	namespace impl
+	{
+		consteval std::array<std::array<BitBoard, 64>, 2> make_passed_pawn_masks()
+		{
+			std::array<std::array<BitBoard, 64>, 2> _out{};
+			for (int s = 0; s != 64; ++s)
+			{
+				const int _file = s % 8;
+				const int _rank = s / 8;
+				for (int f = std::max(_file - 1, 0); f <= std::min(_file + 1, 7); ++f)
+				{
+					for (int r = _rank + 1; r < 8; ++r)
+					{
+						_out[0][s].set(static_cast<BitBoard::size_type>(r * 8 + f));
+					};
+					for (int r = _rank - 1; r >= 0; --r)
+					{
+						_out[1][s].set(static_cast<BitBoard::size_type>(r * 8 + f));
+					};
+				};
+			};
+			return _out;
+		};
+	};
+
+	/**
+	 * @brief Squares that must be free of enemy pawns for a pawn to be passed, indexed by color then square
+	 *
+	 * Covers the pawn's file and both neighbouring files, from the square in front of the pawn
+	 * to the far side of the board.
+	*/
+	constexpr inline auto passed_pawn_masks = impl::make_passed_pawn_masks();
+
+	/**
+	 * @brief Rating weights for pawn structure terms
+	*/
+	struct PawnStructureWeights
+	{
+		/**
+		 * @brief Penalty for each pawn past the first on a file
+		*/
+		Rating doubled = -10;
+
+		/**
+		 * @brief Penalty for each pawn without friendly pawns on neighbouring files
+		*/
+		Rating isolated = -15;
+
+		/**
+		 * @brief Bonus for a passed pawn by rank, counted from the owner's side
+		*/
+		std::array<Rating, 8> passed{ 0, 5, 10, 20, 35, 60, 100, 0 };
+	};
+
+	/**
+	 * @brief Evaluated pawn structure
+	*/
+	struct PawnStructure
+	{
+		/**
+		 * @brief Pawn structure score of each player, indexed by color
+		*/
+		std::array<Rating, 2> score{};
+
+		/**
+		 * @brief Squares holding each player's passed pawns, indexed by color
+		*/
+		std::array<BitBoard, 2> passed{};
+	};
+
+	/**
+	 * @brief Evaluates the pawn structure from scratch
+	 * @param _board Board to evaluate
+	 * @param _weights Rating weights
+	 * @return Pawn structure
+	*/
+	PawnStructure evaluate_pawn_structure(const BoardWithState& _board, const PawnStructureWeights& _weights = PawnStructureWeights{});
+
+	/**
+	 * @brief Hit and miss counts for a pawn hash table
+	*/
+	struct PawnHashStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+
+	/**
+	 * @brief Fixed size table of pawn structures keyed by BoardWithState::pawn_key().
+	 *
+	 * Entries are replaced on collision. This is not thread safe, each thread should have
+	 * its own table, they stay small as there are few pawn structures in a search.
+	*/
+	class PawnHashTable
+	{
+	public:
+
+		/**
+		 * @brief Gets the pawn structure for a board, evaluating and storing it on a miss
+		 * @param _board Board to get pawn structure of
+		 * @return Pawn structure, valid until the next call
+		*/
+		const PawnStructure& probe(const BoardWithState& _board)
+		{
+			const auto _key = _board.pawn_key();
+			auto& _entry = this->entries_[_key & this->mask_];
+			if (_entry.key == _key && _entry.filled)
+			{
+				++this->stats_.hits;
+			}
+			else
+			{
+				++this->stats_.misses;
+				_entry.key = _key;
+				_entry.filled = true;
+				_entry.structure = evaluate_pawn_structure(_board, this->weights_);
+			};
+			return _entry.structure;
+		};
+
+		/**
+		 * @brief Gets the hit and miss counts since construction
+		*/
+		const PawnHashStats& stats() const noexcept
+		{
+			return this->stats_;
+		};
+
+		/**
+		 * @brief Gets the weights used to evaluate pawn structures
+		*/
+		const PawnStructureWeights& weights() const noexcept
+		{
+			return this->weights_;
+		};
+
+		/**
+		 * @brief Gets the number of entries in the table
+		*/
+		size_t size() const noexcept
+		{
+			return this->mask_ + 1;
+		};
+
+		/**
+		 * @brief Allocates the table
+		 * @param _entries Number of entries, rounded down to a power of two
+		 * @param _weights Weights used to evaluate pawn structures
+		*/
+		explicit PawnHashTable(size_t _entries = 1 << 14, PawnStructureWeights _weights = PawnStructureWeights{});
+
+	private:
+
+		struct Entry
+		{
+			ZobristKey key = 0;
+			bool filled = false;
+			PawnStructure structure{};
+		};
+
+		std::unique_ptr<Entry[]> entries_;
+		size_t mask_ = 0;
+		PawnStructureWeights weights_;
+		PawnHashStats stats_{};
+	};
+
+	/**
+	 * @brief Rates a board by doubled, isolated and passed pawns.
+	 *
+	 * Looks the pawn structure up in a PawnHashTable if one is given, otherwise it is
+	 * evaluated every time.
+	*/
+	struct BoardRater_PawnStructure
+	{
+	public:
+
+		/**
+		 * @brief Optional table to cache pawn structures in, must only be used by one thread
+		*/
+		PawnHashTable* table = nullptr;
+
+		/**
+		 * @brief Rates the board by its pawn structure
+		 * @param _board Board to rate
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			if (this->table)
+			{
+				return rate(this->table->probe(_board), _player);
+			}
+			else
+			{
+				return rate(evaluate_pawn_structure(_board), _player);
+			};
+		};
+
+		/**
+		 * @brief Rates an evaluated pawn structure
+		 * @param _structure Pawn structure
+		 * @param _player Player whose POV to rate from
+		 * @return Rating
+		*/
+		constexpr static Rating rate(const PawnStructure& _structure, Color _player) noexcept
+		{
+			return _structure.score[jc::to_underlying(_player)] - _structure.score[jc::to_underlying(!_player)];
+		};
+	};
+	static_assert(cx_board_rater<BoardRater_PawnStructure>);
+
+};
+
+#endif // LAMBDEX_CHESS_PAWN_STRUCTURE_HPP
@@ -11,8 +11,7 @@
 #include "board/board_with_state.hpp"
 
 #include "move.hpp"
-
-#include  <lambdex/utility/arena.hpp>
+#include "move_list.hpp"
 
 namespace lbx::chess
 {
@@ -368,6 +367,62 @@ namespace lbx::chess
 		return _out;
 	};
 
+	/**
+	 * @brief Subsets of the legal moves that can be generated
+	*/
+	enum class MoveGenType : uint8_t
+	{
+		/**
+		 * @brief Captures, en passant and promotions
+		*/
+		captures,
+
+		/**
+		 * @brief Every other move, including castling
+		*/
+		quiets,
+
+		/**
+		 * @brief All legal moves
+		*/
+		all,
+	};
+
+	/**
+	 * @brief Generates the legal moves for the player who's turn it is.
+	 * 
+	 * Pins and checks are worked out once for the position so no move needs to be
+	 * applied to a copy of the board to see if it leaves the king in check. Pawns
+	 * reaching the back rank produce one move for each promotion piece.
+	 * 
+	 * If the buffer fills up the remaining moves are dropped.
+	 * 
+	 * @tparam Type Which subset of the legal moves to generate
+	 * @param _board Chess board with state.
+	 * @param _moveBuffer Output variable for where to write the found moves to.
+	 * 
+	 * @return Number of moves written.
+	*/
+	template <MoveGenType Type = MoveGenType::all>
+	size_t generate_legal_moves(const BoardWithState& _board, std::span<Move> _moveBuffer);
+
+	extern template size_t generate_legal_moves<MoveGenType::captures>(const BoardWithState&, std::span<Move>);
+	extern template size_t generate_legal_moves<MoveGenType::quiets>(const BoardWithState&, std::span<Move>);
+	extern template size_t generate_legal_moves<MoveGenType::all>(const BoardWithState&, std::span<Move>);
+
+	/**
+	 * @brief Checks if a move is one of the moves generate_legal_moves() would give.
+	 * 
+	 * Meant for moves that come from somewhere other than the generator, like a
+	 * transposition table. Nothing is applied to a copy of the board.
+	 * 
+	 * @param _board Chess board with state.
+	 * @param _move Move for the player who's turn it is.
+	 * 
+	 * @return True if the move is legal.
+	*/
+	bool is_move_legal(const BoardWithState& _board, const Move& _move);
+
 	/**
 	 * @brief Finds all possible moves for a given chess board.
 	 * 
@@ -389,9 +444,9 @@ namespace lbx::chess
 	 *
 	 * @param _board Chess board with state.
 	 *
-	 * @return Vector containing moves found.
+	 * @return List containing moves found, scores are left at 0.
 	*/
-	lbx::arena<Move> find_possible_moves(const BoardWithState& _board);
+	MoveList find_possible_moves(const BoardWithState& _board);
 
 };
 
@@ -0,0 +1,635 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_SEARCH_HPP
+#define LAMBDEX_CHESS_SEARCH_HPP
+
+/*
+	Provides a depth first negamax alpha-beta search. The search makes and unmakes moves on
+	a single board and only keeps the current line on the stack, so memory use doesn't grow
+	with the size of the tree. Searches can be run to a fixed depth or iteratively deepened
+	until a time budget runs out, optionally remembering results in a transposition table.
+*/
+
+#include "move.hpp"
+#include "evaluation.hpp"
+#include "apply_move.hpp"
+#include "move_picker.hpp"
+#include "time_management.hpp"
+#include "transposition_table.hpp"
+#include "board/board_with_state.hpp"
+
+#include <span>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Rating for checkmating the opponent, less one for each ply it takes to get there
+	*/
+	constexpr inline Rating mate_rating_v = 1000000;
+
+	/**
+	 * @brief Deepest ply the search will go to, quiescence included
+	*/
+	constexpr inline int max_search_ply_v = 128;
+
+	/**
+	 * @brief Checks if a rating is a forced checkmate for either player
+	 * @param _rating Rating from a search
+	 * @return True if it is a checkmate rating
+	*/
+	constexpr inline bool is_mate_rating(Rating _rating) noexcept
+	{
+		return _rating >= mate_rating_v - max_search_ply_v || _rating <= -(mate_rating_v - max_search_ply_v);
+	};
+
+	/**
+	 * @brief Gets the moves the quiescence search looks at, captures and promotions that don't lose
+	 * material by static exchange, in MVV-LVA order
+	 * @param _board Board to get moves for
+	 * @param _moveBuffer Where to write the moves
+	 * @return Number of moves written
+	*/
+	size_t generate_quiescence_moves(const BoardWithState& _board, std::span<Move> _moveBuffer);
+
+	/**
+	 * @brief Picks how deep to search a board, deeper as the board gets simpler, see rate_complexity()
+	 * @param _board Board to pick a depth for
+	 * @return Search depth in plies
+	*/
+	size_t search_depth_for_board(const BoardWithState& _board);
+
+	/**
+	 * @brief Counts of what a search did
+	*/
+	struct SearchStats
+	{
+		/**
+		 * @brief Positions visited, quiescence included
+		*/
+		uint64_t nodes = 0;
+
+		/**
+		 * @brief Positions visited by the quiescence search
+		*/
+		uint64_t quiescence_nodes = 0;
+
+		/**
+		 * @brief Times a move was good enough to stop searching the rest at its node
+		*/
+		uint64_t beta_cutoffs = 0;
+
+		/**
+		 * @brief Deepest ply reached, quiescence included
+		*/
+		int max_ply = 0;
+
+		/**
+		 * @brief Windowed evaluations and how many of them exited early, see LazyEvalStats
+		*/
+		LazyEvalStats lazy_eval{};
+
+		/**
+		 * @brief Transposition table use, all zero if the searcher has no table
+		*/
+		TranspositionTableStats table{};
+
+		constexpr SearchStats& operator+=(const SearchStats& rhs) noexcept
+		{
+			this->nodes += rhs.nodes;
+			this->quiescence_nodes += rhs.quiescence_nodes;
+			this->beta_cutoffs += rhs.beta_cutoffs;
+			this->max_ply = std::max(this->max_ply, rhs.max_ply);
+			this->lazy_eval += rhs.lazy_eval;
+			this->table += rhs.table;
+			return *this;
+		};
+	};
+
+	/**
+	 * @brief Result of searching a position
+	*/
+	struct SearchResult
+	{
+		/**
+		 * @brief Best move found, nullopt if there are no legal moves
+		*/
+		std::optional<Move> best_move{};
+
+		/**
+		 * @brief Rating of the best move from the POV of the player whose turn it is
+		*/
+		Rating rating = 0;
+
+		/**
+		 * @brief Depth searched to, for iterative searches the last depth that was completed
+		*/
+		int depth = 0;
+
+		/**
+		 * @brief True if a depth was abandoned part way, because the hard limit passed or the stop signal was raised
+		*/
+		bool stopped = false;
+
+		/**
+		 * @brief What the search did
+		*/
+		SearchStats stats{};
+	};
+
+	/**
+	 * @brief Negamax alpha-beta search using a board rater.
+	 *
+	 * Searches depth first on a single board, making and unmaking moves as it goes. Moves
+	 * come from a MovePicker so captures are tried first and the rest are only generated
+	 * if no cutoff happens. At depth 0 a quiescence search plays out the captures that
+	 * don't lose material so the horizon doesn't fall in the middle of an exchange.
+	 *
+	 * Raters that take a window (cx_windowed_rater) are given the search's alpha and beta
+	 * so they can stop early. Each searcher must only be used by one thread at a time.
+	 *
+	 * When given a TranspositionTable the main search stores its results there, and uses
+	 * them to cut off positions already searched deep enough and to try the best move from
+	 * last time first. Quiescence nodes are not stored. The table is shared, so aging it
+	 * with TranspositionTable::new_search() is left to its owner.
+	 *
+	 * @tparam RaterT Board rater, rates from the POV of the player given
+	*/
+	template <cx_board_rater RaterT>
+	class Searcher
+	{
+	public:
+
+		/**
+		 * @brief Searches a position to a fixed depth
+		 * @param _board Board to search, it is copied
+		 * @param _depth Depth in plies, at least 1
+		 * @return Best move and its rating
+		*/
+		SearchResult search(const BoardWithState& _board, int _depth)
+		{
+			JCLIB_ASSERT(_depth >= 1);
+			this->board_ = _board;
+			this->stats_ = {};
+			this->deadline_.reset();
+			this->stopped_ = false;
+
+			SearchResult _out{};
+			this->search_root(_depth, _out);
+			return this->finish_search(_out);
+		};
+
+		/**
+		 * @brief Searches a position one depth at a time until the time budget runs out.
+		 *
+		 * No new depth is started once the soft limit has passed. Once the hard limit passes the
+		 * depth being searched is abandoned and the result of the last completed depth is returned.
+		 * The first depth always runs to completion so there is always a move if one exists,
+		 * unless the stop signal is raised.
+		 *
+		 * @param _board Board to search, it is copied
+		 * @param _maxDepth Deepest depth to search to, at least 1
+		 * @param _budget Time the search may take
+		 * @param _firstDepth Depth to start at, at least 1 and no more than _maxDepth
+		 * @return Best move and its rating from the last completed depth, depth 0 if none was completed
+		*/
+		SearchResult search(const BoardWithState& _board, int _maxDepth, const TimeBudget& _budget, int _firstDepth = 1)
+		{
+			using clock = std::chrono::steady_clock;
+
+			JCLIB_ASSERT(_firstDepth >= 1 && _firstDepth <= _maxDepth);
+			this->board_ = _board;
+			this->stats_ = {};
+			this->deadline_.reset();
+			this->stopped_ = false;
+
+			const auto _start = clock::now();
+			SearchResult _out{};
+			for (int _depth = _firstDepth; _depth <= _maxDepth; ++_depth)
+			{
+				if (_depth != _firstDepth && clock::now() - _start >= _budget.soft)
+				{
+					break;
+				};
+
+				// The previous best move is tried first so a cut off iteration can't lose it
+				SearchResult _iteration = _out;
+				if (!this->search_root(_depth, _iteration))
+				{
+					break;
+				};
+				_out = _iteration;
+
+				// Nothing more to find if there are no moves or a mate was found
+				if (!_out.best_move || is_mate_rating(_out.rating))
+				{
+					break;
+				};
+				this->deadline_ = _start + _budget.hard;
+			};
+
+			return this->finish_search(_out);
+		};
+
+		/**
+		 * @brief Gets the counts for the last search
+		*/
+		const SearchStats& stats() const noexcept
+		{
+			return this->stats_;
+		};
+
+		/**
+		 * @brief Gives the searcher a flag to watch, once it is set the search stops as if it ran out of time
+		 * @param _signal Flag to watch, must outlive any searches, nullptr to stop watching
+		*/
+		void set_stop_signal(const std::atomic<bool>* _signal) noexcept
+		{
+			this->stop_signal_ = _signal;
+		};
+
+		/**
+		 * @brief Gets the board rater
+		*/
+		const RaterT& rater() const noexcept
+		{
+			return this->rater_;
+		};
+
+		Searcher() = default;
+		explicit Searcher(RaterT _rater) :
+			rater_{ std::move(_rater) }
+		{};
+
+		/**
+		 * @brief Constructs a searcher that uses a transposition table
+		 * @param _table Table to use, must outlive this, may be shared with other searchers
+		 * @param _rater Board rater
+		*/
+		explicit Searcher(TranspositionTable& _table, RaterT _rater = RaterT{}) :
+			rater_{ std::move(_rater) },
+			table_{ &_table }
+		{};
+
+	private:
+
+		/**
+		 * @brief Searches every move at the root to a depth
+		 * @param _depth Depth in plies, at least 1
+		 * @param _out Result to write to, its best move is tried first if it has one
+		 * @return False if the search ran out of time, the result is left untouched
+		*/
+		bool search_root(int _depth, SearchResult& _out)
+		{
+			Rating _alpha = -mate_rating_v - 1;
+			const Rating _beta = mate_rating_v + 1;
+			Rating _best = _alpha;
+			std::optional<Move> _bestMove{};
+
+			// The table may still have the best move from an earlier search of this position
+			auto _firstMove = _out.best_move;
+			if (!_firstMove && this->table_)
+			{
+				if (const auto _entry = this->table_->probe(this->board_.zobrist_key()); _entry)
+				{
+					_firstMove = _entry->best_move();
+				};
+			};
+
+			++this->stats_.nodes;
+			MovePicker _picker = (_firstMove) ?
+				MovePicker{ this->board_, *_firstMove } :
+				MovePicker{ this->board_ };
+			while (const auto _move = _picker.next())
+			{
+				const auto _undo = make_move(this->board_, *_move);
+				const auto _rating = -this->negamax(_depth - 1, 1, -_beta, -_alpha);
+				unmake_move(this->board_, *_move, _undo);
+
+				if (this->stopped_)
+				{
+					return false;
+				};
+				if (_rating > _best)
+				{
+					_best = _rating;
+					_bestMove = *_move;
+					_alpha = std::max(_alpha, _rating);
+				};
+			};
+
+			_out.best_move = _bestMove;
+			_out.rating = (_bestMove) ? _best : this->rate_no_moves(0);
+			_out.depth = _depth;
+			this->store(_depth, 0, _out.rating, Bound::exact, _bestMove);
+			return true;
+		};
+
+		/**
+		 * @brief Fills in the stats for a finished search and hands the table counts to the table
+		*/
+		SearchResult& finish_search(SearchResult& _out)
+		{
+			if (this->table_)
+			{
+				this->table_->add_stats(this->stats_.table);
+			};
+			_out.stats = this->stats_;
+			_out.stopped = this->stopped_;
+			return _out;
+		};
+
+		/**
+		 * @brief Converts a rating to store in the transposition table, mates are made relative to the node
+		*/
+		constexpr static Rating rating_to_table(Rating _rating, int _ply) noexcept
+		{
+			if (_rating >= mate_rating_v - max_search_ply_v)
+			{
+				return _rating + _ply;
+			}
+			else if (_rating <= -(mate_rating_v - max_search_ply_v))
+			{
+				return _rating - _ply;
+			};
+			return _rating;
+		};
+
+		/**
+		 * @brief Converts a rating read from the transposition table back to one relative to the root
+		*/
+		constexpr static Rating rating_from_table(Rating _rating, int _ply) noexcept
+		{
+			if (_rating >= mate_rating_v - max_search_ply_v)
+			{
+				return _rating - _ply;
+			}
+			else if (_rating <= -(mate_rating_v - max_search_ply_v))
+			{
+				return _rating + _ply;
+			};
+			return _rating;
+		};
+
+		/**
+		 * @brief Stores the result for the board in the transposition table, if there is one
+		*/
+		void store(int _depth, int _ply, Rating _rating, Bound _bound, const std::optional<Move>& _bestMove)
+		{
+			if (this->table_)
+			{
+				const auto _move = (_bestMove) ? pack_move(this->board_, *_bestMove) : PackedMove{};
+				++this->stats_.table.stores;
+				if (this->table_->store(this->board_.zobrist_key(), _move, rating_to_table(_rating, _ply), _depth, _bound))
+				{
+					++this->stats_.table.collisions;
+				};
+			};
+		};
+
+		/**
+		 * @brief Checks if the search has passed its deadline or been signalled to stop, these are
+		 * only read every so many nodes
+		 * @return True if the search should stop
+		*/
+		bool out_of_time()
+		{
+			constexpr uint64_t nodes_per_check_v = 1024;
+			if (!this->stopped_ && this->stats_.nodes % nodes_per_check_v == 0)
+			{
+				this->stopped_ =
+					(this->deadline_ && std::chrono::steady_clock::now() >= *this->deadline_) ||
+					(this->stop_signal_ && this->stop_signal_->load(std::memory_order_relaxed));
+			};
+			return this->stopped_;
+		};
+
+		/**
+		 * @brief Rates a board where the player to move has no legal moves
+		*/
+		Rating rate_no_moves(int _ply) const
+		{
+			return (RatingContext{ this->board_ }.in_check()) ? -mate_rating_v + _ply : 0;
+		};
+
+		/**
+		 * @brief Rates the board for the player to move, giving windowed raters the search window
+		*/
+		Rating evaluate(Rating _alpha, Rating _beta)
+		{
+			const auto& _board = this->board_;
+			Rating _rating = 0;
+			if constexpr (requires { this->rater_.rate(_board, _board.turn, RatingWindow{}, &this->stats_.lazy_eval); })
+			{
+				_rating = this->rater_.rate(_board, _board.turn, RatingWindow{ _alpha, _beta }, &this->stats_.lazy_eval);
+			}
+			else if constexpr (cx_windowed_rater<RaterT>)
+			{
+				_rating = this->rater_.rate(_board, _board.turn, RatingWindow{ _alpha, _beta });
+			}
+			else
+			{
+				_rating = this->rater_.rate(_board, _board.turn);
+			};
+			return std::clamp(_rating, -mate_rating_v, mate_rating_v);
+		};
+
+		/**
+		 * @brief Searches the board to a depth, fail soft
+		 * @return Rating from the POV of the player to move
+		*/
+		Rating negamax(int _depth, int _ply, Rating _alpha, Rating _beta)
+		{
+			if (_depth <= 0)
+			{
+				return this->quiesce(_ply, _alpha, _beta);
+			};
+
+			++this->stats_.nodes;
+			this->stats_.max_ply = std::max(this->stats_.max_ply, _ply);
+			if (this->out_of_time())
+			{
+				return 0;
+			}
+			else if (_ply >= max_search_ply_v)
+			{
+				return this->evaluate(_alpha, _beta);
+			};
+
+			// A deep enough result from before may settle this node without searching it
+			std::optional<Move> _tableMove{};
+			if (this->table_)
+			{
+				++this->stats_.table.probes;
+				if (const auto _entry = this->table_->probe(this->board_.zobrist_key()); _entry)
+				{
+					++this->stats_.table.hits;
+					_tableMove = _entry->best_move();
+
+					const auto _rating = rating_from_table(_entry->rating, _ply);
+					if (_entry->depth >= _depth &&
+						(_entry->bound == Bound::exact ||
+						(_entry->bound == Bound::lower && _rating >= _beta) ||
+						(_entry->bound == Bound::upper && _rating <= _alpha)))
+					{
+						return _rating;
+					};
+				};
+			};
+
+			const auto _alphaStart = _alpha;
+			Rating _best = -mate_rating_v - 1;
+			std::optional<Move> _bestMove{};
+			MovePicker _picker = (_tableMove) ?
+				MovePicker{ this->board_, *_tableMove } :
+				MovePicker{ this->board_ };
+			while (const auto _move = _picker.next())
+			{
+				const auto _undo = make_move(this->board_, *_move);
+				const auto _rating = -this->negamax(_depth - 1, _ply + 1, -_beta, -_alpha);
+				unmake_move(this->board_, *_move, _undo);
+				if (this->stopped_)
+				{
+					return 0;
+				};
+
+				if (_rating > _best)
+				{
+					_best = _rating;
+					_bestMove = *_move;
+					if (_rating > _alpha)
+					{
+						_alpha = _rating;
+						if (_alpha >= _beta)
+						{
+							++this->stats_.beta_cutoffs;
+							break;
+						};
+					};
+				};
+			};
+
+			if (!_bestMove)
+			{
+				_best = this->rate_no_moves(_ply);
+				this->store(_depth, _ply, _best, Bound::exact, std::nullopt);
+			}
+			else if (_best <= _alphaStart)
+			{
+				// Every move failed low, none of them is known to be best
+				this->store(_depth, _ply, _best, Bound::upper, std::nullopt);
+			}
+			else
+			{
+				this->store(_depth, _ply, _best, (_best >= _beta) ? Bound::lower : Bound::exact, _bestMove);
+			};
+			return _best;
+		};
+
+		/**
+		 * @brief Plays out captures until the position is quiet, fail soft
+		 * @return Rating from the POV of the player to move
+		*/
+		Rating quiesce(int _ply, Rating _alpha, Rating _beta)
+		{
+			++this->stats_.nodes;
+			++this->stats_.quiescence_nodes;
+			this->stats_.max_ply = std::max(this->stats_.max_ply, _ply);
+			if (this->out_of_time())
+			{
+				return 0;
+			};
+
+			// Standing pat isn't allowed in check, every evasion is searched instead
+			if (RatingContext{ this->board_ }.in_check() && _ply < max_search_ply_v)
+			{
+				Rating _best = -mate_rating_v - 1;
+				MovePicker _picker{ this->board_ };
+				while (const auto _move = _picker.next())
+				{
+					const auto _undo = make_move(this->board_, *_move);
+					const auto _rating = -this->quiesce(_ply + 1, -_beta, -_alpha);
+					unmake_move(this->board_, *_move, _undo);
+					if (this->stopped_)
+					{
+						return 0;
+					};
+
+					_best = std::max(_best, _rating);
+					_alpha = std::max(_alpha, _rating);
+					if (_alpha >= _beta)
+					{
+						++this->stats_.beta_cutoffs;
+						break;
+					};
+				};
+				return (_best == -mate_rating_v - 1) ? -mate_rating_v + _ply : _best;
+			};
+
+			auto _best = this->evaluate(_alpha, _beta);
+			if (_best >= _beta || _ply >= max_search_ply_v)
+			{
+				return _best;
+			};
+			_alpha = std::max(_alpha, _best);
+
+			std::array<Move, 256> _moves;
+			const auto _count = generate_quiescence_moves(this->board_, _moves);
+			for (size_t n = 0; n != _count; ++n)
+			{
+				const auto _undo = make_move(this->board_, _moves[n]);
+				const auto _rating = -this->quiesce(_ply + 1, -_beta, -_alpha);
+				unmake_move(this->board_, _moves[n], _undo);
+				if (this->stopped_)
+				{
+					return 0;
+				};
+
+				_best = std::max(_best, _rating);
+				_alpha = std::max(_alpha, _rating);
+				if (_alpha >= _beta)
+				{
+					++this->stats_.beta_cutoffs;
+					break;
+				};
+			};
+			return _best;
+		};
+
+		/**
+		 * @brief Board moves are made and unmade on
+		*/
+		BoardWithState board_{};
+
+		RaterT rater_{};
+		SearchStats stats_{};
+
+		/**
+		 * @brief Optional transposition table, may be shared with other searchers
+		*/
+		TranspositionTable* table_ = nullptr;
+
+		/**
+		 * @brief When the current search has to stop by, nullopt for no limit
+		*/
+		std::optional<std::chrono::steady_clock::time_point> deadline_{};
+
+		/**
+		 * @brief Optional flag that stops the search once set, see set_stop_signal()
+		*/
+		const std::atomic<bool>* stop_signal_ = nullptr;
+
+		/**
+		 * @brief Set once the deadline passes or the stop signal is raised, everything searched after is thrown away
+		*/
+		bool stopped_ = false;
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_SEARCH_HPP
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_SEE_HPP
+#define LAMBDEX_CHESS_SEE_HPP
+
+/*
+	Provides static exchange evaluation, which plays out the captures on a single square
+	to find out if a move wins or loses material.
+*/
+
+#include "move.hpp"
+#include "evaluation.hpp"
+#include "board/piece_square.hpp"
+#include "board/board_with_state.hpp"
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Gets the value of a piece for static exchange evaluation, in centipawns
+	 * @param _piece Piece to get value of, either color
+	 * @return Value, the king is worth more than everything else put together
+	*/
+	constexpr inline Rating see_piece_value(Piece _piece) noexcept
+	{
+		switch (as_white(_piece))
+		{
+		case Piece::pawn:
+			return impl::pawn_value_v;
+		case Piece::knight:
+			return impl::knight_value_v;
+		case Piece::bishop:
+			return impl::bishop_value_v;
+		case Piece::rook:
+			return impl::rook_value_v;
+		case Piece::queen:
+			return impl::queen_value_v;
+		case Piece::king:
+			return 20000;
+		default:
+			return 0;
+		};
+	};
+
+	/**
+	 * @brief Works out the material won or lost by a move once the exchange on its square is played out.
+	 *
+	 * Both players recapture with their least valuable attacker and may stop whenever
+	 * carrying on would lose them material. Sliders lined up behind a capturing piece
+	 * join in as it leaves the square. Pins and promotions during the exchange are
+	 * ignored. Quiet moves give 0, or a loss if the piece is moved onto a square where
+	 * it can be taken for free. Castling always gives 0.
+	 *
+	 * @param _board Board the move will be made on
+	 * @param _move Legal move for the player whose turn it is
+	 * @return Material gained by the player making the move, in centipawns
+	*/
+	Rating see(const BoardWithState& _board, const Move& _move);
+
+	/**
+	 * @brief Checks if a move is a capture that loses material once the exchange is played out
+	 * @param _board Board the move will be made on
+	 * @param _move Legal move for the player whose turn it is
+	 * @return True if the move captures and see() gives a loss
+	*/
+	bool is_losing_capture(const BoardWithState& _board, const Move& _move);
+};
+
+#endif // LAMBDEX_CHESS_SEE_HPP
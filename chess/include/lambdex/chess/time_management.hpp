@@ -0,0 +1,50 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_TIME_MANAGEMENT_HPP
+#define LAMBDEX_CHESS_TIME_MANAGEMENT_HPP
+
+/*
+	Provides how long an engine should think about a move given the game clock.
+*/
+
+#include "game_interface.hpp"
+
+#include <chrono>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Time kept back from every move for network lag and move submission
+	*/
+	constexpr inline std::chrono::milliseconds move_overhead_v{ 100 };
+
+	/**
+	 * @brief How many more moves the time left on the clock is assumed to be shared between
+	*/
+	constexpr inline int expected_moves_left_v = 40;
+
+	/**
+	 * @brief How long a search may take for a single move
+	*/
+	struct TimeBudget
+	{
+		/**
+		 * @brief A new search iteration shouldn't be started once this much time has passed
+		*/
+		std::chrono::milliseconds soft{};
+
+		/**
+		 * @brief The search must stop once this much time has passed, even mid iteration
+		*/
+		std::chrono::milliseconds hard{};
+	};
+
+	/**
+	 * @brief Works out how long to think about the next move
+	 * @param _clock The game clock as of the player's turn
+	 * @param _player Player to budget for
+	 * @return Time budget, the hard limit is never more than half the time left on the clock
+	*/
+	TimeBudget budget_move_time(const GameClock& _clock, Color _player);
+};
+
+#endif // LAMBDEX_CHESS_TIME_MANAGEMENT_HPP
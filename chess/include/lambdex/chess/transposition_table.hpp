@@ -0,0 +1,329 @@
+#pragma once
+#ifndef LAMBDEX_CHESS_TRANSPOSITION_TABLE_HPP
+#define LAMBDEX_CHESS_TRANSPOSITION_TABLE_HPP
+
+/*
+	Provides a fixed size table of search results keyed by Zobrist key, safe to share
+	between threads without locking.
+*/
+
+#include "move.hpp"
+#include "evaluation.hpp"
+#include "board/zobrist.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief How a stored rating relates to the real rating of a position
+	*/
+	enum class Bound : uint8_t
+	{
+		/**
+		 * @brief Nothing stored
+		*/
+		none = 0,
+
+		/**
+		 * @brief Every move failed low, the real rating is at most the one stored
+		*/
+		upper = 1,
+
+		/**
+		 * @brief A move failed high, the real rating is at least the one stored
+		*/
+		lower = 2,
+
+		/**
+		 * @brief The stored rating is the real rating
+		*/
+		exact = 3,
+	};
+
+	/**
+	 * @brief A search result read back out of a transposition table
+	*/
+	struct TranspositionEntry
+	{
+		/**
+		 * @brief Best move found, zero if there wasn't one
+		*/
+		PackedMove move{};
+
+		/**
+		 * @brief Rating from the POV of the player to move
+		*/
+		Rating rating = 0;
+
+		/**
+		 * @brief Depth the position was searched to
+		*/
+		int depth = 0;
+
+		/**
+		 * @brief How the rating relates to the real rating
+		*/
+		Bound bound = Bound::none;
+
+		/**
+		 * @brief Age of the table when this was stored, see TranspositionTable::new_search()
+		*/
+		uint8_t age = 0;
+
+		/**
+		 * @brief Gets the best move if there was one
+		*/
+		constexpr std::optional<Move> best_move() const noexcept
+		{
+			if (this->move.get() == 0)
+			{
+				return std::nullopt;
+			};
+			return this->move.unpack();
+		};
+	};
+
+	/**
+	 * @brief Probe, hit, store and collision counts for a transposition table
+	*/
+	struct TranspositionTableStats
+	{
+		uint64_t probes = 0;
+		uint64_t hits = 0;
+		uint64_t stores = 0;
+
+		/**
+		 * @brief Stores that replaced a different position stored during the same search
+		*/
+		uint64_t collisions = 0;
+
+		/**
+		 * @brief Gets the fraction of probes that found their position
+		*/
+		constexpr double hit_rate() const noexcept
+		{
+			return (this->probes == 0) ? 0.0 : static_cast<double>(this->hits) / static_cast<double>(this->probes);
+		};
+
+		constexpr TranspositionTableStats& operator+=(const TranspositionTableStats& rhs) noexcept
+		{
+			this->probes += rhs.probes;
+			this->hits += rhs.hits;
+			this->stores += rhs.stores;
+			this->collisions += rhs.collisions;
+			return *this;
+		};
+	};
+
+	/**
+	 * @brief Fixed size table of search results keyed by position.
+	 *
+	 * Entries are 16 bytes, a key word and a data word holding the packed move, rating,
+	 * depth, bound and age. Four entries make up a 64 byte bucket aligned to a cache line,
+	 * so a probe touches a single line. The key word is stored XORed with the data word
+	 * so an entry half written by another thread fails the key check and reads as a miss,
+	 * no locking is needed.
+	 *
+	 * Within a bucket a store replaces the entry for the same position, or else whichever
+	 * entry is shallowest after favouring entries left over from earlier searches.
+	*/
+	class TranspositionTable
+	{
+	public:
+
+		/**
+		 * @brief Entries in each bucket
+		*/
+		constexpr static size_t bucket_size_v = 4;
+
+		/**
+		 * @brief Looks up a position
+		 * @param _key Zobrist key of the board
+		 * @return Stored entry, or nullopt on a miss
+		*/
+		std::optional<TranspositionEntry> probe(ZobristKey _key) const noexcept
+		{
+			const auto& _bucket = this->buckets_[_key & this->mask_];
+			for (auto& _slot : _bucket.slots)
+			{
+				const auto _data = _slot.data.load(std::memory_order_relaxed);
+				if ((_slot.key.load(std::memory_order_relaxed) ^ _data) == _key && data_bound(_data) != Bound::none)
+				{
+					return unpack_entry(_data);
+				};
+			};
+			return std::nullopt;
+		};
+
+		/**
+		 * @brief Stores a search result
+		 * @param _key Zobrist key of the board
+		 * @param _move Best move found, zero if there wasn't one
+		 * @param _rating Rating to store, must fit in 32 bits
+		 * @param _depth Depth searched to, clamped to 0-255
+		 * @param _bound How the rating relates to the real rating, not Bound::none
+		 * @return True if a different position stored during this search was replaced
+		*/
+		bool store(ZobristKey _key, PackedMove _move, Rating _rating, int _depth, Bound _bound) noexcept;
+
+		/**
+		 * @brief Ages the table, entries from earlier searches are replaced first.
+		 *
+		 * Call once before each search, the age wraps after 64 searches.
+		*/
+		void new_search() noexcept
+		{
+			this->age_.store((this->age_.load(std::memory_order_relaxed) + 1) & age_mask_v, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Gets the current age, see new_search()
+		*/
+		uint8_t age() const noexcept
+		{
+			return this->age_.load(std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Estimates the fraction of entries used by the current search from the first thousand buckets
+		*/
+		double fill_rate() const noexcept;
+
+		/**
+		 * @brief Adds to the running totals
+		 * @param _stats Counts to add, usually gathered by a single thread
+		*/
+		void add_stats(const TranspositionTableStats& _stats) noexcept
+		{
+			this->probes_.fetch_add(_stats.probes, std::memory_order_relaxed);
+			this->hits_.fetch_add(_stats.hits, std::memory_order_relaxed);
+			this->stores_.fetch_add(_stats.stores, std::memory_order_relaxed);
+			this->collisions_.fetch_add(_stats.collisions, std::memory_order_relaxed);
+		};
+
+		/**
+		 * @brief Gets the running totals
+		 * @return Totals since construction or the last clear()
+		*/
+		TranspositionTableStats stats() const noexcept
+		{
+			TranspositionTableStats _out{};
+			_out.probes = this->probes_.load(std::memory_order_relaxed);
+			_out.hits = this->hits_.load(std::memory_order_relaxed);
+			_out.stores = this->stores_.load(std::memory_order_relaxed);
+			_out.collisions = this->collisions_.load(std::memory_order_relaxed);
+			return _out;
+		};
+
+		/**
+		 * @brief Gets the number of entries in the table
+		*/
+		size_t size() const noexcept
+		{
+			return (this->mask_ + 1) * bucket_size_v;
+		};
+
+		/**
+		 * @brief Checks if the kernel was asked to back the table with huge pages
+		*/
+		bool uses_huge_pages() const noexcept
+		{
+			return this->huge_pages_;
+		};
+
+		/**
+		 * @brief Empties the table, must not be called while other threads are using it
+		*/
+		void clear() noexcept;
+
+		/**
+		 * @brief Allocates the table
+		 * @param _megabytes Table size, rounded down to a power of two buckets
+		 * @param _hugePages Ask for the table to be backed by huge pages, only supported on Linux
+		*/
+		explicit TranspositionTable(size_t _megabytes, bool _hugePages = false);
+
+		TranspositionTable(const TranspositionTable&) = delete;
+		TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+		~TranspositionTable();
+
+	private:
+
+		/**
+		 * @brief One entry, the key word is the Zobrist key XORed with the data word
+		*/
+		struct Slot
+		{
+			std::atomic<uint64_t> key;
+			std::atomic<uint64_t> data;
+		};
+		static_assert(sizeof(Slot) == 16);
+
+		struct alignas(64) Bucket
+		{
+			std::array<Slot, bucket_size_v> slots;
+		};
+		static_assert(sizeof(Bucket) == 64);
+
+		/*
+			Data word layout, low bits first :
+				16 move
+				32 rating
+				 8 depth
+				 2 bound
+				 6 age
+		*/
+		constexpr static uint64_t age_mask_v = 0b111111;
+
+		constexpr static uint64_t pack_entry(PackedMove _move, Rating _rating, int _depth, Bound _bound, uint8_t _age) noexcept
+		{
+			return static_cast<uint64_t>(_move.get()) |
+				(static_cast<uint64_t>(static_cast<uint32_t>(static_cast<int32_t>(_rating))) << 16) |
+				(static_cast<uint64_t>(static_cast<uint8_t>(_depth)) << 48) |
+				(static_cast<uint64_t>(_bound) << 56) |
+				(static_cast<uint64_t>(_age & age_mask_v) << 58);
+		};
+		constexpr static int data_depth(uint64_t _data) noexcept
+		{
+			return static_cast<int>((_data >> 48) & 0xFF);
+		};
+		constexpr static Bound data_bound(uint64_t _data) noexcept
+		{
+			return static_cast<Bound>((_data >> 56) & 0b11);
+		};
+		constexpr static uint8_t data_age(uint64_t _data) noexcept
+		{
+			return static_cast<uint8_t>(_data >> 58);
+		};
+		constexpr static TranspositionEntry unpack_entry(uint64_t _data) noexcept
+		{
+			TranspositionEntry _out{};
+			_out.move = PackedMove{ static_cast<PackedMove::value_type>(_data & 0xFFFF) };
+			_out.rating = static_cast<Rating>(static_cast<int32_t>(static_cast<uint32_t>(_data >> 16)));
+			_out.depth = data_depth(_data);
+			_out.bound = data_bound(_data);
+			_out.age = data_age(_data);
+			return _out;
+		};
+
+		Bucket* buckets_ = nullptr;
+		size_t mask_ = 0;
+		size_t bytes_ = 0;
+		size_t alignment_ = alignof(Bucket);
+		bool huge_pages_ = false;
+		std::atomic<uint8_t> age_{ 0 };
+
+		alignas(64) std::atomic<uint64_t> probes_{ 0 };
+		std::atomic<uint64_t> hits_{ 0 };
+		std::atomic<uint64_t> stores_{ 0 };
+		std::atomic<uint64_t> collisions_{ 0 };
+	};
+
+};
+
+#endif // LAMBDEX_CHESS_TRANSPOSITION_TABLE_HPP
@@ -3,6 +3,7 @@
 #include <lambdex/chess/move_validation.hpp>
 #include <lambdex/chess/piece_movement.hpp>
 
+#include <array>
 #include <random>
 #include <numeric>
 #include <algorithm>
@@ -18,7 +19,7 @@ namespace lbx::chess
 		constexpr bool check(const BoardWithState& _board, const Move& _move) const
 		{
 			auto& b = (_board.*this->flag);
-			return this->king_move == _move && b;
+			return this->king_move == _move && b && as_white(_board.get(_move.from)) == Piece::king;
 		};
 
 		// Apply the castle to a board, doesn't check for validity
@@ -28,10 +29,8 @@ namespace lbx::chess
 
 			JCLIB_ASSERT(b);
 
-			_board[this->rook_move.to] = _board[this->rook_move.from];
-			_board[this->rook_move.from] = Piece::empty;
-			_board[this->king_move.to] = _board[this->king_move.from];
-			_board[this->king_move.from] = Piece::empty;
+			_board.move_piece(this->rook_move.from, this->rook_move.to);
+			_board.move_piece(this->king_move.from, this->king_move.to);
 
 			b = false;
 		};
@@ -44,58 +43,165 @@ namespace lbx::chess
 	};
 
 	/**
-	 * @brief Applies a move to a chess board without checking for validity
-	 * @param _board Board to apply move on
-	 * @param _move Move to apply
-	 * @param _player Player making the move
+	 * @brief Clears the castling flags for any king or rook that moved or was captured
+	 * @param _board Board to update
+	 * @param _move Move being applied
 	*/
-	void apply_move(BoardWithState& _board, Move _move, const Color _player)
+	constexpr void update_castle_flags(BoardWithState& _board, const Move& _move)
 	{
-		// Castle movement definitions
-		constexpr auto _castleMoves = std::array
+		for (auto& _pos : { _move.from, _move.to })
 		{
-			CastleBehavior
+			if (_pos == (File::e, Rank::r1))
+			{
+				_board.white_can_castle_kingside = false;
+				_board.white_can_castle_queenside = false;
+			}
+			else if (_pos == (File::h, Rank::r1))
+			{
+				_board.white_can_castle_kingside = false;
+			}
+			else if (_pos == (File::a, Rank::r1))
+			{
+				_board.white_can_castle_queenside = false;
+			}
+			else if (_pos == (File::e, Rank::r8))
+			{
+				_board.black_can_castle_kingside = false;
+				_board.black_can_castle_queenside = false;
+			}
+			else if (_pos == (File::h, Rank::r8))
 			{
-				Move{ (Rank::r8, File::e), (Rank::r8, File::g) },
-				Move{ (Rank::r8, File::h), (Rank::r8, File::f) },
-				&BoardWithState::black_can_castle_kingside
-			},
-			CastleBehavior
+				_board.black_can_castle_kingside = false;
+			}
+			else if (_pos == (File::a, Rank::r8))
 			{
-				Move{ (Rank::r8, File::e), (Rank::r8, File::c) },
-				Move{ (Rank::r8, File::a), (Rank::r8, File::d) },
-				&BoardWithState::black_can_castle_queenside
-			},
-			CastleBehavior
+				_board.black_can_castle_queenside = false;
+			};
+		};
+	};
+
+	/**
+	 * @brief Castle movement definitions
+	*/
+	constexpr auto castle_behaviors = std::array
+	{
+		CastleBehavior
+		{
+			Move{ (Rank::r8, File::e), (Rank::r8, File::g) },
+			Move{ (Rank::r8, File::h), (Rank::r8, File::f) },
+			&BoardWithState::black_can_castle_kingside
+		},
+		CastleBehavior
+		{
+			Move{ (Rank::r8, File::e), (Rank::r8, File::c) },
+			Move{ (Rank::r8, File::a), (Rank::r8, File::d) },
+			&BoardWithState::black_can_castle_queenside
+		},
+		CastleBehavior
+		{
+			Move{ (Rank::r1, File::e), (Rank::r1, File::g) },
+			Move{ (Rank::r1, File::h), (Rank::r1, File::f) },
+			&BoardWithState::white_can_castle_kingside
+		},
+		CastleBehavior
+		{
+			Move{ (Rank::r1, File::e), (Rank::r1, File::c) },
+			Move{ (Rank::r1, File::a), (Rank::r1, File::d) },
+			&BoardWithState::white_can_castle_queenside
+		}
+	};
+
+	/**
+	 * @brief Finds the castle a move performs
+	 * @param _move King's move, must be a castle
+	 * @return Castle behavior
+	*/
+	constexpr const CastleBehavior& find_castle_behavior(const Move& _move)
+	{
+		const auto it = std::ranges::find(castle_behaviors, _move, &CastleBehavior::king_move);
+		JCLIB_ASSERT(it != castle_behaviors.end());
+		return *it;
+	};
+
+	/**
+	 * @brief Works out the kind of a move from the board it is about to be made on
+	 * @param _board Board the move will be made on
+	 * @param _move Move to pack, a pawn reaching the back rank without a promotion piece promotes to a queen
+	 * @return Packed move
+	*/
+	PackedMove pack_move(const BoardWithState& _board, const Move& _move)
+	{
+		const auto _piece = _board.get(_move.from);
+		JCLIB_ASSERT(_piece != Piece::empty);
+
+		const bool _isCapture = _board.get(_move.to) != Piece::empty;
+		auto _kind = (_isCapture) ? MoveKind::capture : MoveKind::quiet;
+
+		if (as_white(_piece) == Piece::pawn)
+		{
+			if (_move.to.rank() == Rank::r1 || _move.to.rank() == Rank::r8)
 			{
-				Move{ (Rank::r1, File::e), (Rank::r1, File::g) },
-				Move{ (Rank::r1, File::h), (Rank::r1, File::f) },
-				&BoardWithState::white_can_castle_kingside
-			},
-			CastleBehavior
+				const auto _promotion = (_move.promotion == Piece::empty) ? Piece::queen : _move.promotion;
+				const auto _packed = PackedMove{ Move{ _move.from, _move.to, _promotion } };
+				_kind = MoveKind(jc::to_underlying(_packed.kind()) | jc::to_underlying(_kind));
+			}
+			else if (distance(_move.from.rank(), _move.to.rank()) == 2)
 			{
-				Move{ (Rank::r1, File::e), (Rank::r1, File::c) },
-				Move{ (Rank::r1, File::a), (Rank::r1, File::d) },
-				&BoardWithState::white_can_castle_queenside
+				_kind = MoveKind::double_pawn_push;
 			}
+			else if (_board.has_en_passant() && _board.get_en_passant() == Position{ _move.to } &&
+				_board.get((_move.to.file(), _move.from.rank())) != Piece::empty)
+			{
+				_kind = MoveKind::en_passant;
+			};
+		}
+		else if (as_white(_piece) == Piece::king && distance(_move.from.file(), _move.to.file()) == 2)
+		{
+			for (auto& m : castle_behaviors)
+			{
+				if (m.check(_board, _move))
+				{
+					_kind = (_move.to.file() == File::g) ? MoveKind::king_castle : MoveKind::queen_castle;
+				};
+			};
 		};
 
+		return PackedMove{ _move.from, _move.to, _kind };
+	};
+
+	/**
+	 * @brief Applies a move to a chess board without checking for validity
+	 * @param _board Board to apply move on
+	 * @param _move Move to apply, must have been packed by pack_move() for this board
+	 * @return Information needed to undo the move with unmake_move()
+	*/
+	UndoInfo make_move(BoardWithState& _board, PackedMove _move)
+	{
+		const auto _from = _move.from();
+		const auto _to = _move.to();
+		const auto _kind = _move.kind();
+
+		const auto _piece = _board.get(_from);
+		JCLIB_ASSERT(_piece != Piece::empty);
+
+		UndoInfo _undo{};
+		_undo.key = _board.zobrist_key();
+		_undo.half_move_counter = _board.half_move_counter;
+		_undo.kind = _kind;
+		_undo.en_passant = (_board.has_en_passant()) ? _board.get_en_passant() : Position::end();
+		_undo.castle_flags = _board.get_castle_flags();
 
-		// Check for en passant
-		if (_board.has_en_passant() &&
-			_board.get_en_passant() == Position{ _move.to } &&
-			as_white(_board.at(_move.from)) == Piece::pawn_white)
+		// Capture stupid pawn
+		if (_kind == MoveKind::en_passant)
 		{
-			// Capture stupid pawn
-			const auto _pawnPos = (_move.to.file(), _move.from.rank());
-			_board[_pawnPos] = Piece::empty;
+			_undo.captured = _board.remove_piece((_to.file(), _from.rank()));
 		};
 
 		// If this is a pawn moving two squares, set en passant
-		if (as_white(_board[_move.from]) == Piece::pawn && distance(_move.from.rank(), _move.to.rank()) == 2)
+		if (_kind == MoveKind::double_pawn_push)
 		{
-			const auto _middleRank = Rank( std::midpoint(jc::to_underlying(_move.from.rank()), jc::to_underlying(_move.to.rank())) );
-			_board.set_en_passant(PositionPair(_move.from.file(), _middleRank));
+			const auto _middleRank = Rank( std::midpoint(jc::to_underlying(_from.rank()), jc::to_underlying(_to.rank())) );
+			_board.set_en_passant(PositionPair(_from.file(), _middleRank));
 		}
 		else
 		{
@@ -103,13 +209,10 @@ namespace lbx::chess
 			_board.clear_en_passant();
 		};
 
-		// Increment half move counter
+		// Reset half move counter on pawn advance or capture
 		++_board.half_move_counter;
-
-		// Check for pawn advance or capture
-		if (_board[_move.to] != Piece::empty || as_white(_board[_move.from]) == Piece::pawn_white)
+		if (_move.is_capture() || as_white(_piece) == Piece::pawn)
 		{
-			// Reset half move counter
 			_board.half_move_counter = 0;
 		};
 
@@ -122,43 +225,101 @@ namespace lbx::chess
 		_board.turn = !_board.turn;
 
 		// Handle castling moves
-		for (auto& m : _castleMoves)
+		if (_move.is_castle())
 		{
-			if (m.check(_board, _move))
-			{
-				m.apply(_board);
-				return;
-			};
+			find_castle_behavior(_move).apply(_board);
+			update_castle_flags(_board, _move);
+			_board.verify_incremental_state();
+			return _undo;
+		};
+		update_castle_flags(_board, _move);
+
+		// Remove any captured piece then move ours
+		if (_move.is_capture() && _kind != MoveKind::en_passant)
+		{
+			_undo.captured = _board.remove_piece(_to);
 		};
+		_board.move_piece(_from, _to);
 
-		// Move the piece
-		const auto _piece = _board[_move.from];
-		_board[_move.to] = _piece;
-		
-		// Replace old piece with empty
-		_board[_move.from] = Piece::empty;
+		// Apply pawn promotion if there is one
+		if (_move.is_promotion())
+		{
+			_board.remove_piece(_to);
+			_board.place_piece(_to, _move.promotion() | get_color(_piece));
+		};
 
+		_board.verify_incremental_state();
+		return _undo;
+	};
 
-		// If a pawn made it to the back rank and no promotion piece was specified, set
-		// the promotion piece to queen
-		if (as_white(_piece) == Piece::pawn_white &&
-			(_move.to.rank() == Rank::r1 || _move.to.rank() == Rank::r8) &&
-			_move.promotion == Piece::empty)
+	/**
+	 * @brief Reverts a move applied by make_move()
+	 * @param _board Board the move was applied to, must not have been changed since
+	 * @param _move The move that was made
+	 * @param _undo Value returned by make_move()
+	*/
+	void unmake_move(BoardWithState& _board, const Move& _move, const UndoInfo& _undo)
+	{
+		_board.turn = !_board.turn;
+		if (_board.turn == Color::black)
 		{
-			_move.promotion = Piece::queen;
+			--_board.full_move_counter;
 		};
+		_board.half_move_counter = _undo.half_move_counter;
+		_board.set_castle_flags(_undo.castle_flags);
 
-		// Apply pawn promotion if there is one
-		if (_move.promotion != Piece::empty)
+		const auto _packed = PackedMove{ _move.from, _move.to, _undo.kind };
+		if (_packed.is_castle())
+		{
+			const auto& _castle = find_castle_behavior(_packed);
+			_board.move_piece(_castle.king_move.to, _castle.king_move.from);
+			_board.move_piece(_castle.rook_move.to, _castle.rook_move.from);
+		}
+		else
 		{
-			auto _promoPiece = _move.promotion;
-			if (_player == Color::black)
+			// Put back the piece that moved, swapping a promoted piece back to its pawn
+			if (_packed.is_promotion())
+			{
+				const auto _color = get_color(_board.remove_piece(_move.to));
+				_board.place_piece(_move.from, Piece::pawn | _color);
+			}
+			else
+			{
+				_board.move_piece(_move.to, _move.from);
+			};
+
+			if (_undo.kind == MoveKind::en_passant)
 			{
-				_promoPiece = _promoPiece | Color::black;
+				_board.place_piece((_move.to.file(), _move.from.rank()), _undo.captured);
+			}
+			else if (_undo.captured != Piece::empty)
+			{
+				_board.place_piece(_move.to, _undo.captured);
 			};
-			_board[_move.to] = _promoPiece;
 		};
 
+		if (_undo.en_passant != Position::end())
+		{
+			_board.set_en_passant(_undo.en_passant);
+		}
+		else
+		{
+			_board.clear_en_passant();
+		};
+
+		JCLIB_ASSERT(_board.zobrist_key() == _undo.key);
+	};
+
+	/**
+	 * @brief Applies a move to a chess board without checking for validity
+	 * @param _board Board to apply move on
+	 * @param _move Move to apply
+	 * @param _player Player making the move, must own the piece being moved
+	*/
+	void apply_move(BoardWithState& _board, Move _move, const Color _player)
+	{
+		JCLIB_ASSERT(_board.get(_move.from) == Piece::empty || get_color(_board.get(_move.from)) == _player);
+		make_move(_board, _move);
 	};
 
 
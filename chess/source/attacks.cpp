@@ -0,0 +1,358 @@
+#include <lambdex/chess/attacks.hpp>
+
+#include <bit>
+#include <span>
+#include <array>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+	#include <intrin.h>
+	#include <immintrin.h>
+	#define LAMBDEX_CHESS_HAS_PEXT_INTRINSIC
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+	#include <immintrin.h>
+	#define LAMBDEX_CHESS_HAS_PEXT_INTRINSIC
+#endif
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Total number of rook attack sets over all squares
+		*/
+		constexpr size_t rook_attack_table_size = 0x19000;
+
+		/**
+		 * @brief Total number of bishop attack sets over all squares
+		*/
+		constexpr size_t bishop_attack_table_size = 0x1480;
+
+		std::array<BitBoard, rook_attack_table_size> rook_magic_attacks_{};
+		std::array<BitBoard, rook_attack_table_size> rook_pext_attacks_{};
+		std::array<BitBoard, bishop_attack_table_size> bishop_magic_attacks_{};
+		std::array<BitBoard, bishop_attack_table_size> bishop_pext_attacks_{};
+
+		/**
+		 * @brief (file, rank) steps a slider can move along
+		*/
+		using SliderDirections = std::array<std::array<int, 2>, 4>;
+
+		constexpr SliderDirections rook_directions
+		{{
+			{  0,  1 },
+			{  0, -1 },
+			{  1,  0 },
+			{ -1,  0 },
+		}};
+		constexpr SliderDirections bishop_directions
+		{{
+			{  1,  1 },
+			{  1, -1 },
+			{ -1,  1 },
+			{ -1, -1 },
+		}};
+
+		/**
+		 * @brief Finds attacked squares by walking each ray until it hits a piece, used to fill the tables
+		 * @param _directions Directions the slider moves in
+		 * @param _square Square the slider is on
+		 * @param _occupancy Squares holding pieces
+		 * @return Attacked squares
+		*/
+		constexpr BitBoard::binary_type walk_slider_attacks(const SliderDirections& _directions, int _square, BitBoard::binary_type _occupancy) noexcept
+		{
+			BitBoard::binary_type _out = 0;
+			for (auto& d : _directions)
+			{
+				int _file = (_square % 8) + d[0];
+				int _rank = (_square / 8) + d[1];
+				while (_file >= 0 && _file < 8 && _rank >= 0 && _rank < 8)
+				{
+					const auto _bit = BitBoard::binary_type{ 1 } << (_rank * 8 + _file);
+					_out |= _bit;
+					if (_occupancy & _bit)
+					{
+						break;
+					};
+					_file += d[0];
+					_rank += d[1];
+				};
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Portable PEXT, only used while building the tables
+		*/
+		constexpr uint64_t software_pext(uint64_t _value, uint64_t _mask) noexcept
+		{
+			uint64_t _out = 0;
+			uint64_t _outBit = 1;
+			while (_mask != 0)
+			{
+				const auto _lowest = _mask & (~_mask + 1);
+				if (_value & _lowest)
+				{
+					_out |= _outBit;
+				};
+				_outBit <<= 1;
+				_mask ^= _lowest;
+			};
+			return _out;
+		};
+
+		/**
+		 * @brief Small xorshift generator used to search for magics, seeded so the tables are the same every run
+		*/
+		class MagicPRNG
+		{
+		public:
+
+			uint64_t next() noexcept
+			{
+				this->state_ ^= this->state_ >> 12;
+				this->state_ ^= this->state_ << 25;
+				this->state_ ^= this->state_ >> 27;
+				return this->state_ * 2685821657736338717ull;
+			};
+
+			/**
+			 * @brief Gets a value with roughly 1/8th of its bits set, these make good magic candidates
+			*/
+			uint64_t next_sparse() noexcept
+			{
+				return this->next() & this->next() & this->next();
+			};
+
+			explicit MagicPRNG(uint64_t _seed) noexcept :
+				state_{ _seed }
+			{
+				JCLIB_ASSERT(_seed != 0);
+			};
+
+		private:
+			uint64_t state_;
+		};
+
+		/**
+		 * @brief Builds the lookup entries and attack tables for one kind of slider
+		 * @param _directions Directions the slider moves in
+		 * @param _entries Entry for each square to fill
+		 * @param _magicTable Table to fill with attack sets indexed by magic
+		 * @param _pextTable Table to fill with attack sets indexed by pext
+		*/
+		void init_slider_attacks(const SliderDirections& _directions, std::array<impl::SliderAttackEntry, 64>& _entries,
+			std::span<BitBoard> _magicTable, std::span<BitBoard> _pextTable)
+		{
+			// Seeds per rank that find magics quickly
+			constexpr std::array<uint64_t, 8> _seeds{ 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+			constexpr BitBoard::binary_type _rank1 = 0x00000000000000FFull;
+			constexpr BitBoard::binary_type _rank8 = 0xFF00000000000000ull;
+			constexpr BitBoard::binary_type _fileA = 0x0101010101010101ull;
+			constexpr BitBoard::binary_type _fileH = 0x8080808080808080ull;
+
+			std::array<BitBoard::binary_type, 4096> _occupancies{};
+			std::array<BitBoard::binary_type, 4096> _references{};
+
+			// Tracks which attempt last wrote each index so the table doesn't need clearing between attempts
+			std::array<uint32_t, 4096> _epochs{};
+			uint32_t _attempt = 0;
+
+			size_t _offset = 0;
+			for (int sq = 0; sq != 64; ++sq)
+			{
+				const auto _fileBits = _fileA << (sq % 8);
+				const auto _rankBits = _rank1 << (8 * (sq / 8));
+
+				// Pieces on the edge of the board never block anything
+				const auto _edges = ((_rank1 | _rank8) & ~_rankBits) | ((_fileA | _fileH) & ~_fileBits);
+
+				auto& _entry = _entries[sq];
+				_entry.mask = walk_slider_attacks(_directions, sq, 0) & ~_edges;
+				_entry.shift = static_cast<uint8_t>(64 - std::popcount(_entry.mask));
+
+				const auto _magicAttacks = _magicTable.subspan(_offset);
+				const auto _pextAttacks = _pextTable.subspan(_offset);
+				_entry.magic_attacks = _magicAttacks.data();
+				_entry.pext_attacks = _pextAttacks.data();
+
+				// Enumerate every subset of the mask (Carry-Rippler)
+				size_t _count = 0;
+				BitBoard::binary_type _subset = 0;
+				do
+				{
+					_occupancies[_count] = _subset;
+					_references[_count] = walk_slider_attacks(_directions, sq, _subset);
+					_pextAttacks[software_pext(_subset, _entry.mask)] = BitBoard{ _references[_count] };
+					++_count;
+					_subset = (_subset - _entry.mask) & _entry.mask;
+				}
+				while (_subset != 0);
+
+				// Try sparse random numbers until one maps every subset without a destructive collision
+				MagicPRNG _prng{ _seeds[sq / 8] };
+				for (size_t i = 0; i != _count;)
+				{
+					do
+					{
+						_entry.magic = _prng.next_sparse();
+					}
+					while (std::popcount((_entry.magic * _entry.mask) >> 56) < 6);
+
+					++_attempt;
+					for (i = 0; i != _count; ++i)
+					{
+						const auto _index = (_occupancies[i] * _entry.magic) >> _entry.shift;
+						if (_epochs[_index] != _attempt)
+						{
+							_epochs[_index] = _attempt;
+							_magicAttacks[_index] = BitBoard{ _references[i] };
+						}
+						else if (_magicAttacks[_index].bits() != _references[i])
+						{
+							break;
+						};
+					};
+				};
+
+				_offset += _count;
+			};
+			JCLIB_ASSERT(_offset == _magicTable.size());
+		};
+
+		bool cpu_supports_bmi2() noexcept
+		{
+#if defined(_MSC_VER) && defined(_M_X64)
+			int _regs[4]{};
+			__cpuidex(_regs, 7, 0);
+			return (_regs[1] >> 8) & 1;
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("bmi2");
+#else
+			return false;
+#endif
+		};
+
+		/**
+		 * @brief Set if the CPU can run the pext backend
+		*/
+		const bool pext_supported_ = cpu_supports_bmi2();
+
+		/**
+		 * @brief Fills the between and line tables
+		*/
+		void init_line_tables()
+		{
+			for (int a = 0; a != 64; ++a)
+			{
+				for (int b = 0; b != 64; ++b)
+				{
+					const auto _aBit = BitBoard::binary_type{ 1 } << a;
+					const auto _bBit = BitBoard::binary_type{ 1 } << b;
+					for (auto _directions : { &rook_directions, &bishop_directions })
+					{
+						if (walk_slider_attacks(*_directions, a, 0) & _bBit)
+						{
+							impl::between_table[a][b] = BitBoard
+							{
+								walk_slider_attacks(*_directions, a, _bBit) & walk_slider_attacks(*_directions, b, _aBit)
+							};
+							impl::line_table[a][b] = BitBoard
+							{
+								(walk_slider_attacks(*_directions, a, 0) & walk_slider_attacks(*_directions, b, 0)) | _aBit | _bBit
+							};
+						};
+					};
+				};
+			};
+		};
+
+		/**
+		 * @brief Builds all of the attack tables, runs during static initialization
+		*/
+		SliderAttackBackend init_attack_tables()
+		{
+			init_slider_attacks(rook_directions, impl::rook_attack_entries, rook_magic_attacks_, rook_pext_attacks_);
+			init_slider_attacks(bishop_directions, impl::bishop_attack_entries, bishop_magic_attacks_, bishop_pext_attacks_);
+			init_line_tables();
+			return (pext_supported_) ? SliderAttackBackend::pext : SliderAttackBackend::magic;
+		};
+	};
+
+	namespace impl
+	{
+		std::array<SliderAttackEntry, 64> rook_attack_entries{};
+		std::array<SliderAttackEntry, 64> bishop_attack_entries{};
+
+		std::array<std::array<BitBoard, 64>, 64> between_table{};
+		std::array<std::array<BitBoard, 64>, 64> line_table{};
+
+		SliderAttackBackend slider_attack_backend = init_attack_tables();
+
+#if defined(LAMBDEX_CHESS_HAS_PEXT_INTRINSIC)
+	#if defined(__GNUC__) || defined(__clang__)
+		__attribute__((target("bmi2")))
+	#endif
+		uint64_t pext_index(uint64_t _value, uint64_t _mask) noexcept
+		{
+			return _pext_u64(_value, _mask);
+		};
+#else
+		uint64_t pext_index(uint64_t _value, uint64_t _mask) noexcept
+		{
+			return software_pext(_value, _mask);
+		};
+#endif
+	};
+
+	/**
+	 * @brief Checks if the running CPU supports a slider attack backend
+	 * @param _backend Backend to check
+	 * @return True if supported, false otherwise
+	*/
+	bool is_slider_attack_backend_supported(SliderAttackBackend _backend) noexcept
+	{
+		switch (_backend)
+		{
+		case SliderAttackBackend::magic:
+			return true;
+		case SliderAttackBackend::pext:
+			return pext_supported_;
+		default:
+			return false;
+		};
+	};
+
+	/**
+	 * @brief Gets the backend used for slider attack lookups.
+	 *
+	 * This defaults to pext when supported and magic otherwise.
+	 *
+	 * @return Backend in use
+	*/
+	SliderAttackBackend get_slider_attack_backend() noexcept
+	{
+		return impl::slider_attack_backend;
+	};
+
+	/**
+	 * @brief Sets the backend used for slider attack lookups, this is not thread safe.
+	 *
+	 * Some CPUs implement PEXT in microcode, on those the magic backend is faster.
+	 *
+	 * @param _backend Backend to use
+	 * @return True if the backend was set, false if it isn't supported
+	*/
+	bool set_slider_attack_backend(SliderAttackBackend _backend) noexcept
+	{
+		if (!is_slider_attack_backend_supported(_backend))
+		{
+			return false;
+		};
+		impl::slider_attack_backend = _backend;
+		return true;
+	};
+
+};
@@ -0,0 +1,227 @@
+#include <lambdex/chess/endgame.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Gets the square of a player's king
+		*/
+		int king_square(const BoardWithState& _board, Color _player)
+		{
+			return static_cast<int>(_board.as_bits_with_pieces(Piece::king | _player).first().get());
+		};
+
+		/**
+		 * @brief Gets the number of king moves between two squares
+		*/
+		int king_distance(int _a, int _b)
+		{
+			return std::max(std::abs(_a % 8 - _b % 8), std::abs(_a / 8 - _b / 8));
+		};
+
+		/**
+		 * @brief Gets how far a square is from the middle of the board, 0 in the middle four squares and 6 in the corners
+		*/
+		int center_distance(int _square)
+		{
+			const auto _file = _square % 8;
+			const auto _rank = _square / 8;
+			return std::max(3 - _file, _file - 4) + std::max(3 - _rank, _rank - 4);
+		};
+
+		/**
+		 * @brief Rating for a won endgame where the lone king has to be driven into a corner
+		 * @param _board Board to rate
+		 * @param _strong Color of the winning side
+		 * @param _cornerDistance How far the lone king is from a corner it can be mated in, 0 to 7
+		*/
+		Rating mop_up(const BoardWithState& _board, Color _strong, int _cornerDistance)
+		{
+			const auto _strongKing = king_square(_board, _strong);
+			const auto _weakKing = king_square(_board, !_strong);
+			const auto _material = _board.get_material(_strong) - _board.get_material(!_strong);
+			return endgame_win_v + _material + 20 * center_distance(_weakKing) +
+				10 * (7 - _cornerDistance) + 10 * (7 - king_distance(_strongKing, _weakKing));
+		};
+
+		/**
+		 * @brief Not enough material to mate, KK, KNK, KBK and KNNK
+		*/
+		Rating evaluate_draw(const BoardWithState&, Color)
+		{
+			return 0;
+		};
+
+		/**
+		 * @brief A queen or rook against a lone king mates on any edge
+		*/
+		Rating evaluate_kxk(const BoardWithState& _board, Color _strong)
+		{
+			return mop_up(_board, _strong, 0);
+		};
+
+		/**
+		 * @brief Bishop and knight can only mate in a corner the bishop's color
+		*/
+		Rating evaluate_kbnk(const BoardWithState& _board, Color _strong)
+		{
+			const auto _bishop = static_cast<int>(_board.as_bits_with_pieces(Piece::bishop | _strong).first().get());
+			const bool _darkBishop = ((_bishop % 8) + (_bishop / 8)) % 2 == 0;
+			const auto _weakKing = king_square(_board, !_strong);
+
+			// a1 and h8 are dark, a8 and h1 are light
+			const auto _cornerDistance = (_darkBishop) ?
+				std::min(king_distance(_weakKing, 0), king_distance(_weakKing, 63)) :
+				std::min(king_distance(_weakKing, 7), king_distance(_weakKing, 56));
+			return mop_up(_board, _strong, _cornerDistance);
+		};
+
+		/**
+		 * @brief King and pawn against king.
+		 *
+		 * Won if the lone king is outside the square of the pawn, or if the strong king
+		 * stands on one of the pawn's key squares without the pawn hanging. Rook pawns are
+		 * drawn once the lone king reaches the corner. Anything else is rated as a pawn up
+		 * and left to the search.
+		*/
+		Rating evaluate_kpk(const BoardWithState& _board, Color _strong)
+		{
+			const auto _pawnSquare = static_cast<int>(_board.as_bits_with_pieces(Piece::pawn | _strong).first().get());
+			const auto _strongKing = king_square(_board, _strong);
+			const auto _weakKing = king_square(_board, !_strong);
+
+			// Work in ranks counted from the strong side so white and black are the same
+			const auto _relativeRank = [_strong](int _square)
+			{
+				return (_strong == Color::white) ? _square / 8 : 7 - _square / 8;
+			};
+			const auto _file = _pawnSquare % 8;
+			const auto _rank = _relativeRank(_pawnSquare);
+			const auto _promotion = (_strong == Color::white) ? 56 + _file : _file;
+			const bool _strongToMove = _board.turn == _strong;
+			const auto _winning = endgame_win_v + impl::pawn_value_v + 20 * _rank;
+
+			// Rook pawns can't be forced through a king in the corner
+			if ((_file == 0 || _file == 7) && king_distance(_weakKing, _promotion) <= 1)
+			{
+				return 0;
+			};
+
+			// Rule of the square, the pawn moves two from its starting rank
+			const auto _pawnMoves = std::min(7 - _rank, 5);
+			const auto _kingMoves = king_distance(_weakKing, _promotion) - ((_strongToMove) ? 0 : 1);
+			const bool _ownKingInTheWay = (_strongKing % 8) == _file && _relativeRank(_strongKing) > _rank;
+			if (_kingMoves > _pawnMoves && !_ownKingInTheWay)
+			{
+				return _winning;
+			};
+
+			// Key squares are two ranks in front of the pawn, or one and two once it is past halfway
+			const bool _pawnHangs = !_strongToMove && king_distance(_weakKing, _pawnSquare) == 1 &&
+				king_distance(_strongKing, _pawnSquare) > 1;
+			if (_file != 0 && _file != 7 && !_pawnHangs && std::abs(_strongKing % 8 - _file) <= 1)
+			{
+				const auto _ahead = _relativeRank(_strongKing) - _rank;
+				if (_ahead == 2 || (_ahead == 1 && _rank >= 4))
+				{
+					return _winning;
+				};
+			};
+
+			return impl::pawn_value_v + 10 * _rank;
+		};
+
+		/**
+		 * @brief Makes the table entries for an endgame with each color as the strong side
+		*/
+		constexpr std::array<Endgame, 2> both_colors(std::string_view _signature, EndgameFunction _evaluate)
+		{
+			return
+			{
+				Endgame{ make_material_key(_signature, Color::white), _evaluate, Color::white, _signature },
+				Endgame{ make_material_key(_signature, Color::black), _evaluate, Color::black, _signature }
+			};
+		};
+
+		/**
+		 * @brief Every known endgame, boards with more pieces than this are never looked up
+		*/
+		const auto endgame_table = []()
+		{
+			const std::array _endgames
+			{
+				both_colors("KK", &evaluate_draw),
+				both_colors("KNK", &evaluate_draw),
+				both_colors("KBK", &evaluate_draw),
+				both_colors("KNNK", &evaluate_draw),
+				both_colors("KQK", &evaluate_kxk),
+				both_colors("KRK", &evaluate_kxk),
+				both_colors("KBNK", &evaluate_kbnk),
+				both_colors("KPK", &evaluate_kpk),
+			};
+
+			std::array<Endgame, _endgames.size() * 2> _out{};
+			auto it = _out.begin();
+			for (auto& e : _endgames)
+			{
+				it = std::copy(e.begin(), e.end(), it);
+			};
+			return _out;
+		}();
+	};
+
+	namespace impl
+	{
+		/**
+		 * @brief Looks up the endgame for a material key
+		 * @param _key Material key
+		 * @return Endgame, or nullptr if there is no specialised evaluation for the key
+		*/
+		const Endgame* find_endgame(MaterialKey _key) noexcept
+		{
+			for (auto& e : endgame_table)
+			{
+				if (e.key == _key)
+				{
+					return &e;
+				};
+			};
+			return nullptr;
+		};
+	};
+
+	/**
+	 * @brief Rates a board with the specialised evaluation for its material.
+	 *
+	 * Stalemates rate as a draw. Checkmates are left to the normal evaluation.
+	 *
+	 * @param _context Context for the board to rate
+	 * @param _player Player whose POV to rate from
+	 * @return Rating, or nullopt if the board isn't a known endgame or is checkmate
+	*/
+	std::optional<Rating> rate_endgame(const RatingContext& _context, Color _player)
+	{
+		const auto _endgame = find_endgame(_context.board());
+		if (!_endgame)
+		{
+			return std::nullopt;
+		};
+
+		if (_context.legal_move_count() == 0)
+		{
+			if (_context.in_check())
+			{
+				return std::nullopt;
+			};
+			return 0;
+		};
+
+		const auto _rating = _endgame->evaluate(_context.board(), _endgame->strong);
+		return (_player == _endgame->strong) ? _rating : -_rating;
+	};
+};
@@ -0,0 +1,33 @@
+#include <lambdex/chess/eval_cache.hpp>
+
+#include <bit>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Empties the table, must not be called while other threads are using it
+	*/
+	void EvalCache::clear() noexcept
+	{
+		for (size_t n = 0; n != this->size(); ++n)
+		{
+			this->entries_[n].store(0, std::memory_order_relaxed);
+		};
+		this->hits_.store(0, std::memory_order_relaxed);
+		this->misses_.store(0, std::memory_order_relaxed);
+	};
+
+	/**
+	 * @brief Allocates the table
+	 * @param _megabytes Table size, rounded down to a power of two entries
+	*/
+	EvalCache::EvalCache(size_t _megabytes)
+	{
+		const auto _wanted = std::max<size_t>((_megabytes * 1024 * 1024) / sizeof(uint64_t), 1);
+		const auto _count = std::bit_floor(_wanted);
+		this->entries_ = std::make_unique<std::atomic<uint64_t>[]>(_count);
+		this->mask_ = _count - 1;
+		this->clear();
+	};
+};
@@ -1,6 +1,7 @@
 #include <lambdex/chess/evaluation.hpp>
+#include <lambdex/chess/attacks.hpp>
 
-#include <jclib/ranges.h>
+#include <array>
 
 namespace lbx::chess
 {
@@ -12,18 +13,17 @@ namespace lbx::chess
 	*/
 	bool is_checkmate(const BoardWithState& _board, Color _player)
 	{
-		const auto _kingPosOpt = _board.find(Piece::king | _player);
-		if (!_kingPosOpt)
+		const auto _kingBits = _board.as_bits_with_pieces(Piece::king | _player);
+		if (_kingBits.none())
 		{
 			return true;
 		};
 
-		const auto _kingPos = *_kingPosOpt;
-		if (is_piece_threatened(_board, _kingPos))
+		if (square_attacked_by(_board, _kingBits.first(), !_player).any())
 		{
 			// Check if there are any possible moves
-			static thread_local std::array<Move, 128> _moveBuffer{};
-			const auto _count = find_possible_moves(_board, _moveBuffer);
+			MoveList _moves{};
+			const auto _count = find_possible_moves(_board, _moves.storage());
 			if (_count == 0)
 			{
 				return true;
@@ -42,6 +42,164 @@ namespace lbx::chess
 
 
 
+	/**
+	 * @brief Checks if the player whose turn it is is in check
+	 * @return True if in check
+	*/
+	bool RatingContext::in_check() const
+	{
+		if (!this->in_check_)
+		{
+			const auto& _board = this->board();
+			const auto _kingBits = _board.as_bits_with_pieces(Piece::king | _board.turn);
+			this->in_check_ = _kingBits.any() && square_attacked_by(_board, _kingBits.first(), !_board.turn).any();
+		};
+		return *this->in_check_;
+	};
+
+	/**
+	 * @brief Gets the number of legal moves for the player whose turn it is
+	 * @return Legal move count
+	*/
+	size_t RatingContext::legal_move_count() const
+	{
+		if (!this->legal_move_count_)
+		{
+			MoveList _moves{};
+			this->legal_move_count_ = find_possible_moves(this->board(), _moves.storage());
+		};
+		return *this->legal_move_count_;
+	};
+
+	/**
+	 * @brief Checks if a player is checkmated, a player without a king counts as checkmated
+	 * @param _player Player to test for checkmate of
+	 * @return True if checkmate
+	*/
+	bool RatingContext::is_checkmate(Color _player) const
+	{
+		const auto& _board = this->board();
+		if (_board.as_bits_with_pieces(Piece::king | _player).none())
+		{
+			return true;
+		};
+
+		// The player who just moved can't have left themselves in check
+		if (_player != _board.turn)
+		{
+			return false;
+		};
+		return this->in_check() && this->legal_move_count() == 0;
+	};
+
+
+
+	/**
+	 * @brief Gets the pseudo-legal attack sets of both players
+	 * @return Attack sets
+	*/
+	const AttackInfo& RatingContext::attack_info() const
+	{
+		if (!this->attack_info_)
+		{
+			this->attack_info_ = compute_attack_info(this->board());
+		};
+		return *this->attack_info_;
+	};
+
+	namespace
+	{
+		constexpr BitBoard::binary_type not_file_a_bits_v = ~0x0101010101010101ull;
+		constexpr BitBoard::binary_type not_file_h_bits_v = ~0x8080808080808080ull;
+
+		/**
+		 * @brief Gets the squares attacked by a set of pawns all at once
+		*/
+		constexpr BitBoard pawn_attacks_of(BitBoard _pawns, Color _player) noexcept
+		{
+			const auto _bits = _pawns.bits();
+			if (_player == Color::white)
+			{
+				return BitBoard{ ((_bits & not_file_a_bits_v) << 7) | ((_bits & not_file_h_bits_v) << 9) };
+			}
+			else
+			{
+				return BitBoard{ ((_bits & not_file_a_bits_v) >> 9) | ((_bits & not_file_h_bits_v) >> 7) };
+			};
+		};
+
+		/**
+		 * @brief Gets the squares a piece attacks
+		*/
+		inline BitBoard piece_attacks(Piece _piece, Position _square, BitBoard _occupied) noexcept
+		{
+			switch (as_white(_piece))
+			{
+			case Piece::knight:
+				return knight_attacks(_square);
+			case Piece::bishop:
+				return bishop_attacks(_square, _occupied);
+			case Piece::rook:
+				return rook_attacks(_square, _occupied);
+			case Piece::queen:
+				return queen_attacks(_square, _occupied);
+			default:
+				JCLIB_ABORT();
+				return BitBoard{};
+			};
+		};
+	};
+
+	/**
+	 * @brief Works out the attack sets of both players
+	 * @param _board Board to look at
+	 * @return Attack sets
+	*/
+	AttackInfo compute_attack_info(const BoardWithState& _board)
+	{
+		AttackInfo _out{};
+		const auto _occupied = _board.as_bits_with_pieces();
+
+		for (auto c : { Color::white, Color::black })
+		{
+			const auto _color = jc::to_underlying(c);
+			_out.pawn_attacks[_color] = pawn_attacks_of(_board.as_bits_with_pieces(Piece::pawn | c), c);
+			_out.attacked[_color] = _out.pawn_attacks[_color];
+
+			const auto _king = _board.as_bits_with_pieces(Piece::king | c);
+			if (_king.any())
+			{
+				const auto _kingAttacks = king_attacks(_king.first());
+				_out.king_zone[_color] = _kingAttacks | _king;
+				_out.attacked[_color] |= _kingAttacks;
+			};
+		};
+
+		for (auto c : { Color::white, Color::black })
+		{
+			const auto _color = jc::to_underlying(c);
+			const auto _them = jc::to_underlying(!c);
+			const auto _available = ~(_board.as_bits_with_pieces(c) | _out.pawn_attacks[_them]);
+			const auto& _enemyZone = _out.king_zone[_them];
+
+			for (size_t n = 0; n != attack_info_pieces.size(); ++n)
+			{
+				const auto _piece = attack_info_pieces[n] | c;
+				auto _pieces = _board.as_bits_with_pieces(_piece);
+				while (_pieces.any())
+				{
+					const auto _attacks = piece_attacks(_piece, _pieces.pop_first(), _occupied);
+					_out.attacked[_color] |= _attacks;
+					_out.mobility[_color][n] += static_cast<int>((_attacks & _available).count());
+					_out.king_zone_attacks[_color][n] += static_cast<int>((_attacks & _enemyZone).count());
+				};
+			};
+		};
+		return _out;
+	};
+
+
+
 	constexpr inline Rating bishop_complexity_v = 25;
 	constexpr inline Rating king_complexity_v	= 10;
 	constexpr inline Rating knight_complexity_v = 10;
@@ -78,10 +236,17 @@ namespace lbx::chess
 	*/
 	Rating rate_complexity(const BoardWithState& _board)
 	{
+		constexpr auto _pieces = std::array
+		{
+			Piece::pawn, Piece::knight, Piece::bishop, Piece::rook, Piece::queen, Piece::king
+		};
+
+		// Count from the bit boards rather than walking all 64 squares
 		Rating _sum{};
-		for (auto& s : _board | jc::views::filter(jc::unequals & Piece::empty))
+		for (auto& p : _pieces)
 		{
-			_sum += rate_complexity(s);
+			const auto _count = _board.count_pieces(p | Color::white) + _board.count_pieces(p | Color::black);
+			_sum += static_cast<Rating>(_count) * rate_complexity(p);
 		};
 		return _sum;
 	};
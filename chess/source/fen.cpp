@@ -202,6 +202,8 @@ namespace lbx::chess
 			std::from_chars(_fullMoveStr.data(), _fullMoveStr.data() + _fullMoveStr.size(), _board.full_move_counter);
 		};
 
+		// The Zobrist key was built up as each piece was placed on the empty board
+		_board.verify_incremental_state();
 		return _board;
 	};
 	
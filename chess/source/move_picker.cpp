@@ -0,0 +1,170 @@
+#include <lambdex/chess/move_picker.hpp>
+
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <span>
+#include <utility>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Gets a piece's rank for ordering captures, pawn is 1 and king is 7
+		*/
+		constexpr int piece_order_value(Piece _piece) noexcept
+		{
+			return jc::to_underlying(as_white(_piece)) >> 1;
+		};
+
+		static_assert(piece_order_value(Piece::empty) == 0);
+		static_assert(piece_order_value(Piece::pawn_black) < piece_order_value(Piece::knight_white));
+		static_assert(piece_order_value(Piece::queen) < piece_order_value(Piece::king_black));
+	};
+
+	/**
+	 * @brief Gets the most valuable victim / least valuable attacker score for a move.
+	 *
+	 * Higher scores should be searched first. Promotions count the promoted piece
+	 * as part of the victim, and en passant captures a pawn.
+	 *
+	 * @param _board Board the move will be made on
+	 * @param _move Capture or promotion
+	 * @return Ordering score
+	*/
+	int mvv_lva_score(const BoardWithState& _board, const Move& _move)
+	{
+		const auto _attacker = _board.get(_move.from);
+		auto _victim = _board.get(_move.to);
+
+		// Pawns only move diagonally onto an empty square when capturing en passant
+		if (_victim == Piece::empty && as_white(_attacker) == Piece::pawn && _move.from.file() != _move.to.file())
+		{
+			_victim = Piece::pawn;
+		};
+
+		const auto _gain = piece_order_value(_victim) + piece_order_value(_move.promotion);
+		return _gain * 8 - piece_order_value(_attacker);
+	};
+
+	/**
+	 * @brief Gets the next move
+	 * @return Next move, or nullopt once every legal move has been picked
+	*/
+	std::optional<Move> MovePicker::next()
+	{
+		switch (this->stage_)
+		{
+		case Stage::best_move:
+			this->stage_ = Stage::generate_captures;
+			if (this->best_move_ && this->is_best_move_legal())
+			{
+				return this->best_move_;
+			};
+			this->best_move_.reset();
+			[[fallthrough]];
+
+		case Stage::generate_captures:
+			this->count_ = generate_legal_moves<MoveGenType::captures>(*this->board_, this->moves_);
+			this->index_ = 0;
+			for (size_t n = 0; n != this->count_; ++n)
+			{
+				this->scores_[n] = mvv_lva_score(*this->board_, this->moves_[n]);
+			};
+			this->stage_ = Stage::captures;
+			[[fallthrough]];
+
+		case Stage::captures:
+			if (auto _move = this->pick_best_scored(); _move)
+			{
+				return _move;
+			};
+			this->stage_ = Stage::generate_quiets;
+			[[fallthrough]];
+
+		case Stage::generate_quiets:
+			this->count_ = generate_legal_moves<MoveGenType::quiets>(*this->board_, this->moves_);
+			this->index_ = 0;
+			this->stage_ = Stage::quiets;
+			[[fallthrough]];
+
+		case Stage::quiets:
+			if (auto _move = this->pick_in_order(); _move)
+			{
+				return _move;
+			};
+			this->stage_ = Stage::done;
+			[[fallthrough]];
+
+		case Stage::done:
+			return std::nullopt;
+
+		default:
+			JCLIB_ABORT();
+			return std::nullopt;
+		};
+	};
+
+	bool MovePicker::is_best_move_legal() const
+	{
+		// Anything the generator wouldn't give could be picked twice
+		return is_move_legal(*this->board_, *this->best_move_);
+	};
+
+	std::optional<Move> MovePicker::pick_best_scored()
+	{
+		while (this->index_ != this->count_)
+		{
+			// Selection sort one step at a time, most nodes only look at the first few
+			size_t _best = this->index_;
+			for (size_t n = this->index_ + 1; n != this->count_; ++n)
+			{
+				if (this->scores_[n] > this->scores_[_best])
+				{
+					_best = n;
+				};
+			};
+			std::swap(this->moves_[this->index_], this->moves_[_best]);
+			std::swap(this->scores_[this->index_], this->scores_[_best]);
+
+			const auto& _move = this->moves_[this->index_++];
+			if (_move != this->best_move_)
+			{
+				return _move;
+			};
+		};
+		return std::nullopt;
+	};
+
+	std::optional<Move> MovePicker::pick_in_order()
+	{
+		while (this->index_ != this->count_)
+		{
+			const auto& _move = this->moves_[this->index_++];
+			if (_move != this->best_move_)
+			{
+				return _move;
+			};
+		};
+		return std::nullopt;
+	};
+
+	/**
+	 * @brief Constructs the picker without a best move
+	 * @param _board Board to pick moves for
+	*/
+	MovePicker::MovePicker(const BoardWithState& _board) noexcept :
+		board_{ &_board },
+		best_move_{ std::nullopt }
+	{};
+
+	/**
+	 * @brief Constructs the picker
+	 * @param _board Board to pick moves for
+	 * @param _bestMove Move to try first, ignored if it isn't legal
+	*/
+	MovePicker::MovePicker(const BoardWithState& _board, const Move& _bestMove) noexcept :
+		board_{ &_board },
+		best_move_{ _bestMove }
+	{};
+};
@@ -1,5 +1,6 @@
 #include <lambdex/chess/move_validation.hpp>
 #include <lambdex/chess/piece_movement.hpp>
+#include <lambdex/chess/attacks.hpp>
 
 #include <lambdex/chess/board/piece_board.hpp>
 
@@ -124,7 +125,7 @@ namespace lbx::chess
 
 
 		// validation for a rook move, color independent
-		inline MoveValidity validate_move_rook_common(const PieceBoard& _board, const Move& _move, const Color& _player)
+		inline MoveValidity validate_move_rook_common(const BoardWithState& _board, const Move& _move, const Color& _player)
 		{
 			auto& _to = _move.to;
 			auto& _from = _move.from;
@@ -164,11 +165,11 @@ namespace lbx::chess
 			};
 		};
 
-		inline MoveValidity validate_move_rook_white(const PieceBoard& _board, const Move& _move, const Color& _player)
+		inline MoveValidity validate_move_rook_white(const BoardWithState& _board, const Move& _move, const Color& _player)
 		{
 			return validate_move_rook_common(_board, _move, _player);
 		};
-		inline MoveValidity validate_move_rook_black(const PieceBoard& _board, const Move& _move, const Color& _player)
+		inline MoveValidity validate_move_rook_black(const BoardWithState& _board, const Move& _move, const Color& _player)
 		{
 			return validate_move_rook_common(_board, _move, _player);
 		};
@@ -227,7 +228,7 @@ namespace lbx::chess
 			return validate_move_bishop_common(_board, _move, _player);
 		};
 
-		inline MoveValidity validate_move_queen_common(const PieceBoard& _board, const Move& _move, const Color& _player)
+		inline MoveValidity validate_move_queen_common(const BoardWithState& _board, const Move& _move, const Color& _player)
 		{
 			auto& _to = _move.to;
 			auto& _from = _move.from;
@@ -310,51 +311,67 @@ namespace lbx::chess
 			};
 		};
 
-		inline MoveValidity validate_move_king_common(const BoardWithState& _board, const Move& _move, const Color& _color)
+		// Checks if a king would be threatened on a square, the king is lifted off the board first
+		inline bool would_king_be_threatened(const BoardWithState& _board, PositionPair _king, PositionPair _square)
 		{
-			const auto& _from = _move.from;
-			const auto& _to = _move.to;
+			auto _occupied = _board.as_bits_with_pieces();
+			_occupied.reset(_king);
+			return square_attacked_by(_board, _square, !get_color(_board[_king]), _occupied).any();
+		};
+
+		// validation for castling, the king moves are already known to be to g or c
+		inline MoveValidity validate_castle(const BoardWithState& _board, const Move& _move, const Color& _color, bool _kingside)
+		{
+			const auto _homeRank = (_color == Color::white) ? Rank::r1 : Rank::r8;
+			const auto _rookPos = (_kingside) ? (File::h, _homeRank) : (File::a, _homeRank);
+			const auto _passPos = (_kingside) ? (File::f, _homeRank) : (File::d, _homeRank);
+
+			if (_move.from != (File::e, _homeRank) || _board[_rookPos] != (Piece::rook | _color))
+			{
+				return MoveValidity::illegal_piece_movement;
+			};
 
-			if (_to == (Rank::r4, File::h))
+			// Every square between the king and rook must be empty
+			const auto _path = make_bitboard_with_path(_homeRank, File::e, _rookPos.file());
+			auto _pieces = _board.as_bits_with_pieces();
+			_pieces.reset(_move.from);
+			_pieces.reset(_rookPos);
+			if ((_pieces & _path).any())
 			{
-				JCLIB_ASSERT(true);
+				return MoveValidity::other_piece_in_the_way;
 			};
 
+			// Cannot castle out of or through check, landing in check is caught by is_move_valid
+			if (would_king_be_threatened(_board, _move.from, _move.from) ||
+				would_king_be_threatened(_board, _move.from, _passPos))
+			{
+				return MoveValidity::king_in_check;
+			};
+
+			return MoveValidity::valid;
+		};
+
+		inline MoveValidity validate_move_king_common(const BoardWithState& _board, const Move& _move, const Color& _color)
+		{
+			const auto& _from = _move.from;
+			const auto& _to = _move.to;
+
 			const auto _horizontalDistance = distance(_from.file(), _to.file());
 			const auto _verticalDistance = distance(_from.rank(), _to.rank());
 
 			if (_horizontalDistance > 1 || _verticalDistance > 1)
 			{
 				// Check for castling
-				switch (_color)
-				{
-				case Color::white:
+				const auto _homeRank = (_color == Color::white) ? Rank::r1 : Rank::r8;
+				if (_to == (File::g, _homeRank) && _board.can_player_castle_kingside(_color))
 				{
-					if (_to == (File::g, Rank::r1) && _board.white_can_castle_kingside)
-					{
-						return MoveValidity::valid;
-					}
-					else if (_to == (File::c, Rank::r1) && _board.white_can_castle_queenside)
-					{
-						return MoveValidity::valid;
-					};
-				};
-				break;
-				case Color::black:
+					return validate_castle(_board, _move, _color, true);
+				}
+				else if (_to == (File::c, _homeRank) && _board.can_player_castle_queenside(_color))
 				{
-					if (_to == (File::g, Rank::r8) && _board.black_can_castle_kingside)
-					{
-						return MoveValidity::valid;
-					}
-					else if (_to == (File::c, Rank::r8) && _board.black_can_castle_queenside)
-					{
-						return MoveValidity::valid;
-					};
-				};
-				break;
+					return validate_castle(_board, _move, _color, false);
 				};
 
-
 				// King can only move 1 square at a time
 				return MoveValidity::illegal_piece_movement;
 			};
@@ -422,8 +439,10 @@ namespace lbx::chess
 			}
 			else if (_horizontalDistance == 1)
 			{
-				// Check that this is a capture
-				if (_board[_to] == Piece::empty || get_color(_board[_to]) == _color)
+				// Check that this is a capture, or an en passant capture
+				const bool _isEnPassant = _board[_to] == Piece::empty &&
+					_board.has_en_passant() && _board.get_en_passant() == Position{ _to };
+				if (!_isEnPassant && (_board[_to] == Piece::empty || get_color(_board[_to]) == _color))
 				{
 					// Illegal move
 					return MoveValidity::illegal_piece_movement;
@@ -493,8 +512,10 @@ namespace lbx::chess
 			}
 			else if (_horizontalDistance == 1)
 			{
-				// Check if this is a diagonal capture
-				if (_board[_to] == Piece::empty || get_color(_board[_to]) == _color)
+				// Check if this is a diagonal capture, or an en passant capture
+				const bool _isEnPassant = _board[_to] == Piece::empty &&
+					_board.has_en_passant() && _board.get_en_passant() == Position{ _to };
+				if (!_isEnPassant && (_board[_to] == Piece::empty || get_color(_board[_to]) == _color))
 				{
 					// Illegal move
 					return MoveValidity::illegal_piece_movement;
@@ -520,178 +541,33 @@ namespace lbx::chess
 	 * @brief Determines if a piece is being immediately threatened by an enemy piece
 	 * @param _board Board to check on
 	 * @param _position Position of the piece to check for threat
-	 * @return Position of the enemy piece that is directly threatening this piece, or nullopt if there isnt one
+	 * @return Position of an enemy piece that is directly threatening this piece, or nullopt if there isnt one
 	*/
-	std::optional<PositionPair> is_piece_threatened(const PieceBoard& _board, PositionPair _position)
+	std::optional<PositionPair> is_piece_threatened(const BoardWithState& _board, PositionPair _position)
 	{
 		const auto _piece = _board[_position];
 		JCLIB_ASSERT(_piece != Piece::empty);
-		const auto _pieceColor = get_color(_piece);
-
-
-		struct FoundPiece
-		{
-			PositionPair pos;
-			
-			/**
-			 * @brief The piece type, always white
-			*/
-			Piece piece;
-		};
 
-		// Buffer for holding where the opponent's pieces are 
-		std::array<FoundPiece, 16> _opponentPiecesBuffer{};
-		size_t _opponentPieceCount = 0;
-		
-		// Find opponent pieces before doing threat checks
-		{
-			auto it = _opponentPiecesBuffer.begin();
-			for (Position _squarePos{}; _squarePos != Position::end(); ++_squarePos)
-			{
-				auto& _square = _board[_squarePos];
-				if (_square != Piece::empty && _pieceColor != get_color(_square))
-				{
-					it->piece = as_white(_square);
-					it->pos = _squarePos;
-					++it;
-					++_opponentPieceCount;
-				};
-			};
-		};
-
-		const auto _opponentPieces = std::span<FoundPiece>
+		const auto _attackers = square_attacked_by(_board, _position, !get_color(_piece));
+		if (_attackers.any())
 		{
-			_opponentPiecesBuffer.data(), _opponentPieceCount
-		};
-
-		for (auto& _opponentPiece : _opponentPieces)
+			return _attackers.first();
+		}
+		else
 		{
-			auto& _squarePiece = _opponentPiece.piece;
-			const auto _squarePosPair = PositionPair{ _opponentPiece.pos };
-
-			switch (_squarePiece)
-			{
-			case Piece::bishop:
-			{
-				const auto _movementType = classify_movement(_squarePosPair, _position);
-				if (_movementType == MovementClass::diagonal)
-				{
-					// Determine if a piece is in the path
-					auto _collidePos = find_piece_in_path(_board, _squarePosPair, _position, _movementType);
-					if (!_collidePos)
-					{
-						// Found threat!
-						return _squarePosPair;
-					};
-				};
-			};
-			break;
-			case Piece::queen:
-			{
-				const auto _movementType = classify_movement(_squarePosPair, _position);
-				if (_movementType != MovementClass::invalid)
-				{
-					// Determine if a piece is in the path
-					auto _collidePos = find_piece_in_path(_board, _squarePosPair, _position, _movementType);
-					if (!_collidePos)
-					{
-						// Found threat!
-						return _squarePosPair;
-					};
-				};
-			};
-			break;
-			case Piece::rook:
-			{
-				const auto _movementType = classify_movement(_squarePosPair, _position);
-				if (_movementType == MovementClass::rank || _movementType == MovementClass::file)
-				{
-					// Determine if a piece is in the path
-					auto _collidePos = find_piece_in_path(_board, _squarePosPair, _position, _movementType);
-					if (!_collidePos)
-					{
-						// Found threat!
-						return _squarePosPair;
-					};
-				};
-			};
-			break;
-			case Piece::knight:
-			{
-				// The position offsets for where the knight can move
-				constexpr auto _offendingOffsets = std::array
-				{
-					PositionPair_Offset{ +2, +1 },
-					PositionPair_Offset{ +1, +2 },
-					PositionPair_Offset{ -2, -1 },
-					PositionPair_Offset{ -1, -2 },
-					PositionPair_Offset{ -2, +1 },
-					PositionPair_Offset{ -1, +2 },
-					PositionPair_Offset{ +2, -1 },
-					PositionPair_Offset{ +1, -2 }
-				};
-					
-				// Determine if the pieces are offset such that the knight can hit the piece
-				const auto _offset = _squarePosPair - _position;
-				if (jc::contains(_offendingOffsets, _offset))
-				{
-					return _opponentPiece.pos;
-				};
-			};
-			break;
-			case Piece::pawn:
-			{
-				const auto _pawnColor = !_pieceColor;
-				if (_pawnColor == Color::white)
-				{
-					// Look for diagonal + 1 capture
-					if ((_squarePosPair.file() != File::h) &&
-						(_position == (_squarePosPair.rank() + 1, _squarePosPair.file() + 1)))
-					{
-						// Pawn would take
-						return _squarePosPair;
-					};
-					if ((_squarePosPair.file() != File::a) &&
-						(_position == (_squarePosPair.rank() + 1, _squarePosPair.file() - 1)))
-					{
-						// Pawn would take
-						return _squarePosPair;
-					};
-				}
-				else if (_pawnColor == Color::black)
-				{
-					// Look for diagonal - 1 capture
-					if ((_squarePosPair.file() != File::h) && (_squarePosPair.rank() != Rank::r1) &&
-						(_position == (_squarePosPair.rank() - 1, _squarePosPair.file() + 1)))
-					{
-						// Pawn would take
-						return _squarePosPair;
-					};
-					if ((_squarePosPair.file() != File::a) && (_squarePosPair.rank() != Rank::r1) &&
-						(_position == (_squarePosPair.rank() - 1, _squarePosPair.file() - 1)))
-					{
-						// Pawn would take
-						return _squarePosPair;
-					};
-				};
-			};
-			break;
-			case Piece::king:
-			{
-				if (distance(_squarePosPair.file(), _position.file()) <= 1 &&
-					distance(_squarePosPair.rank(), _position.rank()) <= 1)
-				{
-					// King is threatening
-					return _opponentPiece.pos;
-				};
-			};
-			break;
-			default:
-				break;
-			}
+			return std::nullopt;
 		};
+	};
 
-		return std::nullopt;
+	/**
+	 * @brief Determines if a piece is being immediately threatened by an enemy piece
+	 * @param _board Board to check on
+	 * @param _position Position of the piece to check for threat
+	 * @return Position of an enemy piece that is directly threatening this piece, or nullopt if there isnt one
+	*/
+	std::optional<PositionPair> is_piece_threatened(const PieceBoard& _board, PositionPair _position)
+	{
+		return is_piece_threatened(BoardWithState{ _board }, _position);
 	};
 
 	/**
@@ -843,15 +719,11 @@ namespace lbx::chess
 			_kingPiece = Piece::king_black;
 		};
 
-		auto _king = _checkTestBoard.find(_kingPiece);
-		if (_king)
+		const auto _king = _checkTestBoard.as_bits_with_pieces(_kingPiece);
+		if (_king.any() && square_attacked_by(_checkTestBoard, _king.first(), !_player).any())
 		{
-			auto _threatenedByPiece = is_piece_threatened(_checkTestBoard, _king.value());
-			if (_threatenedByPiece)
-			{
-				// King is in check! Move is not valid!
-				return MoveValidity::king_in_check;
-			};
+			// King is in check! Move is not valid!
+			return MoveValidity::king_in_check;
 		};
 
 		return MoveValidity::valid;
@@ -0,0 +1,101 @@
+#include <lambdex/chess/pawn_structure.hpp>
+
+#include <bit>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		constexpr BitBoard::binary_type file_a_bits_v = 0x0101010101010101ull;
+
+		/**
+		 * @brief Gets the squares of a file
+		*/
+		constexpr BitBoard file_bits(int _file) noexcept
+		{
+			return BitBoard{ file_a_bits_v << _file };
+		};
+
+		/**
+		 * @brief Gets the squares of the files either side of a file
+		*/
+		constexpr BitBoard neighbour_file_bits(int _file) noexcept
+		{
+			BitBoard _out{};
+			if (_file != 0) { _out |= file_bits(_file - 1); };
+			if (_file != 7) { _out |= file_bits(_file + 1); };
+			return _out;
+		};
+
+		/**
+		 * @brief Scores one player's pawns
+		*/
+		Rating score_pawns(BitBoard _pawns, BitBoard _enemyPawns, Color _player, const PawnStructureWeights& _weights, BitBoard& _passed)
+		{
+			Rating _score = 0;
+			for (int f = 0; f != 8; ++f)
+			{
+				const auto _onFile = static_cast<Rating>((_pawns & file_bits(f)).count());
+				if (_onFile == 0)
+				{
+					continue;
+				};
+				_score += (_onFile - 1) * _weights.doubled;
+				if ((_pawns & neighbour_file_bits(f)).none())
+				{
+					_score += _onFile * _weights.isolated;
+				};
+			};
+
+			const auto _color = jc::to_underlying(_player);
+			auto _remaining = _pawns;
+			while (_remaining.any())
+			{
+				const auto _pos = _remaining.pop_first();
+				const auto& _mask = passed_pawn_masks[_color][_pos.get()];
+
+				// Only the front pawn of a doubled pair counts as passed
+				const auto _ahead = _mask & file_bits(_pos.get() % 8);
+				if ((_enemyPawns & _mask).none() && (_pawns & _ahead).none())
+				{
+					_passed.set(_pos);
+					const auto _rank = _pos.get() / 8;
+					_score += _weights.passed[(_player == Color::white) ? _rank : 7 - _rank];
+				};
+			};
+			return _score;
+		};
+	};
+
+	/**
+	 * @brief Evaluates the pawn structure from scratch
+	 * @param _board Board to evaluate
+	 * @param _weights Rating weights
+	 * @return Pawn structure
+	*/
+	PawnStructure evaluate_pawn_structure(const BoardWithState& _board, const PawnStructureWeights& _weights)
+	{
+		const auto _white = _board.as_bits_with_pieces(Piece::pawn | Color::white);
+		const auto _black = _board.as_bits_with_pieces(Piece::pawn | Color::black);
+
+		PawnStructure _out{};
+		_out.score[jc::to_underlying(Color::white)] =
+			score_pawns(_white, _black, Color::white, _weights, _out.passed[jc::to_underlying(Color::white)]);
+		_out.score[jc::to_underlying(Color::black)] =
+			score_pawns(_black, _white, Color::black, _weights, _out.passed[jc::to_underlying(Color::black)]);
+		return _out;
+	};
+
+	/**
+	 * @brief Allocates the table
+	 * @param _entries Number of entries, rounded down to a power of two
+	 * @param _weights Weights used to evaluate pawn structures
+	*/
+	PawnHashTable::PawnHashTable(size_t _entries, PawnStructureWeights _weights) :
+		weights_{ _weights }
+	{
+		const auto _count = std::bit_floor(std::max<size_t>(_entries, 1));
+		this->entries_ = std::make_unique<Entry[]>(_count);
+		this->mask_ = _count - 1;
+	};
+};
@@ -1,198 +1,475 @@
 #include <lambdex/chess/piece_movement.hpp>
-#include <lambdex/chess/move_validation.hpp>
+#include <lambdex/chess/attacks.hpp>
 
 namespace lbx::chess
 {
+	namespace
+	{
+		/**
+		 * @brief Writes moves into a buffer, dropping any that don't fit
+		*/
+		class MoveWriter
+		{
+		public:
+
+			void push(Move _move) noexcept
+			{
+				if (this->count_ != this->buffer_.size())
+				{
+					this->buffer_[this->count_] = _move;
+					++this->count_;
+				};
+			};
+
+			void push(Position _from, BitBoard _to) noexcept
+			{
+				while (_to.any())
+				{
+					this->push(Move{ _from, _to.pop_first() });
+				};
+			};
+
+			size_t count() const noexcept
+			{
+				return this->count_;
+			};
+
+			explicit MoveWriter(std::span<Move> _buffer) noexcept :
+				buffer_{ _buffer }
+			{};
+
+		private:
+			std::span<Move> buffer_;
+			size_t count_ = 0;
+		};
+
+		/**
+		 * @brief Checks that the rook is home, the squares between king and rook are empty,
+		 * and the king doesn't pass through or land on an attacked square.
+		 * 
+		 * The castling flag isn't checked and the king must not be in check.
+		*/
+		inline bool is_castle_open(const BoardWithState& _board, Position _king, Position _rook,
+			Position _kingTo, Position _kingPass, BitBoard _occupied)
+		{
+			const auto _us = _board.turn;
+			return _board.get(_rook) == (Piece::rook | _us) &&
+				(between_squares(_king, _rook) & _occupied).none() &&
+				square_attacked_by(_board, _kingPass, !_us, _occupied).none() &&
+				square_attacked_by(_board, _kingTo, !_us, _occupied).none();
+		};
+
+		/**
+		 * @brief Adds a castling move if the flag is set and is_castle_open() allows it.
+		 * 
+		 * The king must not be in check.
+		*/
+		inline void generate_castle(const BoardWithState& _board, MoveWriter& _out, Position _king, Position _rook,
+			Position _kingTo, Position _kingPass, BitBoard _occupied)
+		{
+			if (is_castle_open(_board, _king, _rook, _kingTo, _kingPass, _occupied))
+			{
+				_out.push(Move{ _king, _kingTo });
+			};
+		};
+	};
+
 	/**
-	 * @brief Finds all possible moves for a given chess board.
+	 * @brief Generates the legal moves for the player who's turn it is.
 	 *
-	 * This will find the moves that the player who's turn it is currently can play.
-	 * ie. "BoardWithState::turn"
+	 * Pins and checks are worked out once for the position so no move needs to be
+	 * applied to a copy of the board to see if it leaves the king in check. Pawns
+	 * reaching the back rank produce one move for each promotion piece.
+	 *
+	 * If the buffer fills up the remaining moves are dropped.
 	 *
+	 * @tparam Type Which subset of the legal moves to generate
 	 * @param _board Chess board with state.
 	 * @param _moveBuffer Output variable for where to write the found moves to.
 	 *
-	 * @return Number of moves found.
+	 * @return Number of moves written.
 	*/
-	size_t find_possible_moves(const BoardWithState& _board, std::span<Move> _moveBuffer)
+	template <MoveGenType Type>
+	size_t generate_legal_moves(const BoardWithState& _board, std::span<Move> _moveBuffer)
 	{
-		JCLIB_ASSERT(!_moveBuffer.empty());
-		
-		// Loop through all non-empty squares (so pieces) and check for valid moves
-		Position _from{};
+		constexpr bool _wantCaptures = Type != MoveGenType::quiets;
+		constexpr bool _wantQuiets = Type != MoveGenType::captures;
 
-		// Output iterator
-		auto _moveIter = _moveBuffer.begin();
+		const auto _us = _board.turn;
+		const auto _them = !_us;
+		const auto _occupied = _board.as_bits_with_pieces();
+		const auto _theirs = _board.as_bits_with_pieces(_them);
 
-		// Adds a move to the output move vector if it is valid
-		// 
-		// @param _to Where the move is to
-		// 
-		// @return True unless there is no more room in the move output buffer.
-		const auto add_if_valid = [&](PositionPair _to)
+		// Squares that pieces may end up on for the moves being generated
+		BitBoard _targets{};
+		if constexpr (_wantCaptures)
 		{
-			Move _move{ _from, _to };
-			const auto _validity = chess::is_move_valid(_board, _move, _board.turn);
-			if (_validity == MoveValidity::valid)
-			{
-				// Add to set of moves to attempt
-				*_moveIter = _move;
-				++_moveIter;
-			};
-
-			// Check if there is room for more moves
-			return _moveIter != _moveBuffer.end();
+			_targets |= _theirs;
+		};
+		if constexpr (_wantQuiets)
+		{
+			_targets |= ~_occupied;
 		};
 
-		// Loop through all of our pieces
-		for (auto& s : _board)
+		MoveWriter _out{ _moveBuffer };
+
+		// Squares that block a check, or every square if not in check
+		auto _checkMask = ~BitBoard{};
+		BitBoard _pinned{};
+		Position _king{};
+
+		// Boards without a king are allowed for testing, there is nothing to check or pin
+		const auto _kingBits = _board.as_bits_with_pieces(Piece::king | _us);
+		if (_kingBits.any())
 		{
-			if (s != Piece::empty && chess::get_color(s) == _board.turn)
+			_king = _kingBits.first();
+			const auto _checkers = square_attacked_by(_board, _king, _them, _occupied);
+
+			// Lift the king off the board so it can't hide from a slider behind itself
+			const auto _withoutKing = _occupied ^ _kingBits;
+			auto _kingTargets = king_attacks(_king) & _targets;
+			while (_kingTargets.any())
 			{
-				switch (s)
+				const auto _to = _kingTargets.pop_first();
+				if (square_attacked_by(_board, _to, _them, _withoutKing).none())
 				{
-				case Piece::rook_white: [[fallthrough]];
-				case Piece::rook_black:
+					_out.push(Move{ _king, _to });
+				};
+			};
+
+			if (_checkers.count() > 1)
+			{
+				// Double check, only the king can move
+				return _out.count();
+			}
+			else if (_checkers.any())
+			{
+				_checkMask = between_squares(_king, _checkers.first()) | _checkers;
+			}
+			else if constexpr (_wantQuiets)
+			{
+				const auto _homeRank = (_us == Color::white) ? Rank::r1 : Rank::r8;
+				if (_king == Position{ (File::e, _homeRank) })
 				{
-					PositionPair _pair{ _from };
-					for (File f = File::a; f != File::END; ++f)
+					if (_board.can_player_castle_kingside(_us))
 					{
-						add_if_valid((_pair.rank(), f));
+						generate_castle(_board, _out, _king, (File::h, _homeRank),
+							(File::g, _homeRank), (File::f, _homeRank), _occupied);
 					};
-					for (Rank r = Rank::r1; r != Rank::END; ++r)
+					if (_board.can_player_castle_queenside(_us))
 					{
-						add_if_valid((r, _pair.file()));
+						generate_castle(_board, _out, _king, (File::a, _homeRank),
+							(File::c, _homeRank), (File::d, _homeRank), _occupied);
 					};
 				};
-				break;
+			};
 
-				case Piece::knight_white: [[fallthrough]];
-				case Piece::knight_black:
+			// Enemy sliders that would see the king if exactly one of our pieces moved
+			auto _snipers =
+				(rook_attacks(_king, _theirs) & _board.orthogonal_sliders(_them)) |
+				(bishop_attacks(_king, _theirs) & _board.diagonal_sliders(_them));
+			while (_snipers.any())
+			{
+				const auto _blockers = between_squares(_king, _snipers.pop_first()) & _occupied;
+				if (_blockers.count() == 1)
 				{
-					const auto _positions = get_possible_move_positions_knight(_board, _from);
-					for (auto& p : _positions)
-					{
-						add_if_valid(p);
-					};
+					_pinned |= _blockers;
 				};
-				break;
+			};
+		};
 
-				case Piece::king_white: [[fallthrough]];
-				case Piece::king_black:
-				{
-					constexpr auto _offsets = std::array
-					{
-						PositionPair_Offset{  1,  1 },
-						PositionPair_Offset{  0,  1 },
-						PositionPair_Offset{ -1,  1 },
+		// Restricts a piece's destinations to those that keep the king safe
+		const auto legal_targets = [&](Position _from, BitBoard _to)
+		{
+			_to &= _checkMask;
+			if (_pinned.at(_from))
+			{
+				_to &= line_through(_king, _from);
+			};
+			return _to;
+		};
 
-						PositionPair_Offset{  1,  0 },
-						PositionPair_Offset{ -1,  0 },
+		// Pinned knights can never move
+		auto _knights = _board.as_bits_with_pieces(Piece::knight | _us) & ~_pinned;
+		while (_knights.any())
+		{
+			const auto _from = _knights.pop_first();
+			_out.push(_from, knight_attacks(_from) & _targets & _checkMask);
+		};
 
-						PositionPair_Offset{  1, -1 },
-						PositionPair_Offset{  0, -1 },
-						PositionPair_Offset{ -1, -1 },
-					};
-					for (auto& o : _offsets)
+		// Queens are covered by both of these
+		auto _diagonals = _board.diagonal_sliders(_us);
+		while (_diagonals.any())
+		{
+			const auto _from = _diagonals.pop_first();
+			_out.push(_from, legal_targets(_from, bishop_attacks(_from, _occupied) & _targets));
+		};
+		auto _orthogonals = _board.orthogonal_sliders(_us);
+		while (_orthogonals.any())
+		{
+			const auto _from = _orthogonals.pop_first();
+			_out.push(_from, legal_targets(_from, rook_attacks(_from, _occupied) & _targets));
+		};
+
+		// Pawns
+		{
+			const bool _white = _us == Color::white;
+			const auto _promotionRank = bits_in_rank(_white ? Rank::r8 : Rank::r1);
+			const auto _startRank = bits_in_rank(_white ? Rank::r2 : Rank::r7);
+			const auto step_forward = [_white](Position _pos)
+			{
+				return (_white) ? _pos + 8 : _pos - 8;
+			};
+
+			auto _pawns = _board.as_bits_with_pieces(Piece::pawn | _us) & ~_promotionRank;
+			while (_pawns.any())
+			{
+				const auto _from = _pawns.pop_first();
+
+				BitBoard _to = pawn_attacks(_us, _from) & _theirs;
+				const auto _single = step_forward(_from);
+				if (!_occupied.at(_single))
+				{
+					_to.set(_single);
+					if (_startRank.at(_from) && !_occupied.at(step_forward(_single)))
 					{
-						const auto _unboundedDest = PositionPair_Unbounded{ _from } + o;
-						if (_unboundedDest.is_within_bounds())
-						{
-							add_if_valid(_unboundedDest);
-						};
+						_to.set(step_forward(_single));
 					};
 				};
-				break;
+				_to = legal_targets(_from, _to);
 
-				case Piece::bishop_white: [[fallthrough]];
-				case Piece::bishop_black:
+				if constexpr (_wantCaptures)
 				{
-					// TODO: Improve this
-
-					// Find all diagonal movements
-					for (Position _to = Position{}; _to != Position::end(); ++_to)
+					auto _promotions = _to & _promotionRank;
+					while (_promotions.any())
 					{
-						if (classify_movement(_from, _to) == MovementClass::diagonal)
+						const auto _promoTo = _promotions.pop_first();
+						for (auto _promo : { Piece::queen, Piece::rook, Piece::bishop, Piece::knight })
 						{
-							add_if_valid(_to);
+							_out.push(Move{ _from, _promoTo, _promo });
 						};
 					};
 				};
-				break;
+				_out.push(_from, _to & ~_promotionRank & _targets);
+			};
 
-				case Piece::queen_white: [[fallthrough]];
-				case Piece::queen_black:
+			if constexpr (_wantCaptures)
+			{
+				if (_board.has_en_passant())
 				{
-					// TODO: Improve this
-
-					// Find all file, rank, or diagonal movements
-					for (Position _to = Position{}; _to != Position::end(); ++_to)
+					const auto _enPassant = _board.get_en_passant();
+					const auto _captured = (_white) ? _enPassant - 8 : _enPassant + 8;
+					if (_board.get(_captured) == (Piece::pawn | _them))
 					{
-						if (classify_movement(_from, _to) != MovementClass::invalid)
+						BitBoard _capturedBits{};
+						_capturedBits.set(_captured);
+
+						auto _capturers = pawn_attacks(_them, _enPassant) & _board.as_bits_with_pieces(Piece::pawn | _us);
+						while (_capturers.any())
 						{
-							add_if_valid(_to);
+							const auto _from = _capturers.pop_first();
+
+							// Two pawns leave the rank at once so check the resulting position directly
+							auto _after = _occupied ^ _capturedBits;
+							_after.reset(_from);
+							_after.set(_enPassant);
+							if (_kingBits.none() || (square_attacked_by(_board, _king, _them, _after) & ~_capturedBits).none())
+							{
+								_out.push(Move{ _from, _enPassant });
+							};
 						};
 					};
 				};
-				break;
+			};
+		};
 
-				case Piece::pawn_black:
-				{
-					PositionPair _pair{ _from };
+		return _out.count();
+	};
 
-					// Look ahead 2
-					bool _lookAhead2 = _pair.rank() == Rank::r7;
+	template size_t generate_legal_moves<MoveGenType::captures>(const BoardWithState&, std::span<Move>);
+	template size_t generate_legal_moves<MoveGenType::quiets>(const BoardWithState&, std::span<Move>);
+	template size_t generate_legal_moves<MoveGenType::all>(const BoardWithState&, std::span<Move>);
 
-					if (_pair.file() != File::a)
-					{
-						add_if_valid((_pair.rank() - 1, _pair.file() - 1));
-					};
-					if (_pair.file() != File::h)
-					{
-						add_if_valid((_pair.rank() - 1, _pair.file() + 1));
-					};
+	/**
+	 * @brief Checks if a move is one of the moves generate_legal_moves() would give.
+	 *
+	 * Meant for moves that come from somewhere other than the generator, like a
+	 * transposition table, without generating every move to look for it. The king's
+	 * safety is checked by looking for attackers with the move's occupancy, so
+	 * nothing is applied to a copy of the board.
+	 *
+	 * @param _board Chess board with state.
+	 * @param _move Move for the player who's turn it is.
+	 *
+	 * @return True if the move is legal.
+	*/
+	bool is_move_legal(const BoardWithState& _board, const Move& _move)
+	{
+		if (!_move.from.good() || !_move.to.good() || _move.from == _move.to)
+		{
+			return false;
+		};
 
-					add_if_valid((_pair.rank() - 1, _pair.file()));
-					if (_lookAhead2)
-					{
-						add_if_valid((_pair.rank() - 2, _pair.file()));
-					};
-				};
-				break;
-				case Piece::pawn_white:
-				{
-					PositionPair _pair{ _from };
+		const Position _from = _move.from;
+		const Position _to = _move.to;
+		const auto _us = _board.turn;
+		const auto _them = !_us;
+		const auto _piece = _board.get(_from);
+		if (_piece == Piece::empty || get_color(_piece) != _us || _board.as_bits_with_pieces(_us).at(_to))
+		{
+			return false;
+		};
 
-					// Look ahead 2
-					bool _lookAhead2 = _pair.rank() == Rank::r2;
+		// The generator always names the promotion piece
+		const bool _white = _us == Color::white;
+		const auto _promotionRank = bits_in_rank(_white ? Rank::r8 : Rank::r1);
+		if (as_white(_piece) == Piece::pawn && _promotionRank.at(_to))
+		{
+			const auto _promotion = _move.promotion;
+			if (_promotion != Piece::queen && _promotion != Piece::rook &&
+				_promotion != Piece::bishop && _promotion != Piece::knight)
+			{
+				return false;
+			};
+		}
+		else if (_move.promotion != Piece::empty)
+		{
+			return false;
+		};
 
-					if (_pair.file() != File::a)
-					{
-						add_if_valid((_pair.rank() + 1, _pair.file() - 1));
-					};
-					if (_pair.file() != File::h)
-					{
-						add_if_valid((_pair.rank() + 1, _pair.file() + 1));
-					};
+		const auto _occupied = _board.as_bits_with_pieces();
+		const auto _theirs = _board.as_bits_with_pieces(_them);
+		const auto _kingBits = _board.as_bits_with_pieces(Piece::king | _us);
+
+		// Squares emptied by the move other than the one moved from
+		BitBoard _captured{};
+		_captured.set(_to);
+
+		switch (as_white(_piece))
+		{
+		case Piece::king:
+		{
+			if (king_attacks(_from).at(_to))
+			{
+				// Lift the king off the board so it can't hide from a slider behind itself
+				return square_attacked_by(_board, _to, _them, _occupied ^ _kingBits).none();
+			};
 
-					add_if_valid((_pair.rank() + 1, _pair.file()));
-					if (_lookAhead2)
+			const auto _homeRank = (_white) ? Rank::r1 : Rank::r8;
+			if (_from != Position{ (File::e, _homeRank) } || square_attacked_by(_board, _from, _them, _occupied).any())
+			{
+				return false;
+			};
+			if (_to == Position{ (File::g, _homeRank) })
+			{
+				return _board.can_player_castle_kingside(_us) &&
+					is_castle_open(_board, _from, (File::h, _homeRank), _to, (File::f, _homeRank), _occupied);
+			}
+			else if (_to == Position{ (File::c, _homeRank) })
+			{
+				return _board.can_player_castle_queenside(_us) &&
+					is_castle_open(_board, _from, (File::a, _homeRank), _to, (File::d, _homeRank), _occupied);
+			};
+			return false;
+		}
+		case Piece::knight:
+			if (!knight_attacks(_from).at(_to))
+			{
+				return false;
+			};
+			break;
+		case Piece::bishop:
+			if (!bishop_attacks(_from, _occupied).at(_to))
+			{
+				return false;
+			};
+			break;
+		case Piece::rook:
+			if (!rook_attacks(_from, _occupied).at(_to))
+			{
+				return false;
+			};
+			break;
+		case Piece::queen:
+			if (!queen_attacks(_from, _occupied).at(_to))
+			{
+				return false;
+			};
+			break;
+		case Piece::pawn:
+		{
+			const auto step_forward = [_white](Position _pos)
+			{
+				return (_white) ? _pos + 8 : _pos - 8;
+			};
+			const auto _single = step_forward(_from);
+			const auto _startRank = bits_in_rank(_white ? Rank::r2 : Rank::r7);
+			if (pawn_attacks(_us, _from).at(_to))
+			{
+				if (!_theirs.at(_to))
+				{
+					// Only en passant captures onto an empty square
+					const auto _enPassantCapture = (_white) ? _to - 8 : _to + 8;
+					if (!_board.has_en_passant() || _board.get_en_passant() != _to ||
+						_board.get(_enPassantCapture) != (Piece::pawn | _them))
 					{
-						add_if_valid((_pair.rank() + 2, _pair.file()));
+						return false;
 					};
+					_captured.set(_enPassantCapture);
 				};
-				break;
-
-				default:
-					JCLIB_ABORT();
-					break;
+			}
+			else if (_to == _single)
+			{
+				if (_occupied.at(_to))
+				{
+					return false;
+				};
+			}
+			else if (_startRank.at(_from) && _to == step_forward(_single))
+			{
+				if (_occupied.at(_single) || _occupied.at(_to))
+				{
+					return false;
 				};
+			}
+			else
+			{
+				return false;
 			};
-			++_from;
+			break;
+		}
+		default:
+			return false;
 		};
 
-		// Return moves written
-		return std::distance(_moveBuffer.begin(), _moveIter);
+		// Boards without a king are allowed for testing, there is nothing to check or pin
+		if (_kingBits.none())
+		{
+			return true;
+		};
+
+		// Covers pins and checks at once, anything left attacking the king after the move makes it illegal
+		auto _after = (_occupied & ~_captured);
+		_after.reset(_from);
+		_after.set(_to);
+		return (square_attacked_by(_board, _kingBits.first(), _them, _after) & ~_captured).none();
+	};
+
+	/**
+	 * @brief Finds all possible moves for a given chess board.
+	 *
+	 * This will find the moves that the player who's turn it is currently can play.
+	 * ie. "BoardWithState::turn"
+	 *
+	 * @param _board Chess board with state.
+	 * @param _moveBuffer Output variable for where to write the found moves to.
+	 *
+	 * @return Number of moves found.
+	*/
+	size_t find_possible_moves(const BoardWithState& _board, std::span<Move> _moveBuffer)
+	{
+		JCLIB_ASSERT(!_moveBuffer.empty());
+		return generate_legal_moves<MoveGenType::all>(_board, _moveBuffer);
 	};
 
 	/**
@@ -203,18 +480,13 @@ namespace lbx::chess
 	 *
 	 * @param _board Chess board with state.
 	 *
-	 * @return Vector containing moves found.
+	 * @return List containing moves found, scores are left at 0.
 	*/
-	lbx::arena<Move> find_possible_moves(const BoardWithState& _board)
+	MoveList find_possible_moves(const BoardWithState& _board)
 	{
-		// Create a buffer for storing the moves
-		constexpr size_t buffer_size = 128;
-		std::array<Move, buffer_size> _moves{};
-		
-		const auto _count = find_possible_moves(_board, _moves);
-		JCLIB_ASSERT(_count < buffer_size);
-		
-		return arena<Move>{ _moves.begin(), _moves.begin() + _count };
+		MoveList _moves{};
+		_moves.resize(find_possible_moves(_board, _moves.storage()));
+		return _moves;
 	};
 
 };
\ No newline at end of file
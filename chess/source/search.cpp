@@ -0,0 +1,88 @@
+#include <lambdex/chess/search.hpp>
+
+#include <lambdex/chess/see.hpp>
+#include <lambdex/chess/endgame.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <array>
+#include <utility>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Gets the moves the quiescence search looks at, captures and promotions that don't lose
+	 * material by static exchange, in MVV-LVA order
+	 * @param _board Board to get moves for
+	 * @param _moveBuffer Where to write the moves
+	 * @return Number of moves written
+	*/
+	size_t generate_quiescence_moves(const BoardWithState& _board, std::span<Move> _moveBuffer)
+	{
+		std::array<Move, 256> _captures;
+		const auto _generated = generate_legal_moves<MoveGenType::captures>(_board, _captures);
+
+		std::array<int, 256> _scores;
+		size_t _count = 0;
+		for (size_t n = 0; n != _generated; ++n)
+		{
+			if (!is_losing_capture(_board, _captures[n]))
+			{
+				_moveBuffer[_count] = _captures[n];
+				_scores[_count] = mvv_lva_score(_board, _captures[n]);
+				++_count;
+			};
+		};
+
+		// Insertion sort, there are rarely more than a handful
+		for (size_t n = 1; n < _count; ++n)
+		{
+			for (size_t i = n; i != 0 && _scores[i - 1] < _scores[i]; --i)
+			{
+				std::swap(_scores[i - 1], _scores[i]);
+				std::swap(_moveBuffer[i - 1], _moveBuffer[i]);
+			};
+		};
+		return _count;
+	};
+
+	/**
+	 * @brief Picks how deep to search a board, deeper as the board gets simpler, see rate_complexity()
+	 * @param _board Board to pick a depth for
+	 * @return Search depth in plies
+	*/
+	size_t search_depth_for_board(const BoardWithState& _board)
+	{
+		// Pawns count towards the complexity, a pawn race branches as much as a few minor pieces
+		const auto _complexity = rate_complexity(_board);
+
+		size_t _depth = 3;
+		if (_complexity <= 50)
+		{
+			_depth = 7;
+		}
+		else if (_complexity <= 100)
+		{
+			_depth = 6;
+		}
+		else if (_complexity <= 150)
+		{
+			_depth = 5;
+		}
+		else if (_complexity <= 500)
+		{
+			_depth = 4;
+		}
+		else
+		{
+			_depth = 3;
+		};
+
+		// Known endgames are rated as won or drawn straight away, there is nothing to gain from going deep
+		if (find_endgame(_board))
+		{
+			_depth = std::min<size_t>(_depth, 4);
+		};
+
+		return _depth;
+	};
+};
@@ -0,0 +1,133 @@
+#include <lambdex/chess/see.hpp>
+
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/apply_move.hpp>
+
+#include <array>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Finds a player's least valuable piece out of a set of attackers
+		 * @param _board Board the attackers are on
+		 * @param _attackers Attacking pieces still on the board
+		 * @param _player Player to pick an attacker for
+		 * @param _piece Set to the piece found
+		 * @return Square of the piece, or an empty bit board if the player has no attackers left
+		*/
+		BitBoard least_valuable_attacker(const BoardWithState& _board, BitBoard _attackers, Color _player, Piece& _piece)
+		{
+			constexpr auto _order = std::array
+			{
+				Piece::pawn, Piece::knight, Piece::bishop, Piece::rook, Piece::queen, Piece::king
+			};
+			for (auto& p : _order)
+			{
+				const auto _found = _attackers & _board.as_bits_with_pieces(p | _player);
+				if (_found.any())
+				{
+					_piece = p;
+					BitBoard _out{};
+					_out.set(_found.first());
+					return _out;
+				};
+			};
+			return BitBoard{};
+		};
+	};
+
+	/**
+	 * @brief Works out the material won or lost by a move once the exchange on its square is played out.
+	 * @param _board Board the move will be made on
+	 * @param _move Legal move for the player whose turn it is
+	 * @return Material gained by the player making the move, in centipawns
+	*/
+	Rating see(const BoardWithState& _board, const Move& _move)
+	{
+		const auto _packed = pack_move(_board, _move);
+		if (_packed.is_castle())
+		{
+			return 0;
+		};
+
+		const Position _to{ _move.to };
+		auto _occupied = _board.as_bits_with_pieces();
+		_occupied.reset(Position{ _move.from });
+
+		// Gains for the player who just captured, indexed by how many captures have been made
+		std::array<Rating, 32> _gain{};
+		if (_packed.kind() == MoveKind::en_passant)
+		{
+			_gain[0] = see_piece_value(Piece::pawn);
+			_occupied.reset(Position{ PositionPair{ _move.to.file(), _move.from.rank() } });
+		}
+		else
+		{
+			_gain[0] = see_piece_value(_board.get(_move.to));
+		};
+
+		// The piece left standing on the square, which is what the next capture takes
+		auto _onSquare = _board.get(_move.from);
+		if (_packed.is_promotion())
+		{
+			_onSquare = _packed.promotion();
+			_gain[0] += see_piece_value(_onSquare) - see_piece_value(Piece::pawn);
+		};
+
+		const auto _diagonal = _board.diagonal_sliders(Color::white) | _board.diagonal_sliders(Color::black);
+		const auto _orthogonal = _board.orthogonal_sliders(Color::white) | _board.orthogonal_sliders(Color::black);
+		auto _attackers =
+			(square_attacked_by(_board, _to, Color::white, _occupied) |
+			square_attacked_by(_board, _to, Color::black, _occupied)) & _occupied;
+
+		size_t _depth = 0;
+		auto _side = !_board.turn;
+		while (_depth + 1 != _gain.size())
+		{
+			Piece _piece = Piece::empty;
+			const auto _from = least_valuable_attacker(_board, _attackers, _side, _piece);
+			if (_from.none())
+			{
+				break;
+			};
+
+			// A king can't take if the square is still defended
+			if (_piece == Piece::king && (_attackers & _board.as_bits_with_pieces(!_side)).any())
+			{
+				break;
+			};
+
+			++_depth;
+			_gain[_depth] = see_piece_value(_onSquare) - _gain[_depth - 1];
+			_onSquare = _piece;
+
+			// Lifting the attacker may uncover a slider behind it
+			_occupied ^= _from;
+			_attackers |= (bishop_attacks(_to, _occupied) & _diagonal) | (rook_attacks(_to, _occupied) & _orthogonal);
+			_attackers &= _occupied;
+			_side = !_side;
+		};
+
+		// Either player can decline to carry on, work back from the end of the exchange
+		while (_depth != 0)
+		{
+			--_depth;
+			_gain[_depth] = -std::max(-_gain[_depth], _gain[_depth + 1]);
+		};
+		return _gain[0];
+	};
+
+	/**
+	 * @brief Checks if a move is a capture that loses material once the exchange is played out
+	 * @param _board Board the move will be made on
+	 * @param _move Legal move for the player whose turn it is
+	 * @return True if the move captures and see() gives a loss
+	*/
+	bool is_losing_capture(const BoardWithState& _board, const Move& _move)
+	{
+		return pack_move(_board, _move).is_capture() && see(_board, _move) < 0;
+	};
+};
@@ -0,0 +1,29 @@
+#include <lambdex/chess/time_management.hpp>
+
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Works out how long to think about the next move
+	 * @param _clock The game clock as of the player's turn
+	 * @param _player Player to budget for
+	 * @return Time budget, the hard limit is never more than half the time left on the clock
+	*/
+	TimeBudget budget_move_time(const GameClock& _clock, Color _player)
+	{
+		using std::chrono::milliseconds;
+
+		const auto _left = std::max(_clock.time(_player) - move_overhead_v, milliseconds{ 0 });
+		const auto _increment = _clock.increment(_player);
+
+		// Share what is left over the rest of the game and spend most of the increment as it comes in
+		const auto _target = _left / expected_moves_left_v + _increment * 3 / 4;
+
+		// An iteration started just before the soft limit may run up to 4x over it
+		TimeBudget _out{};
+		_out.hard = std::min(_target * 4, _left / 2);
+		_out.soft = std::min(_target, _out.hard);
+		return _out;
+	};
+};
@@ -0,0 +1,162 @@
+#include <lambdex/chess/transposition_table.hpp>
+
+#include <bit>
+#include <new>
+#include <limits>
+#include <memory>
+#include <algorithm>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Stores a search result
+	 * @param _key Zobrist key of the board
+	 * @param _move Best move found, zero if there wasn't one
+	 * @param _rating Rating to store, must fit in 32 bits
+	 * @param _depth Depth searched to, clamped to 0-255
+	 * @param _bound How the rating relates to the real rating, not Bound::none
+	 * @return True if a different position stored during this search was replaced
+	*/
+	bool TranspositionTable::store(ZobristKey _key, PackedMove _move, Rating _rating, int _depth, Bound _bound) noexcept
+	{
+		JCLIB_ASSERT(_bound != Bound::none);
+		_depth = std::clamp(_depth, 0, 255);
+
+		const auto _age = this->age();
+		auto& _bucket = this->buckets_[_key & this->mask_];
+
+		Slot* _victim = nullptr;
+		uint64_t _victimData = 0;
+		int _victimScore = std::numeric_limits<int>::max();
+		bool _samePosition = false;
+		for (auto& _slot : _bucket.slots)
+		{
+			const auto _data = _slot.data.load(std::memory_order_relaxed);
+			if ((_slot.key.load(std::memory_order_relaxed) ^ _data) == _key && data_bound(_data) != Bound::none)
+			{
+				_victim = &_slot;
+				_victimData = _data;
+				_samePosition = true;
+				break;
+			};
+
+			// Empty entries go first, then old and shallow ones
+			const auto _score = (data_bound(_data) == Bound::none) ?
+				std::numeric_limits<int>::min() :
+				data_depth(_data) - 8 * static_cast<int>((_age - data_age(_data)) & age_mask_v);
+			if (_score < _victimScore)
+			{
+				_victim = &_slot;
+				_victimData = _data;
+				_victimScore = _score;
+			};
+		};
+
+		if (_samePosition)
+		{
+			// Keep a deeper result from this search unless the new one is exact
+			if (_bound != Bound::exact && data_age(_victimData) == _age && _depth < data_depth(_victimData) - 2)
+			{
+				return false;
+			};
+			if (_move.get() == 0)
+			{
+				_move = unpack_entry(_victimData).move;
+			};
+		};
+
+		const auto _data = pack_entry(_move, _rating, _depth, _bound, _age);
+		_victim->data.store(_data, std::memory_order_relaxed);
+		_victim->key.store(_key ^ _data, std::memory_order_relaxed);
+
+		return !_samePosition && data_bound(_victimData) != Bound::none && data_age(_victimData) == _age;
+	};
+
+	/**
+	 * @brief Estimates the fraction of entries used by the current search from the first thousand buckets
+	*/
+	double TranspositionTable::fill_rate() const noexcept
+	{
+		const auto _buckets = std::min<size_t>(this->mask_ + 1, 1000);
+		const auto _age = this->age();
+
+		size_t _used = 0;
+		for (size_t n = 0; n != _buckets; ++n)
+		{
+			for (auto& _slot : this->buckets_[n].slots)
+			{
+				const auto _data = _slot.data.load(std::memory_order_relaxed);
+				if (data_bound(_data) != Bound::none && data_age(_data) == _age)
+				{
+					++_used;
+				};
+			};
+		};
+		return static_cast<double>(_used) / static_cast<double>(_buckets * bucket_size_v);
+	};
+
+	/**
+	 * @brief Empties the table, must not be called while other threads are using it
+	*/
+	void TranspositionTable::clear() noexcept
+	{
+		for (size_t n = 0; n != this->mask_ + 1; ++n)
+		{
+			for (auto& _slot : this->buckets_[n].slots)
+			{
+				_slot.key.store(0, std::memory_order_relaxed);
+				_slot.data.store(0, std::memory_order_relaxed);
+			};
+		};
+		this->age_.store(0, std::memory_order_relaxed);
+		this->probes_.store(0, std::memory_order_relaxed);
+		this->hits_.store(0, std::memory_order_relaxed);
+		this->stores_.store(0, std::memory_order_relaxed);
+		this->collisions_.store(0, std::memory_order_relaxed);
+	};
+
+	/**
+	 * @brief Allocates the table
+	 * @param _megabytes Table size, rounded down to a power of two buckets
+	 * @param _hugePages Ask for the table to be backed by huge pages, only supported on Linux
+	*/
+	TranspositionTable::TranspositionTable(size_t _megabytes, bool _hugePages)
+	{
+		const auto _wanted = std::max<size_t>((_megabytes * 1024 * 1024) / sizeof(Bucket), 1);
+		const auto _count = std::bit_floor(_wanted);
+		this->mask_ = _count - 1;
+		this->bytes_ = _count * sizeof(Bucket);
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		// Huge pages have to be aligned to their size, 2MB on x86-64
+		constexpr size_t huge_page_size_v = 2 * 1024 * 1024;
+		if (_hugePages && this->bytes_ >= huge_page_size_v)
+		{
+			this->alignment_ = huge_page_size_v;
+		};
+#endif
+
+		void* _memory = ::operator new(this->bytes_, std::align_val_t{ this->alignment_ });
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if (this->alignment_ != alignof(Bucket))
+		{
+			this->huge_pages_ = madvise(_memory, this->bytes_, MADV_HUGEPAGE) == 0;
+		};
+#endif
+
+		this->buckets_ = static_cast<Bucket*>(_memory);
+		std::uninitialized_default_construct_n(this->buckets_, _count);
+		this->clear();
+	};
+
+	TranspositionTable::~TranspositionTable()
+	{
+		std::destroy_n(this->buckets_, this->mask_ + 1);
+		::operator delete(static_cast<void*>(this->buckets_), std::align_val_t{ this->alignment_ });
+	};
+};
@@ -2,6 +2,11 @@
 
 #include <lambdex/chess/fen.hpp>
 #include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <span>
+#include <array>
+#include <random>
 
 int subtest_en_passant()
 {
@@ -21,10 +26,276 @@ int subtest_en_passant()
 	PASS();
 };
 
+/**
+ * @brief Checks that the bit boards held by a board match its pieces
+*/
+bool check_bitboards(const lbx::chess::BoardWithState& _board)
+{
+	using namespace lbx::chess;
+
+	for (Position p{}; p != Position::end(); ++p)
+	{
+		const auto _piece = _board[p];
+		if (_board.as_bits_with_pieces()[p] != (_piece != Piece::empty))
+		{
+			return false;
+		};
+		if (_piece != Piece::empty)
+		{
+			if (!_board.as_bits_with_pieces(_piece)[p] || !_board.as_bits_with_pieces(get_color(_piece))[p])
+			{
+				return false;
+			};
+		};
+	};
+
+	size_t _total = 0;
+	for (auto _piece : { Piece::pawn, Piece::knight, Piece::bishop, Piece::rook, Piece::queen, Piece::king })
+	{
+		_total += _board.count_pieces(_piece | Color::white) + _board.count_pieces(_piece | Color::black);
+	};
+	return _total == _board.count_pieces();
+};
+
+int subtest_bitboards_in_sync()
+{
+	NEWTEST();
+
+	using namespace lbx::chess;
+
+	// Game with castling, en passant and a promotion
+	const auto _moves = std::array
+	{
+		"e2e4", "a7a5", "e4e5", "b8c6", "g1f3", "c6b8", "d2d4", "d7d5", "b1c3", "h7h5",
+		"c1f4", "c8e6", "f1b5", "e6d7", "e1g1", "d7b5", "c3b5", "a8a6", "c2c3", "a6g6",
+		"d1a4", "d8c8", "b5d6", "e8d8", "d6c8", "b7b5", "a4b5", "d8c8", "b5d5", "g6b6",
+		"f3g5", "f7f5", "e5f6", "b6f6", "d5a5", "b8a6", "f1e1", "e7e5", "f4e5", "f6b6",
+		"g5f7", "h8h7", "f7g5", "h7h6", "g5f7", "h6e6", "c3c4", "b6b8", "d4d5", "e6e7",
+		"a5a6", "c8d7", "a6c6", "d7c8", "c6c7", "e7c7", "e5c7", "c8c7", "c4c5", "f8c5",
+		"a1c1", "b8b2", "c1c5", "c7b6", "d5d6", "g8h6", "d6d7", "b6c5", "d7d8q"
+	};
+
+	BoardWithState _board = make_standard_board();
+	ASSERT(check_bitboards(_board), "bit boards out of sync for the standard board");
+
+	for (auto& ms : _moves)
+	{
+		Move _move{};
+		from_chars(ms, _move);
+		apply_move(_board, _move);
+		ASSERT(check_bitboards(_board), "bit boards out of sync after applying a move");
+	};
+
+	ASSERT(_board.find(Piece::queen_white).has_value(), "promotion did not place a queen");
+	ASSERT(_board.find(Piece::king_white) == PositionPair(File::g, Rank::r1), "castling did not move the king");
+
+	// Writes through the element accessors must also keep them in sync
+	_board[(File::a, Rank::r1)] = Piece::rook_black;
+	_board[(File::h, Rank::r8)] = _board[(File::a, Rank::r1)];
+	_board[(File::a, Rank::r1)] = Piece::empty;
+	ASSERT(check_bitboards(_board), "bit boards out of sync after writing through the accessors");
+
+	PASS();
+};
+
+int subtest_zobrist()
+{
+	NEWTEST();
+
+	using namespace lbx::chess;
+	const auto _start = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	ASSERT(_start.zobrist_key() == _start.compute_zobrist_key());
+
+	// Knights out and back again is the same position
+	{
+		auto _board = _start;
+		for (auto _str : { "g1f3", "g8f6", "f3g1", "f6g8" })
+		{
+			Move _move{};
+			from_chars(_str, _move);
+			apply_move(_board, _move);
+			ASSERT(_board.zobrist_key() == _board.compute_zobrist_key(), "incremental key drifted");
+		};
+		ASSERT(_board.zobrist_key() == _start.zobrist_key(), "transposition should have the same key");
+	};
+
+	// Side to move, castling and en passant must all change the key
+	{
+		auto _board = _start;
+		_board.turn = Color::black;
+		ASSERT(_board.zobrist_key() != _start.zobrist_key(), "side to move not included");
+	};
+	{
+		auto _board = _start;
+		_board.white_can_castle_queenside = false;
+		ASSERT(_board.zobrist_key() != _start.zobrist_key(), "castling flags not included");
+	};
+	{
+		const auto _a = create_board_from_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+		const auto _b = create_board_from_fen("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+		ASSERT(_a.zobrist_key() != _b.zobrist_key(), "en passant file not included");
+	};
+
+	// Random games should match both a full recalculation and the key of the board read back from fen
+	{
+		std::mt19937 _rng{ 42 };
+		for (int _game = 0; _game != 20; ++_game)
+		{
+			auto _board = _start;
+			for (int _ply = 0; _ply != 120; ++_ply)
+			{
+				const auto _moves = find_possible_moves(_board);
+				if (_moves.empty())
+				{
+					break;
+				};
+				apply_move(_board, _moves.at(_rng() % _moves.size()));
+				ASSERT(_board.zobrist_key() == _board.compute_zobrist_key(), "incremental key drifted");
+				ASSERT(_board.zobrist_key() == create_board_from_fen(get_board_fen(_board)).zobrist_key(), "fen round trip changed the key");
+			};
+		};
+	};
+
+	PASS();
+};
+
+int subtest_make_unmake()
+{
+	NEWTEST();
+
+	using namespace lbx::chess;
+
+	// Positions with castling, en passant and promotions available
+	const auto _fens = std::array
+	{
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"rnbqkbnr/4p1p1/p1p5/1pPp1p1p/3PP3/1QN5/PP1BNPPP/1R2KB1R w Kkq d6 0 11",
+	};
+
+	std::mt19937 _rng{ 7 };
+	std::array<Move, 256> _buffer{};
+	for (auto& _fen : _fens)
+	{
+		for (int _game = 0; _game != 10; ++_game)
+		{
+			auto _board = create_board_from_fen(_fen);
+			for (int _ply = 0; _ply != 80; ++_ply)
+			{
+				const auto _count = find_possible_moves(_board, _buffer);
+				if (_count == 0)
+				{
+					break;
+				};
+
+				// Every move must be undone exactly, and every incremental key must match a full recalculation
+				const auto _beforeFen = get_board_fen(_board);
+				const auto _beforeKey = _board.zobrist_key();
+				const auto _beforePawnKey = _board.pawn_key();
+				const auto _beforeMaterialKey = _board.material_key();
+				for (auto& m : std::span{ _buffer.data(), _count })
+				{
+					auto _copied = _board;
+					apply_move(_copied, m);
+					const bool _pawnsTouched =
+						as_white(_board.get(m.from)) == Piece::pawn || as_white(_board.get(m.to)) == Piece::pawn;
+
+					const auto _undo = make_move(_board, m);
+					ASSERT(get_board_fen(_board) == get_board_fen(_copied), "make_move differs from apply_move");
+					ASSERT(_board.zobrist_key() == _copied.zobrist_key(), "make_move key differs from apply_move");
+					ASSERT(_board.zobrist_key() == _board.compute_zobrist_key(), "incremental key drifted");
+					ASSERT(_board.pawn_key() == _board.compute_pawn_key(), "incremental pawn key drifted");
+					ASSERT(_pawnsTouched || _board.pawn_key() == _beforePawnKey, "pawn key changed without a pawn moving");
+					ASSERT(_board.material_key() == _board.compute_material_key(), "incremental material key drifted");
+
+					unmake_move(_board, m, _undo);
+					ASSERT(check_bitboards(_board), "bit boards out of sync after unmake_move");
+					ASSERT(get_board_fen(_board) == _beforeFen, "unmake_move did not restore the board");
+					ASSERT(_board.zobrist_key() == _beforeKey, "unmake_move did not restore the key");
+					ASSERT(_board.pawn_key() == _beforePawnKey, "unmake_move did not restore the pawn key");
+					ASSERT(_board.material_key() == _beforeMaterialKey, "unmake_move did not restore the material key");
+				};
+
+				make_move(_board, _buffer[_rng() % _count]);
+			};
+		};
+	};
+
+	PASS();
+};
+
+namespace
+{
+	/**
+	 * @brief Counts leaf nodes copying the board for each child, every leaf is visited so the cost of making moves is measured
+	*/
+	size_t count_nodes_copying(const lbx::chess::BoardWithState& _board, int _depth)
+	{
+		using namespace lbx::chess;
+		if (_depth == 0)
+		{
+			return 1;
+		};
+		std::array<Move, 256> _buffer{};
+		const auto _count = find_possible_moves(_board, _buffer);
+
+		size_t _nodes = 0;
+		for (auto& m : std::span{ _buffer.data(), _count })
+		{
+			auto _child = _board;
+			apply_move(_child, m);
+			_nodes += count_nodes_copying(_child, _depth - 1);
+		};
+		return _nodes;
+	};
+
+	/**
+	 * @brief Counts leaf nodes walking a single board with make/unmake
+	*/
+	size_t count_nodes_unmaking(lbx::chess::BoardWithState& _board, int _depth)
+	{
+		using namespace lbx::chess;
+		if (_depth == 0)
+		{
+			return 1;
+		};
+		std::array<Move, 256> _buffer{};
+		const auto _count = find_possible_moves(_board, _buffer);
+
+		size_t _nodes = 0;
+		for (auto& m : std::span{ _buffer.data(), _count })
+		{
+			const auto _undo = make_move(_board, m);
+			_nodes += count_nodes_unmaking(_board, _depth - 1);
+			unmake_move(_board, m, _undo);
+		};
+		return _nodes;
+	};
+};
+
+int subtest_make_unmake_node_counts()
+{
+	NEWTEST();
+
+	using namespace lbx::chess;
+	auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	constexpr int _depth = 3;
+
+	const auto _copyNodes = count_nodes_copying(_board, _depth);
+	const auto _unmakeNodes = count_nodes_unmaking(_board, _depth);
+	ASSERT(_copyNodes == _unmakeNodes, "node counts differ");
+	ASSERT(_copyNodes == 97862);
+
+	PASS();
+};
 
 int main()
 {
 	NEWTEST();
 	SUBTEST(subtest_en_passant);
+	SUBTEST(subtest_bitboards_in_sync);
+	SUBTEST(subtest_zobrist);
+	SUBTEST(subtest_make_unmake);
+	SUBTEST(subtest_make_unmake_node_counts);
 	PASS();
 };
\ No newline at end of file
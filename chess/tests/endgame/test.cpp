@@ -0,0 +1,91 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/endgame.hpp>
+
+using namespace lbx::chess;
+
+int subtest_material_key()
+{
+	NEWTEST();
+
+	// Signatures match boards with those pieces, and only for the right strong side
+	const auto _krk = create_board_from_fen("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+	ASSERT(_krk.material_key() == make_material_key("KRK", Color::white));
+	ASSERT(_krk.material_key() != make_material_key("KRK", Color::black));
+	ASSERT(_krk.material_key() != make_material_key("KQK", Color::white));
+	ASSERT(create_board_from_fen("8/8/8/4k3/8/8/8/4K3 w - - 0 1").material_key() == make_material_key("KK", Color::white));
+
+	PASS();
+};
+
+int subtest_known_endgames()
+{
+	NEWTEST();
+
+	// Not enough material to mate
+	const auto _knk = create_board_from_fen("8/8/8/4k3/8/2N5/8/4K3 w - - 0 1");
+	ASSERT(find_endgame(_knk) && find_endgame(_knk)->name == "KNK");
+	ASSERT(rate_endgame(_knk, Color::white) == 0);
+
+	// Won for whichever side has the rook
+	const auto _krk = create_board_from_fen("8/8/8/4k3/8/8/8/R3K3 b - - 0 1");
+	const auto _kkr = create_board_from_fen("r3k3/8/8/8/4K3/8/8/8 w - - 0 1");
+	ASSERT(rate_endgame(_krk, Color::white).value_or(0) > endgame_win_v);
+	ASSERT(rate_endgame(_krk, Color::black) == -*rate_endgame(_krk, Color::white));
+	ASSERT(rate_endgame(_kkr, Color::black) == rate_endgame(_krk, Color::white), "colors should mirror");
+
+	// Driving the lone king to the edge rates higher
+	const auto _edge = create_board_from_fen("4k3/8/4K3/8/8/8/8/R7 b - - 0 1");
+	ASSERT(*rate_endgame(_edge, Color::white) > *rate_endgame(_krk, Color::white));
+
+	// Bishop and knight drive towards a corner of the bishop's color, a1 for a dark squared bishop
+	const auto _rightCorner = create_board_from_fen("8/8/8/8/8/2B5/2N5/k1K5 b - - 0 1");
+	const auto _wrongCorner = create_board_from_fen("k1K5/2N5/3B4/8/8/8/8/8 b - - 0 1");
+	ASSERT(*rate_endgame(_rightCorner, Color::white) > *rate_endgame(_wrongCorner, Color::white));
+
+	// Stalemate is a draw, checkmate is left to the normal evaluation
+	ASSERT(rate_endgame(create_board_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"), Color::white) == 0);
+	ASSERT(!rate_endgame(create_board_from_fen("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1"), Color::white).has_value());
+
+	// Too much material for any of the known endgames
+	ASSERT(!find_endgame(create_board_from_fen("r3k3/8/8/8/8/8/8/R3K3 w - - 0 1")));
+
+	PASS();
+};
+
+int subtest_king_and_pawn()
+{
+	NEWTEST();
+
+	// The black king is outside the square of the pawn
+	const auto _outside = create_board_from_fen("8/7k/8/8/1P6/8/8/4K3 w - - 0 1");
+	ASSERT(rate_endgame(_outside, Color::white).value_or(0) > endgame_win_v);
+
+	// Inside the square with the move, but not with the other player to move
+	const auto _inside = create_board_from_fen("8/8/5k2/8/1P6/8/8/K7 b - - 0 1");
+	ASSERT(rate_endgame(_inside, Color::white).value_or(endgame_win_v) < endgame_win_v);
+
+	// The white king on a key square wins
+	const auto _keySquare = create_board_from_fen("4k3/8/8/3K4/8/3P4/8/8 b - - 0 1");
+	ASSERT(rate_endgame(_keySquare, Color::white).value_or(0) > endgame_win_v);
+
+	// A rook pawn against a king in the corner is drawn
+	const auto _rookPawn = create_board_from_fen("7k/8/8/8/8/6KP/8/8 w - - 0 1");
+	ASSERT(rate_endgame(_rookPawn, Color::white) == 0);
+
+	// Mirrored for black
+	const auto _blackOutside = create_board_from_fen("4k3/8/8/1p6/8/8/7K/8 b - - 0 1");
+	ASSERT(rate_endgame(_blackOutside, Color::black) == rate_endgame(_outside, Color::white));
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_material_key);
+	SUBTEST(subtest_known_endgames);
+	SUBTEST(subtest_king_and_pawn);
+	PASS();
+};
@@ -0,0 +1,168 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/eval_cache.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <array>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+using namespace lbx::chess;
+
+namespace
+{
+	using TestRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity>;
+
+	/**
+	 * @brief Rates every move down to a depth the way the tree builder does, returns the sum of the ratings
+	*/
+	template <typename RaterT>
+	int64_t rate_tree(BoardWithState& _board, int _depth, const RaterT& _rater)
+	{
+		int64_t _sum = 0;
+		for (auto& m : find_possible_moves(_board))
+		{
+			_sum += rate_move(_board, m, _rater).get_rating();
+			if (_depth > 1)
+			{
+				const auto _undo = make_move(_board, m);
+				_sum += rate_tree(_board, _depth - 1, _rater);
+				unmake_move(_board, m, _undo);
+			};
+		};
+		return _sum;
+	};
+};
+
+int subtest_probe_and_store()
+{
+	NEWTEST();
+
+	EvalCache _cache{ 1 };
+	ASSERT(_cache.size() == (1024 * 1024) / 8);
+
+	const auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	const auto _key = _board.zobrist_key();
+	ASSERT(!_cache.probe(_key, Color::white).has_value());
+
+	_cache.store(_key, Color::white, -1234);
+	_cache.store(_key, Color::black, 1000000);
+	ASSERT(_cache.probe(_key, Color::white) == -1234);
+	ASSERT(_cache.probe(_key, Color::black) == 1000000, "POVs should not share an entry");
+	ASSERT(!_cache.probe(_key ^ 0xFFFF000000000000ull, Color::white).has_value(), "different key matched");
+
+	_cache.clear();
+	ASSERT(!_cache.probe(_key, Color::white).has_value());
+
+	PASS();
+};
+
+int subtest_cached_rater_matches()
+{
+	NEWTEST();
+
+	EvalCache _cache{ 4 };
+	EvalCacheStats _stats{};
+	const BoardRater_Cached<TestRater> _cached{ _cache, {}, &_stats };
+
+	auto _board = create_board_from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+	const auto _expected = rate_tree(_board, 3, TestRater{});
+
+	ASSERT(rate_tree(_board, 3, _cached) == _expected, "cached ratings differ");
+	const auto _firstPass = _stats;
+	ASSERT(_firstPass.misses != 0);
+	ASSERT(_firstPass.hits != 0, "transpositions should hit");
+
+	// Nearly everything is in the table now, a few slots get shared and overwritten
+	ASSERT(rate_tree(_board, 3, _cached) == _expected, "cached ratings differ");
+	const auto _secondMisses = _stats.misses - _firstPass.misses;
+	const auto _secondHits = _stats.hits - _firstPass.hits;
+	ASSERT(_secondMisses * 100 < _secondHits, "second pass missed too often");
+
+	_cache.add_stats(_stats);
+	ASSERT(_cache.stats().hits == _stats.hits);
+	ASSERT(_cache.stats().misses == _stats.misses);
+
+	PASS();
+};
+
+int subtest_cached_batch_matches()
+{
+	NEWTEST();
+
+	EvalCache _cache{ 4 };
+	EvalCacheStats _stats{};
+	const BoardRater_Cached<TestRater> _cached{ _cache, {}, &_stats };
+
+	auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	auto _moves = find_possible_moves(_board);
+
+	// Half the children are cached up front so the batch has hits and runs of misses
+	for (size_t n = 0; n < _moves.size(); n += 2)
+	{
+		rate_move(_board, _moves[n], _cached);
+	};
+	const auto _before = _stats;
+
+	rate_children(_board, _moves, _cached);
+	for (size_t n = 0; n != _moves.size(); ++n)
+	{
+		ASSERT(_moves.score(n) == rate_move(_board, _moves[n], TestRater{}).get_rating(), "cached batch rating differs");
+	};
+	ASSERT(_stats.hits - _before.hits == (_moves.size() + 1) / 2);
+	ASSERT(_stats.misses - _before.misses == _moves.size() / 2);
+
+	PASS();
+};
+
+int subtest_shared_between_threads()
+{
+	NEWTEST();
+
+	EvalCache _cache{ 1 };
+
+	// Each thread writes and reads ratings derived from the key, any hit must match
+	std::atomic<bool> _bad{ false };
+	std::vector<std::thread> _threads{};
+	for (uint64_t t = 0; t != 4; ++t)
+	{
+		_threads.emplace_back([&_cache, &_bad, t]()
+			{
+				uint64_t _state = t;
+				for (int n = 0; n != 200000; ++n)
+				{
+					const auto _key = impl::zobrist_next_random(_state);
+					const auto _rating = static_cast<Rating>(_key >> 40) - 0x7FFFFF;
+					_cache.store(_key, Color::white, _rating);
+
+					const auto _readKey = impl::zobrist_next_random(_state);
+					const auto _read = _cache.probe(_readKey, Color::white);
+					if (_read && *_read != static_cast<Rating>(_readKey >> 40) - 0x7FFFFF)
+					{
+						_bad = true;
+					};
+				};
+			});
+	};
+	for (auto& t : _threads)
+	{
+		t.join();
+	};
+	ASSERT(!_bad, "torn or mismatched entry read");
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_probe_and_store);
+	SUBTEST(subtest_cached_rater_matches);
+	SUBTEST(subtest_cached_batch_matches);
+	SUBTEST(subtest_shared_between_threads);
+	PASS();
+};
@@ -0,0 +1,407 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/evaluation.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+using namespace lbx::chess;
+
+/**
+ * @brief Checks the board's material and square totals against a full recalculation
+*/
+bool check_piece_values(const BoardWithState& _board)
+{
+	return _board.get_piece_values() == _board.compute_piece_values();
+};
+
+int subtest_known_values()
+{
+	NEWTEST();
+
+	const auto _start = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	ASSERT(_start.get_material(Color::white) == 4000);
+	ASSERT(_start.get_material(Color::black) == 4000);
+	ASSERT(_start.get_phase() == max_game_phase_v);
+	ASSERT(rate<BoardRater_PieceSquare>(_start, Color::white) == 0, "starting position should be balanced");
+	ASSERT(rate<BoardRater_PieceSquare>(_start, Color::black) == 0, "starting position should be balanced");
+
+	// White is down the queen that would have been on d1
+	const auto _noQueen = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNB1KBNR w KQkq - 0 1");
+	ASSERT(rate<BoardRater_PieceSquare>(_noQueen, Color::white) == -(900 - 5));
+	ASSERT(rate<BoardRater_PieceSquare>(_noQueen, Color::black) == (900 - 5));
+
+	// Square bonuses see the board from each player's side so mirrored positions rate the same
+	const auto _white = create_board_from_fen("4k3/8/8/8/3N4/8/1P6/4K3 w - - 0 1");
+	const auto _black = create_board_from_fen("4k3/1p6/8/3n4/8/8/8/4K3 b - - 0 1");
+	ASSERT(rate<BoardRater_PieceSquare>(_white, Color::white) == rate<BoardRater_PieceSquare>(_black, Color::black));
+
+	PASS();
+};
+
+int subtest_tapered()
+{
+	NEWTEST();
+
+	// Only kings and pawns left, endgame tables apply in full
+	const auto _pawns = create_board_from_fen("4k3/8/8/3P4/8/8/8/4K3 w - - 0 1");
+	ASSERT(_pawns.get_phase() == 0);
+	ASSERT(rate<BoardRater_PieceSquare>(_pawns, Color::white) == 100 + 30 + (-30 - -30));
+
+	// Trading pieces lowers the phase
+	const auto _queens = create_board_from_fen("3qk3/8/8/8/8/8/8/3QK3 w - - 0 1");
+	ASSERT(_queens.get_phase() == 2 * 4);
+
+	auto _board = create_board_from_fen("3qk3/8/8/8/8/8/8/3QK3 w - - 0 1");
+	Move _capture{};
+	from_chars("d1d8", _capture);
+	const auto _undo = make_move(_board, _capture);
+	ASSERT(_board.get_phase() == 4, "capture did not lower the phase");
+	unmake_move(_board, _capture, _undo);
+	ASSERT(_board.get_phase() == 8, "unmake did not restore the phase");
+
+	// The king wants to be central in the endgame but tucked away in the midgame
+	const auto _central = create_board_from_fen("7k/8/8/8/4K3/8/8/8 w - - 0 1");
+	const auto _corner = create_board_from_fen("7k/8/8/8/8/8/8/6K1 w - - 0 1");
+	ASSERT(rate<BoardRater_PieceSquare>(_central, Color::white) > rate<BoardRater_PieceSquare>(_corner, Color::white));
+	ASSERT(BoardRater_PieceSquare::taper(-40, 40, max_game_phase_v) == -40);
+	ASSERT(BoardRater_PieceSquare::taper(-40, 40, 0) == 40);
+	ASSERT(BoardRater_PieceSquare::taper(-40, 40, max_game_phase_v / 2) == 0);
+
+	PASS();
+};
+
+int subtest_incremental_matches_recompute()
+{
+	NEWTEST();
+
+	constexpr auto _fens = std::array
+	{
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	};
+
+	std::mt19937 _rng{ 7 };
+	for (auto& _fen : _fens)
+	{
+		const auto _initial = create_board_from_fen(_fen);
+		for (int _game = 0; _game != 10; ++_game)
+		{
+			auto _board = _initial;
+			for (int _ply = 0; _ply != 100; ++_ply)
+			{
+				const auto _moves = find_possible_moves(_board);
+				if (_moves.empty())
+				{
+					break;
+				};
+
+				// Every move should be undone exactly, including captures, castles and promotions
+				for (auto& m : _moves)
+				{
+					const auto _before = _board;
+					const auto _undo = make_move(_board, m);
+					ASSERT(check_piece_values(_board), "incremental values drifted after making a move");
+					unmake_move(_board, m, _undo);
+					ASSERT(_board.get_piece_values() == _before.get_piece_values(), "unmake did not restore the totals");
+				};
+
+				apply_move(_board, _moves.at(_rng() % _moves.size()));
+				ASSERT(check_piece_values(_board), "incremental values drifted along a game");
+			};
+		};
+	};
+
+	PASS();
+};
+
+namespace
+{
+	/**
+	 * @brief Rates each term on its own, the way the tree engine's rater used to
+	*/
+	struct SequentialRater
+	{
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			Rating _checkmate = 0;
+			if (is_checkmate(_board, _player))
+			{
+				_checkmate = -1000000;
+			}
+			else if (is_checkmate(_board, !_player))
+			{
+				_checkmate = 1000000;
+			};
+
+			const auto _final = lbx::chess::rate<BoardRater_PieceSquare>(_board, _player) + _checkmate +
+				lbx::chess::rate(_board, _player, BoardRater_CastleOpportunity{ 20, 20 });
+			return std::clamp(_final, -1000000, 1000000);
+		};
+	};
+
+	/**
+	 * @brief Same terms as SequentialRater, fused
+	*/
+	struct FusedRater
+	{
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			return std::clamp(this->terms_.rate(_board, _player), -1000000, 1000000);
+		};
+
+		BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity> terms_
+		{
+			BoardRater_PieceSquare{}, BoardRater_Checkmate{}, BoardRater_CastleOpportunity{ 20, 20 }
+		};
+	};
+
+	/**
+	 * @brief Square by square term counting pieces in the centre
+	*/
+	struct CentreRater
+	{
+		Rating rate_square(const RatingContext&, Position _pos, Piece _piece, Color _player) const
+		{
+			const auto _file = jc::to_underlying(PositionPair{ _pos }.file());
+			const auto _rank = jc::to_underlying(PositionPair{ _pos }.rank());
+			const bool _centre = _file >= 2 && _file <= 5 && _rank >= 2 && _rank <= 5;
+			return (!_centre) ? 0 : (get_color(_piece) == _player) ? 1 : -1;
+		};
+
+		Rating rate(const BoardWithState& _board, Color _player) const
+		{
+			const RatingContext _context{ _board };
+			Rating _sum = 0;
+			for (Position p{}; p != Position::end(); ++p)
+			{
+				if (_board.get(p) != Piece::empty)
+				{
+					_sum += this->rate_square(_context, p, _board.get(p), _player);
+				};
+			};
+			return _sum;
+		};
+	};
+	static_assert(cx_square_rater<CentreRater>);
+
+	/**
+	 * @brief Collects positions by playing random games, checkmates included
+	*/
+	std::vector<BoardWithState> make_rating_positions()
+	{
+		std::vector<BoardWithState> _out{};
+		_out.push_back(create_board_from_fen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3"));
+		_out.push_back(create_board_from_fen("R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1"));
+
+		std::mt19937 _rng{ 11 };
+		const auto _start = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		for (int _game = 0; _game != 20; ++_game)
+		{
+			auto _board = _start;
+			for (int _ply = 0; _ply != 60; ++_ply)
+			{
+				_out.push_back(_board);
+				const auto _moves = find_possible_moves(_board);
+				if (_moves.empty())
+				{
+					break;
+				};
+				apply_move(_board, _moves.at(_rng() % _moves.size()));
+			};
+		};
+		return _out;
+	};
+
+	/**
+	 * @brief Rates every move from every position, the same work the tree builder does per node
+	*/
+	template <typename RaterT>
+	Rating rate_all_moves(std::vector<BoardWithState>& _positions, const RaterT& _rater)
+	{
+		Rating _sum = 0;
+		for (auto& b : _positions)
+		{
+			for (auto& m : find_possible_moves(b))
+			{
+				_sum += rate_move(b, m, _rater).get_rating();
+			};
+		};
+		return _sum;
+	};
+};
+
+int subtest_fused_rater()
+{
+	NEWTEST();
+
+	auto _positions = make_rating_positions();
+
+	const SequentialRater _sequential{};
+	const FusedRater _fused{};
+	for (auto& b : _positions)
+	{
+		for (auto c : { Color::white, Color::black })
+		{
+			ASSERT(_sequential.rate(b, c) == _fused.rate(b, c), "fused rater disagrees with the sequential one");
+			ASSERT(BoardRater_Fused<CentreRater>{}.rate(b, c) == CentreRater{}.rate(b, c), "square terms not fused correctly");
+		};
+	};
+
+	// Fool's mate and a back rank mate
+	ASSERT(_fused.rate(_positions[0], Color::white) == -1000000);
+	ASSERT(_fused.rate(_positions[1], Color::white) == 1000000);
+	ASSERT(rate_all_moves(_positions, _sequential) == rate_all_moves(_positions, _fused), "move ratings differ");
+
+	PASS();
+};
+
+int subtest_batch_rating()
+{
+	NEWTEST();
+
+	auto _positions = make_rating_positions();
+	using Terms = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity>;
+	using MixedTerms = BoardRater_Fused<CentreRater, BoardRater_PieceSquare>;
+	static_assert(cx_batch_rater<Terms>);
+
+	std::vector<Rating> _ratings(_positions.size());
+	const auto _check = [&](const auto& _rater, Color _player)
+	{
+		std::ranges::fill(_ratings, 0);
+		lbx::chess::rate_batch(_positions, _player, _ratings, _rater);
+		for (size_t n = 0; n != _positions.size(); ++n)
+		{
+			if (_ratings[n] != _rater.rate(_positions[n], _player))
+			{
+				return false;
+			};
+		};
+		return true;
+	};
+
+	for (auto c : { Color::white, Color::black })
+	{
+		ASSERT(_check(BoardRater_PieceSquare{}, c), "piece square batch disagrees");
+		ASSERT(_check(Terms{}, c), "fused batch disagrees");
+		ASSERT(_check(MixedTerms{}, c), "fused batch with square terms disagrees");
+		ASSERT(_check(BoardRater_Material{}, c), "scalar fallback disagrees");
+	};
+
+	for (auto& b : _positions)
+	{
+		auto _moves = find_possible_moves(b);
+		rate_children(b, _moves, Terms{});
+		for (size_t n = 0; n != _moves.size(); ++n)
+		{
+			ASSERT(_moves.score(n) == rate_move(b, _moves[n], Terms{}).get_rating(), "child rating differs");
+		};
+	};
+
+	PASS();
+};
+
+int subtest_mobility_and_king_safety()
+{
+	NEWTEST();
+
+	// Only the knights can move, two squares each
+	{
+		const auto _board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+		const auto _info = compute_attack_info(_board);
+		for (auto c : { 0, 1 })
+		{
+			ASSERT(_info.mobility[c] == (std::array<int, 4>{ 4, 0, 0, 0 }));
+			ASSERT(_info.king_zone_attacks[c] == (std::array<int, 4>{ 0, 0, 0, 0 }));
+		};
+		ASSERT(BoardRater_Mobility{}.rate(_board, Color::white) == 0);
+	};
+
+	// The queen hits g7 next to the black king, the b7 pawn keeps the knight off a6 and c6
+	{
+		const auto _board = create_board_from_fen("6k1/1p3ppp/8/8/1N4Q1/8/8/4K3 w - - 0 1");
+		const auto _info = compute_attack_info(_board);
+		ASSERT(_info.king_zone_attacks[0] == (std::array<int, 4>{ 0, 0, 0, 1 }));
+		ASSERT(_info.mobility[0][0] == 4, "knight mobility");
+		ASSERT(BoardRater_KingSafety{}.rate(_board, Color::white) == (20 * 5) / max_game_phase_v, "queen and knight give a phase of 5");
+	};
+
+	// Both terms rate the same from either side, and sharing a context changes nothing
+	const BoardRater_Fused<BoardRater_Mobility, BoardRater_KingSafety> _fused{};
+	for (auto& b : make_rating_positions())
+	{
+		for (auto c : { Color::white, Color::black })
+		{
+			ASSERT(BoardRater_Mobility{}.rate(b, c) == -BoardRater_Mobility{}.rate(b, !c));
+			ASSERT(BoardRater_KingSafety{}.rate(b, c) == -BoardRater_KingSafety{}.rate(b, !c));
+			ASSERT(_fused.rate(b, c) == BoardRater_Mobility{}.rate(b, c) + BoardRater_KingSafety{}.rate(b, c));
+		};
+	};
+
+	PASS();
+};
+
+namespace
+{
+	using AllTerms = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity,
+		BoardRater_Mobility, BoardRater_KingSafety>;
+};
+
+int subtest_lazy_evaluation()
+{
+	NEWTEST();
+
+	const AllTerms _rater{};
+	static_assert(cx_windowed_rater<AllTerms>);
+
+	LazyEvalStats _stats{};
+	for (auto& b : make_rating_positions())
+	{
+		for (auto c : { Color::white, Color::black })
+		{
+			const auto _full = _rater.rate(b, c);
+			for (auto _offset : { -400, -100, -30, 0, 30, 100, 400 })
+			{
+				const RatingWindow _window{ _full + _offset - 25, _full + _offset + 25 };
+				const auto _lazy = _rater.rate(b, c, _window, &_stats);
+				if (_window.contains(_full))
+				{
+					ASSERT(_lazy == _full, "rating inside the window changed");
+				}
+				else if (_full <= _window.alpha)
+				{
+					ASSERT(_lazy <= _window.alpha, "fail low rated above alpha");
+				}
+				else
+				{
+					ASSERT(_lazy >= _window.beta, "fail high rated below beta");
+				};
+			};
+			ASSERT(lbx::chess::rate(b, c, RatingWindow{}, _rater) == _full, "full window should never exit");
+		};
+	};
+	ASSERT(_stats.lazy_exits != 0);
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_known_values);
+	SUBTEST(subtest_tapered);
+	SUBTEST(subtest_incremental_matches_recompute);
+	SUBTEST(subtest_fused_rater);
+	SUBTEST(subtest_batch_rating);
+	SUBTEST(subtest_mobility_and_king_safety);
+	SUBTEST(subtest_lazy_evaluation);
+	PASS();
+};
@@ -0,0 +1,235 @@
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+#include <lambdex/chess/move_validation.hpp>
+
+#include <jclib-test.hpp>
+
+#include <set>
+#include <array>
+#include <random>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+
+using namespace lbx::chess;
+
+/**
+ * @brief Positions with castling, en passant, promotions and pins to exercise the generator
+*/
+constexpr auto test_positions = std::array
+{
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	"rnbqkbnr/4p1p1/p1p5/1pPp1p1p/3PP3/1QN5/PP1BNPPP/1R2KB1R w Kkq d6 0 11",
+};
+
+using MovePairSet = std::set<std::pair<uint8_t, uint8_t>>;
+
+MovePairSet generated_move_pairs(const BoardWithState& _board)
+{
+	std::array<Move, 256> _buffer{};
+	const auto _count = find_possible_moves(_board, _buffer);
+
+	MovePairSet _out{};
+	for (auto& m : std::span{ _buffer.data(), _count })
+	{
+		_out.insert({ Position{ m.from }.get(), Position{ m.to }.get() });
+	};
+	return _out;
+};
+
+/**
+ * @brief Finds every (from, to) pair that is_move_valid accepts
+*/
+MovePairSet reference_move_pairs(const BoardWithState& _board)
+{
+	MovePairSet _out{};
+	for (Position _from{}; _from != Position::end(); ++_from)
+	{
+		if (_board.get(_from) == Piece::empty || get_color(_board.get(_from)) != _board.turn)
+		{
+			continue;
+		};
+		for (Position _to{}; _to != Position::end(); ++_to)
+		{
+			if (is_move_valid(_board, Move{ _from, _to }, _board.turn) == MoveValidity::valid)
+			{
+				_out.insert({ _from.get(), _to.get() });
+			};
+		};
+	};
+	return _out;
+};
+
+size_t perft(const BoardWithState& _board, int _depth)
+{
+	std::array<Move, 256> _buffer{};
+	const auto _count = generate_legal_moves(_board, _buffer);
+	if (_depth == 1)
+	{
+		return _count;
+	};
+
+	size_t _nodes = 0;
+	for (auto& m : std::span{ _buffer.data(), _count })
+	{
+		auto _next = _board;
+		apply_move(_next, m);
+		_nodes += perft(_next, _depth - 1);
+	};
+	return _nodes;
+};
+
+
+
+int subtest_matches_is_move_valid()
+{
+	NEWTEST();
+
+	std::mt19937 _rng{ 1234 };
+	for (auto& _fen : test_positions)
+	{
+		for (int _game = 0; _game != 4; ++_game)
+		{
+			auto _board = create_board_from_fen(_fen);
+			for (int _ply = 0; _ply != 80; ++_ply)
+			{
+				const auto _generated = generated_move_pairs(_board);
+				const auto _reference = reference_move_pairs(_board);
+				if (_generated != _reference)
+				{
+					std::cout << "mismatch on " << get_board_fen(_board) << '\n';
+				};
+				ASSERT(_generated == _reference, "generator disagrees with is_move_valid");
+
+				const auto _moves = find_possible_moves(_board);
+				if (_moves.empty())
+				{
+					break;
+				};
+				apply_move(_board, _moves.at(_rng() % _moves.size()));
+			};
+		};
+	};
+
+	PASS();
+};
+
+int subtest_is_move_legal()
+{
+	NEWTEST();
+
+	std::mt19937 _rng{ 4321 };
+	for (auto& _fen : test_positions)
+	{
+		for (int _game = 0; _game != 2; ++_game)
+		{
+			auto _board = create_board_from_fen(_fen);
+			for (int _ply = 0; _ply != 40; ++_ply)
+			{
+				const auto _moves = find_possible_moves(_board);
+				std::set<std::tuple<uint8_t, uint8_t, Piece>> _generated{};
+				for (auto& m : _moves)
+				{
+					_generated.insert({ Position{ m.from }.get(), Position{ m.to }.get(), m.promotion });
+				};
+
+				// Every pairing of squares, with and without each promotion piece
+				for (Position _from{}; _from != Position::end(); ++_from)
+				{
+					for (Position _to{}; _to != Position::end(); ++_to)
+					{
+						for (auto _promotion : { Piece::empty, Piece::queen, Piece::rook, Piece::bishop, Piece::knight, Piece::pawn })
+						{
+							const bool _expected = _generated.contains({ _from.get(), _to.get(), _promotion });
+							if (is_move_legal(_board, Move{ _from, _to, _promotion }) != _expected)
+							{
+								std::cout << "mismatch on " << get_board_fen(_board) << " for " << Move{ _from, _to, _promotion }.to_string() << '\n';
+							};
+							ASSERT(is_move_legal(_board, Move{ _from, _to, _promotion }) == _expected, "is_move_legal disagrees with the generator");
+						};
+					};
+				};
+
+				if (_moves.empty())
+				{
+					break;
+				};
+				apply_move(_board, _moves.at(_rng() % _moves.size()));
+			};
+		};
+	};
+
+	PASS();
+};
+
+int subtest_perft()
+{
+	NEWTEST();
+
+	const std::array<std::pair<int, size_t>, 6> _expected
+	{
+		std::pair<int, size_t>{ 3, 8902 },
+		std::pair<int, size_t>{ 3, 97862 },
+		std::pair<int, size_t>{ 4, 43238 },
+		std::pair<int, size_t>{ 3, 9467 },
+		std::pair<int, size_t>{ 3, 62379 },
+		std::pair<int, size_t>{ 1, 38 },
+	};
+	for (size_t n = 0; n != _expected.size(); ++n)
+	{
+		const auto _board = create_board_from_fen(test_positions[n]);
+		const auto _nodes = perft(_board, _expected[n].first);
+		if (_nodes != _expected[n].second)
+		{
+			std::cout << test_positions[n] << " : got " << _nodes << ", expected " << _expected[n].second << '\n';
+		};
+		ASSERT(_nodes == _expected[n].second, "perft node count is wrong");
+	};
+
+	PASS();
+};
+
+int subtest_gen_types()
+{
+	NEWTEST();
+
+	for (auto& _fen : test_positions)
+	{
+		const auto _board = create_board_from_fen(_fen);
+
+		std::array<Move, 256> _all{};
+		std::array<Move, 256> _split{};
+		const auto _allCount = generate_legal_moves<MoveGenType::all>(_board, _all);
+		auto _splitCount = generate_legal_moves<MoveGenType::captures>(_board, _split);
+		_splitCount += generate_legal_moves<MoveGenType::quiets>(_board, std::span{ _split }.subspan(_splitCount));
+		ASSERT(_allCount == _splitCount, "captures + quiets should add up to all moves");
+
+		const auto _less = [](const Move& a, const Move& b)
+		{
+			return std::tuple{ Position{ a.from }, Position{ a.to }, a.promotion } <
+				std::tuple{ Position{ b.from }, Position{ b.to }, b.promotion };
+		};
+		std::sort(_all.begin(), _all.begin() + _allCount, _less);
+		std::sort(_split.begin(), _split.begin() + _splitCount, _less);
+		ASSERT(std::equal(_all.begin(), _all.begin() + _allCount, _split.begin()), "captures + quiets should contain the same moves as all");
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_matches_is_move_valid);
+	SUBTEST(subtest_is_move_legal);
+	SUBTEST(subtest_perft);
+	SUBTEST(subtest_gen_types);
+	PASS();
+};
@@ -0,0 +1,73 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/move_list.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <span>
+#include <array>
+#include <algorithm>
+
+using namespace lbx::chess;
+
+int subtest_matches_generator()
+{
+	NEWTEST();
+
+	const auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+	std::array<Move, 256> _buffer{};
+	const auto _count = find_possible_moves(_board, _buffer);
+
+	const auto _moves = find_possible_moves(_board);
+	ASSERT(_moves.size() == _count);
+	ASSERT(_moves.size() == 48);
+	ASSERT(std::ranges::equal(_moves, std::span{ _buffer.data(), _count }), "list differs from the generator");
+	for (size_t n = 0; n != _moves.size(); ++n)
+	{
+		ASSERT(_moves.score(n) == 0, "generated moves should start unscored");
+	};
+
+	PASS();
+};
+
+int subtest_sort_by_score()
+{
+	NEWTEST();
+
+	MoveList _moves{};
+	ASSERT(_moves.empty());
+
+	const auto _scores = std::array{ 5, -3, 12, 5, 0, 12 };
+	for (size_t n = 0; n != _scores.size(); ++n)
+	{
+		_moves.push_back(Move{ Position{ static_cast<uint8_t>(n) }, Position{ static_cast<uint8_t>(n + 8) } }, _scores[n]);
+	};
+	ASSERT(_moves.size() == _scores.size());
+
+	_moves.sort_by_score();
+	for (size_t n = 1; n != _moves.size(); ++n)
+	{
+		ASSERT(_moves.score(n - 1) >= _moves.score(n), "scores not in descending order");
+	};
+
+	// Moves must travel with their scores, equal scores keep their order
+	ASSERT(Position{ _moves[0].from }.get() == 2);
+	ASSERT(Position{ _moves[1].from }.get() == 5);
+	ASSERT(Position{ _moves[2].from }.get() == 0);
+	ASSERT(Position{ _moves[3].from }.get() == 3);
+	ASSERT(Position{ _moves.front().to }.get() == 10);
+
+	_moves.clear();
+	ASSERT(_moves.empty());
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_matches_generator);
+	SUBTEST(subtest_sort_by_score);
+	PASS();
+};
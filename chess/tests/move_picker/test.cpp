@@ -0,0 +1,128 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/move_picker.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <set>
+#include <span>
+#include <array>
+#include <tuple>
+#include <random>
+#include <vector>
+
+using namespace lbx::chess;
+
+using MoveSet = std::set<std::tuple<uint8_t, uint8_t, Piece>>;
+
+MoveSet to_set(std::span<const Move> _moves)
+{
+	MoveSet _out{};
+	for (auto& m : _moves)
+	{
+		_out.insert({ Position{ m.from }.get(), Position{ m.to }.get(), m.promotion });
+	};
+	return _out;
+};
+
+constexpr auto test_positions = std::array
+{
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	"rnbqkbnr/4p1p1/p1p5/1pPp1p1p/3PP3/1QN5/PP1BNPPP/1R2KB1R w Kkq d6 0 11",
+};
+
+int subtest_picks_every_legal_move()
+{
+	NEWTEST();
+
+	std::mt19937 _rng{ 11 };
+	std::array<Move, 256> _buffer{};
+	for (auto& _fen : test_positions)
+	{
+		auto _board = create_board_from_fen(_fen);
+		for (int _ply = 0; _ply != 40; ++_ply)
+		{
+			const auto _count = find_possible_moves(_board, _buffer);
+			if (_count == 0)
+			{
+				break;
+			};
+			const auto _expected = to_set(std::span{ _buffer.data(), _count });
+
+			// Use a random legal move as the best move, and a move from a different position
+			const auto _best = _buffer[_rng() % _count];
+			for (auto& _hint : { std::optional<Move>{ _best }, std::optional<Move>{ Move{ (File::a, Rank::r3), (File::h, Rank::r6) } }, std::optional<Move>{} })
+			{
+				auto _picker = (_hint) ? MovePicker{ _board, *_hint } : MovePicker{ _board };
+
+				std::vector<Move> _picked{};
+				while (auto _move = _picker.next())
+				{
+					_picked.push_back(*_move);
+				};
+				ASSERT(_picker.stage() == MovePicker::Stage::done);
+				ASSERT(_picked.size() == _count, "picked moves were missing or repeated");
+				ASSERT(to_set(_picked) == _expected, "picked moves differ from the generator");
+				if (_hint == _best)
+				{
+					ASSERT(_picked.front() == _best, "best move was not picked first");
+				};
+
+				// Captures come before quiets, in MVV-LVA order
+				const auto _captureCount = generate_legal_moves<MoveGenType::captures>(_board, _buffer);
+				const auto _captures = to_set(std::span{ _buffer.data(), _captureCount });
+				const auto _rest = std::span{ _picked }.subspan((_hint == _best) ? 1 : 0);
+				bool _seenQuiet = false;
+				for (size_t n = 0; n != _rest.size(); ++n)
+				{
+					const auto& m = _rest[n];
+					if (!_captures.contains({ Position{ m.from }.get(), Position{ m.to }.get(), m.promotion }))
+					{
+						_seenQuiet = true;
+						continue;
+					};
+					ASSERT(!_seenQuiet, "capture picked after a quiet move");
+					ASSERT(n == 0 || mvv_lva_score(_board, _rest[n - 1]) >= mvv_lva_score(_board, m), "captures out of order");
+				};
+				find_possible_moves(_board, _buffer);
+			};
+
+			make_move(_board, _buffer[_rng() % _count]);
+		};
+	};
+
+	PASS();
+};
+
+int subtest_stages_are_lazy()
+{
+	NEWTEST();
+
+	const auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+	Move _best{};
+	from_chars("e1g1", _best);
+
+	MovePicker _picker{ _board, _best };
+	ASSERT(_picker.next() == _best);
+	ASSERT(_picker.stage() == MovePicker::Stage::generate_captures, "captures generated before they were needed");
+
+	// Bishop takes bishop on a6 is the most valuable capture here
+	Move _bxa6{};
+	from_chars("e2a6", _bxa6);
+	ASSERT(_picker.next() == _bxa6, "most valuable capture was not picked first");
+	ASSERT(_picker.stage() == MovePicker::Stage::captures, "quiets generated before they were needed");
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_picks_every_legal_move);
+	SUBTEST(subtest_stages_are_lazy);
+	PASS();
+};
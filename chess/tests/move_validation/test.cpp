@@ -2,6 +2,7 @@
 #include <lambdex/chess/piece_movement.hpp>
 #include <lambdex/chess/move_validation.hpp>
 #include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/attacks.hpp>
 
 #include <jclib-test.hpp>
 
@@ -102,6 +103,35 @@ int subtest_threatened()
 	PASS();
 };
 
+int subtest_square_attacked_by()
+{
+	NEWTEST();
+
+	const auto _board = create_board_from_fen("3qk3/8/1b6/8/R7/1N2P3/5B2/7K w - - 0 1");
+	const auto _square = (File::d, Rank::r4);
+
+	BitBoard _white{};
+	_white.set((File::a, Rank::r4));
+	_white.set((File::b, Rank::r3));
+	_white.set((File::e, Rank::r3));
+	ASSERT(square_attacked_by(_board, _square, Color::white) == _white, "wrong white attackers");
+
+	BitBoard _black{};
+	_black.set((File::d, Rank::r8));
+	_black.set((File::b, Rank::r6));
+	ASSERT(square_attacked_by(_board, _square, Color::black) == _black, "wrong black attackers");
+
+	// Lifting the pawn lets the bishop behind it through
+	auto _occupied = _board.as_bits_with_pieces();
+	_occupied.reset((File::e, Rank::r3));
+	_white.set((File::f, Rank::r2));
+	ASSERT(square_attacked_by(_board, _square, Color::white, _occupied) == _white, "x-ray attacker not found");
+
+	ASSERT(square_attacked_by(_board, (File::h, Rank::r8), Color::white).none(), "h8 should not be attacked");
+
+	PASS();
+};
+
 int subtest_catalog()
 {
 	NEWTEST();
@@ -146,5 +176,6 @@ int main()
 	SUBTEST(subtest_rook);
 	SUBTEST(subtest_catalog);
 	SUBTEST(subtest_threatened);
+	SUBTEST(subtest_square_attacked_by);
 	PASS();
 };
@@ -0,0 +1,138 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <span>
+#include <array>
+#include <random>
+#include <string_view>
+
+using namespace lbx::chess;
+
+int subtest_round_trip()
+{
+	NEWTEST();
+
+	const auto _fens = std::array
+	{
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	};
+
+	std::mt19937 _rng{ 3 };
+	std::array<Move, 256> _buffer{};
+	for (auto& _fen : _fens)
+	{
+		auto _board = create_board_from_fen(_fen);
+		for (int _ply = 0; _ply != 80; ++_ply)
+		{
+			const auto _count = find_possible_moves(_board, _buffer);
+			if (_count == 0)
+			{
+				break;
+			};
+
+			for (auto& m : std::span{ _buffer.data(), _count })
+			{
+				const auto _packed = pack_move(_board, m);
+				ASSERT(_packed.unpack() == m, "packing lost part of the move");
+				ASSERT(PackedMove{ m }.unpack() == m, "packing without a board lost part of the move");
+				ASSERT(PackedMove{ m }.is_promotion() == _packed.is_promotion(), "promotion kind depends on the board");
+
+				// UCI strings must match the unpacked move
+				std::array<char, 5> _str{};
+				const auto _written = to_chars(_str.data(), _str.data() + _str.size(), _packed);
+				ASSERT(_written.ec == std::errc{});
+				ASSERT(std::string_view(_str.data(), _written.ptr) == m.to_string());
+
+				PackedMove _parsed{};
+				from_chars(std::string_view(_str.data(), _written.ptr), _parsed);
+				ASSERT(_parsed.unpack() == m, "uci round trip changed the move");
+			};
+
+			make_move(_board, _buffer[_rng() % _count]);
+		};
+	};
+
+	PASS();
+};
+
+/**
+ * @brief Leaf counts broken down by move kind
+*/
+struct KindCounts
+{
+	size_t nodes = 0;
+	size_t captures = 0;
+	size_t en_passants = 0;
+	size_t castles = 0;
+	size_t promotions = 0;
+};
+
+void count_kinds(BoardWithState& _board, int _depth, KindCounts& _counts)
+{
+	std::array<Move, 256> _buffer{};
+	const auto _count = find_possible_moves(_board, _buffer);
+	for (auto& m : std::span{ _buffer.data(), _count })
+	{
+		const auto _packed = pack_move(_board, m);
+		if (_depth == 1)
+		{
+			++_counts.nodes;
+			_counts.captures += _packed.is_capture();
+			_counts.en_passants += (_packed.kind() == MoveKind::en_passant);
+			_counts.castles += _packed.is_castle();
+			_counts.promotions += _packed.is_promotion();
+		}
+		else
+		{
+			const auto _undo = make_move(_board, _packed);
+			count_kinds(_board, _depth - 1, _counts);
+			unmake_move(_board, _packed, _undo);
+		};
+	};
+};
+
+int subtest_kind_counts()
+{
+	NEWTEST();
+
+	// Expected values are the well known perft breakdowns for these positions
+	struct Expected
+	{
+		const char* fen;
+		int depth;
+		KindCounts counts;
+	};
+	const auto _expected = std::array
+	{
+		Expected{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, { 97862, 17102, 45, 3162, 0 } },
+		Expected{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, { 43238, 3348, 123, 0, 0 } },
+		Expected{ "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, { 9467, 1021, 4, 0, 120 } },
+	};
+
+	for (auto& e : _expected)
+	{
+		auto _board = create_board_from_fen(e.fen);
+		KindCounts _counts{};
+		count_kinds(_board, e.depth, _counts);
+		ASSERT(_counts.nodes == e.counts.nodes, e.fen);
+		ASSERT(_counts.captures == e.counts.captures, e.fen);
+		ASSERT(_counts.en_passants == e.counts.en_passants, e.fen);
+		ASSERT(_counts.castles == e.counts.castles, e.fen);
+		ASSERT(_counts.promotions == e.counts.promotions, e.fen);
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_round_trip);
+	SUBTEST(subtest_kind_counts);
+	PASS();
+};
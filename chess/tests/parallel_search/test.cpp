@@ -0,0 +1,71 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/parallel_search.hpp>
+
+#include <chrono>
+
+using namespace lbx::chess;
+
+namespace
+{
+	using TestRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_CastleOpportunity, BoardRater_Mobility>;
+	using std::chrono::milliseconds;
+
+	/**
+	 * @brief Budget that never runs out
+	*/
+	constexpr TimeBudget unlimited_v{ milliseconds{ 3600000 }, milliseconds{ 3600000 } };
+};
+
+int subtest_results()
+{
+	NEWTEST();
+
+	TranspositionTable _table{ 16 };
+	ParallelSearcher<TestRater> _searcher{ _table, 4 };
+	ASSERT(_searcher.thread_count() == 4);
+
+	// Mate in two, all threads share the table so the mate distance must survive
+	{
+		const auto _board = create_board_from_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+		const auto _result = _searcher.search(_board, 5, unlimited_v);
+		ASSERT(_result.best_move == Move((File::c, Rank::r6), (File::b, Rank::r6)));
+		ASSERT(_result.rating == mate_rating_v - 3);
+	};
+
+	// Fewer threads than it was made with, down to just the calling thread
+	for (size_t _threads = 1; _threads != 4; ++_threads)
+	{
+		_table.clear();
+		const auto _result = _searcher.search(create_board_from_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1"), 5, unlimited_v, _threads);
+		ASSERT(_result.best_move == Move((File::c, Rank::r6), (File::b, Rank::r6)));
+		ASSERT(_result.rating == mate_rating_v - 3);
+	};
+
+	// Stalemated, nothing to find
+	{
+		const auto _result = _searcher.search(create_board_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"), 4, unlimited_v);
+		ASSERT(!_result.best_move && _result.rating == 0);
+	};
+
+	// The soft limit is never reached so only the hard limit can stop the main search, the call
+	// only returns once every helper has seen the stop flag and finished
+	{
+		_table.clear();
+		const auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		const auto _result = _searcher.search(_board, max_search_ply_v, TimeBudget{ std::chrono::hours{ 24 }, milliseconds{ 100 } });
+		ASSERT(_result.best_move && _result.depth >= 1 && _result.depth < max_search_ply_v);
+		ASSERT(_result.stopped, "the hard limit should have cut the main search short");
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_results);
+	PASS();
+};
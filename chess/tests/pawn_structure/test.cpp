@@ -0,0 +1,80 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/pawn_structure.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+using namespace lbx::chess;
+
+namespace
+{
+	/**
+	 * @brief Rates every node of the move tree down to a depth, returns the sum of the ratings
+	*/
+	template <typename RaterT>
+	int64_t rate_tree(BoardWithState& _board, int _depth, const RaterT& _rater, size_t& _nodes)
+	{
+		++_nodes;
+		int64_t _sum = _rater.rate(_board, _board.turn);
+		if (_depth == 0)
+		{
+			return _sum;
+		};
+		for (auto& m : find_possible_moves(_board))
+		{
+			const auto _undo = make_move(_board, m);
+			_sum += rate_tree(_board, _depth - 1, _rater, _nodes);
+			unmake_move(_board, m, _undo);
+		};
+		return _sum;
+	};
+};
+
+int subtest_known_structure()
+{
+	NEWTEST();
+
+	// Isolated a pawn, doubled and isolated c pawns, the rear c pawn is not passed
+	const auto _board = create_board_from_fen("4k3/8/8/8/8/2P5/P1P5/4K3 w - - 0 1");
+	const auto _structure = evaluate_pawn_structure(_board);
+	ASSERT(_structure.score[0] == -15 + -10 + 2 * -15 + 5 + 10);
+	ASSERT(_structure.score[1] == 0);
+	ASSERT(_structure.passed[0].count() == 2);
+	ASSERT(_structure.passed[0].at(Position{ 8 }), "a2 should be passed");
+	ASSERT(_structure.passed[0].at(Position{ 18 }), "c3 should be passed");
+
+	// An enemy pawn on a neighbouring file ahead stops a pawn being passed
+	const auto _blocked = create_board_from_fen("4k3/8/3p4/8/8/8/2P1P3/4K3 w - - 0 1");
+	const auto _blockedStructure = evaluate_pawn_structure(_blocked);
+	ASSERT(_blockedStructure.passed[0].none(), "blocked pawns counted as passed");
+	ASSERT(_blockedStructure.passed[1].none(), "blocked pawns counted as passed");
+	ASSERT(BoardRater_PawnStructure{}.rate(_blocked, Color::black) == -15 - 2 * -15, "every pawn here is isolated");
+
+	PASS();
+};
+
+int subtest_table_matches()
+{
+	NEWTEST();
+
+	PawnHashTable _table{ 1 << 10 };
+	const BoardRater_PawnStructure _cached{ &_table };
+	const BoardRater_PawnStructure _uncached{};
+
+	size_t _nodes = 0;
+	auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	const auto _expected = rate_tree(_board, 2, _uncached, _nodes);
+	ASSERT(rate_tree(_board, 2, _cached, _nodes) == _expected, "table gave different ratings");
+	ASSERT(_table.stats().hits > _table.stats().misses, "pawn structures should repeat");
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_known_structure);
+	SUBTEST(subtest_table_matches);
+	PASS();
+};
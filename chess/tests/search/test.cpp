@@ -0,0 +1,284 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/search.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace lbx::chess;
+
+namespace
+{
+	using TestRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_CastleOpportunity, BoardRater_Mobility>;
+
+	/**
+	 * @brief Quiescence search without pruning, for checking the real one against
+	*/
+	Rating minimax_quiesce(BoardWithState& _board, int _ply, const TestRater& _rater)
+	{
+		Rating _best = -mate_rating_v - 1;
+		std::array<Move, 256> _moves;
+		size_t _count = 0;
+		if (RatingContext{ _board }.in_check())
+		{
+			_count = generate_legal_moves<MoveGenType::all>(_board, _moves);
+			if (_count == 0)
+			{
+				return -mate_rating_v + _ply;
+			};
+		}
+		else
+		{
+			_best = _rater.rate(_board, _board.turn);
+			_count = generate_quiescence_moves(_board, _moves);
+		};
+
+		for (size_t n = 0; n != _count; ++n)
+		{
+			const auto _undo = make_move(_board, _moves[n]);
+			_best = std::max(_best, -minimax_quiesce(_board, _ply + 1, _rater));
+			unmake_move(_board, _moves[n], _undo);
+		};
+		return _best;
+	};
+
+	/**
+	 * @brief Full width minimax, for checking the alpha-beta search against
+	*/
+	Rating minimax(BoardWithState& _board, int _depth, int _ply, const TestRater& _rater)
+	{
+		if (_depth == 0)
+		{
+			return minimax_quiesce(_board, _ply, _rater);
+		};
+
+		std::array<Move, 256> _moves;
+		const auto _count = generate_legal_moves<MoveGenType::all>(_board, _moves);
+		if (_count == 0)
+		{
+			return (RatingContext{ _board }.in_check()) ? -mate_rating_v + _ply : 0;
+		};
+
+		Rating _best = -mate_rating_v - 1;
+		for (size_t n = 0; n != _count; ++n)
+		{
+			const auto _undo = make_move(_board, _moves[n]);
+			_best = std::max(_best, -minimax(_board, _depth - 1, _ply + 1, _rater));
+			unmake_move(_board, _moves[n], _undo);
+		};
+		return _best;
+	};
+
+	/**
+	 * @brief Counts the nodes of the full move tree down to a depth, the root not included
+	*/
+	uint64_t count_tree_nodes(BoardWithState& _board, int _depth)
+	{
+		if (_depth == 0)
+		{
+			return 0;
+		};
+
+		std::array<Move, 256> _moves;
+		const auto _count = generate_legal_moves<MoveGenType::all>(_board, _moves);
+		uint64_t _nodes = _count;
+		for (size_t n = 0; n != _count; ++n)
+		{
+			const auto _undo = make_move(_board, _moves[n]);
+			_nodes += count_tree_nodes(_board, _depth - 1);
+			unmake_move(_board, _moves[n], _undo);
+		};
+		return _nodes;
+	};
+};
+
+int subtest_matches_minimax()
+{
+	NEWTEST();
+
+	const std::pair<const char*, int> _positions[] =
+	{
+		{ "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 2 },
+		{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 3 },
+		{ "r1bqkbnr/pppp1ppp/2n5/4p3/3PP3/5N2/PPP2PPP/RNBQKB1R b KQkq - 0 3", 1 },
+		{ "4k3/8/3q4/8/3P4/2N5/8/4K3 w - - 0 1", 3 },
+	};
+
+	Searcher<TestRater> _searcher{};
+	for (auto& [_fen, _depth] : _positions)
+	{
+		auto _board = create_board_from_fen(_fen);
+		const auto _result = _searcher.search(_board, _depth);
+		ASSERT(_result.best_move.has_value());
+		ASSERT(_result.rating == minimax(_board, _depth, 0, TestRater{}), "alpha-beta gave a different rating");
+		ASSERT(_result.stats.lazy_eval.evaluations != 0, "the windowed rating was not used");
+
+		// The best move must actually get that rating
+		const auto _undo = make_move(_board, *_result.best_move);
+		ASSERT(-minimax(_board, _depth - 1, 1, TestRater{}) == _result.rating, "best move doesn't match the rating");
+		unmake_move(_board, *_result.best_move, _undo);
+	};
+
+	PASS();
+};
+
+int subtest_mates()
+{
+	NEWTEST();
+
+	Searcher<TestRater> _searcher{};
+
+	// Scholar's mate
+	{
+		const auto _board = create_board_from_fen("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4");
+		const auto _result = _searcher.search(_board, 3);
+		ASSERT(_result.best_move == Move((File::h, Rank::r5), (File::f, Rank::r7)));
+		ASSERT(_result.rating == mate_rating_v - 1);
+		ASSERT(is_mate_rating(_result.rating));
+	};
+
+	// Back rank mate in one
+	{
+		const auto _board = create_board_from_fen("6k1/5ppp/8/8/8/8/8/R3R1K1 w - - 0 1");
+		const auto _result = _searcher.search(_board, 3);
+		ASSERT(_result.rating == mate_rating_v - 1, "mate in one missed");
+	};
+
+	// Mate in two, the king has to take the opposition with a quiet move first
+	{
+		const auto _board = create_board_from_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+		const auto _result = _searcher.search(_board, 3);
+		ASSERT(_result.best_move == Move((File::c, Rank::r6), (File::b, Rank::r6)));
+		ASSERT(_result.rating == mate_rating_v - 3, "mate in two missed");
+	};
+
+	// Checkmated and stalemated, there are no moves to return
+	{
+		const auto _mated = _searcher.search(create_board_from_fen("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1"), 2);
+		ASSERT(!_mated.best_move && _mated.rating == -mate_rating_v);
+		const auto _stalemate = _searcher.search(create_board_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"), 2);
+		ASSERT(!_stalemate.best_move && _stalemate.rating == 0);
+	};
+
+	PASS();
+};
+
+int subtest_node_counts()
+{
+	NEWTEST();
+
+	using clock = std::chrono::steady_clock;
+
+	const char* const _positions[] =
+	{
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	};
+	constexpr int _depth = 4;
+
+	// The full tree is what gets built when every node of the tree is kept
+	Searcher<TestRater> _searcher{};
+	for (auto _fen : _positions)
+	{
+		auto _board = create_board_from_fen(_fen);
+		const auto _treeNodes = count_tree_nodes(_board, _depth);
+
+		const auto _start = clock::now();
+		const auto _result = _searcher.search(_board, _depth);
+		const auto _seconds = std::chrono::duration<double>(clock::now() - _start).count();
+		ASSERT(_result.stats.nodes * 10 < _treeNodes, "alpha-beta should visit far fewer nodes than the full tree");
+
+		std::cout << _fen << "\n\tdepth " << _depth << " : " << _result.stats.nodes << " nodes ("
+			<< _result.stats.quiescence_nodes << " quiescence) against " << _treeNodes << " in the full tree, "
+			<< (static_cast<double>(_treeNodes) / _result.stats.nodes) << "x fewer, " << _seconds * 1000.0 << " ms, "
+			<< (100.0 * _result.stats.lazy_eval.lazy_exits / _result.stats.lazy_eval.evaluations) << "% lazy exits\n";
+	};
+
+	PASS();
+};
+
+int subtest_iterative_deepening()
+{
+	NEWTEST();
+
+	using std::chrono::milliseconds;
+
+	Searcher<TestRater> _searcher{};
+
+	// With time to spare it matches the fixed depth search
+	{
+		const auto _board = create_board_from_fen("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+		const auto _result = _searcher.search(_board, 3, TimeBudget{ milliseconds{ 60000 }, milliseconds{ 60000 } });
+		ASSERT(_result.depth == 3 && !_result.stopped);
+		ASSERT(_result.rating == _searcher.search(_board, 3).rating);
+	};
+
+	// Stops by the hard limit and still has a move from a completed depth, the soft limit is never
+	// reached so only the hard limit can end it
+	{
+		const auto _board = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+		const auto _result = _searcher.search(_board, max_search_ply_v, TimeBudget{ std::chrono::hours{ 24 }, milliseconds{ 100 } });
+		ASSERT(_result.best_move.has_value());
+		ASSERT(_result.depth >= 1 && _result.depth < max_search_ply_v);
+		ASSERT(_result.stopped, "the hard limit should have cut the last depth short");
+	};
+
+	// No time at all still completes depth 1
+	{
+		const auto _board = create_board_from_fen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+		const auto _result = _searcher.search(_board, max_search_ply_v, TimeBudget{});
+		ASSERT(_result.depth == 1 && _result.best_move.has_value());
+		ASSERT(!_result.stopped, "the soft limit ends the search between depths");
+		ASSERT(_result.rating == _searcher.search(_board, 1).rating);
+	};
+
+	// A mate ends the search early
+	{
+		const auto _board = create_board_from_fen("6k1/5ppp/8/8/8/8/8/R3R1K1 w - - 0 1");
+		const auto _result = _searcher.search(_board, max_search_ply_v, TimeBudget{ milliseconds{ 60000 }, milliseconds{ 60000 } });
+		ASSERT(_result.rating == mate_rating_v - 1);
+		ASSERT(_result.depth == 1);
+	};
+
+	PASS();
+};
+
+int subtest_search_depth()
+{
+	NEWTEST();
+
+	const auto _depth = [](const char* _fen)
+	{
+		return search_depth_for_board(create_board_from_fen(_fen));
+	};
+
+	// Start position and a middlegame with the queens off
+	ASSERT(_depth("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") == 3);
+	ASSERT(_depth("r1b1k2r/pppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1PPP/R1B1K2R w KQkq - 0 1") == 4);
+
+	// Pawns count, a full set of them keeps the depth down
+	ASSERT(_depth("4k3/pppppppp/8/8/8/8/PPPPPPPP/4K3 w - - 0 1") == 6);
+	ASSERT(_depth("2b1k3/pppppppp/8/8/8/8/PPPPPPPP/4K3 w - - 0 1") == 5);
+	ASSERT(_depth("8/4k3/4p3/8/8/4P3/4K3/8 w - - 0 1") == 7);
+
+	// Known endgames don't go deep
+	ASSERT(_depth("8/8/4k3/8/8/8/8/R3K3 w - - 0 1") == 4);
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_matches_minimax);
+	SUBTEST(subtest_mates);
+	SUBTEST(subtest_search_depth);
+	SUBTEST(subtest_iterative_deepening);
+	SUBTEST(subtest_node_counts);
+	PASS();
+};
@@ -0,0 +1,126 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/see.hpp>
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <random>
+#include <iostream>
+
+using namespace lbx::chess;
+
+int subtest_known_exchanges()
+{
+	NEWTEST();
+
+	// Undefended pawn
+	{
+		const auto _board = create_board_from_fen("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1");
+		ASSERT(see(_board, Move{ (File::e, Rank::r1), (File::e, Rank::r5) }) == 100);
+	};
+
+	// Knight takes a pawn and the exchange runs through the x-rayed rook and queen
+	{
+		const auto _board = create_board_from_fen("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1");
+		const Move _move{ (File::d, Rank::r3), (File::e, Rank::r5) };
+		ASSERT(see(_board, _move) == 100 - 320);
+		ASSERT(is_losing_capture(_board, _move));
+	};
+
+	// Rook takes a pawn defended by a pawn
+	{
+		const auto _board = create_board_from_fen("4k3/4p3/3p4/8/8/8/8/3RK3 w - - 0 1");
+		ASSERT(see(_board, Move{ (File::d, Rank::r1), (File::d, Rank::r6) }) == 100 - 500);
+	};
+
+	// The king may only recapture when nothing else defends the square
+	{
+		const auto _undefended = create_board_from_fen("8/8/8/8/3k4/3p4/8/3RK3 w - - 0 1");
+		ASSERT(see(_undefended, Move{ (File::d, Rank::r1), (File::d, Rank::r3) }) == 100 - 500);
+
+		const auto _defended = create_board_from_fen("8/8/8/8/3k4/3p4/8/3RKB2 w - - 0 1");
+		ASSERT(see(_defended, Move{ (File::d, Rank::r1), (File::d, Rank::r3) }) == 100);
+	};
+
+	// Quiet move onto a square a pawn attacks
+	{
+		const auto _board = create_board_from_fen("4k3/8/3p4/8/4N3/8/8/4K3 w - - 0 1");
+		const Move _move{ (File::e, Rank::r4), (File::c, Rank::r5) };
+		ASSERT(see(_board, _move) == -320);
+		ASSERT(!is_losing_capture(_board, _move), "quiet moves aren't captures");
+		ASSERT(see(_board, Move{ (File::e, Rank::r4), (File::f, Rank::r6) }) == 0);
+	};
+
+	// En passant and promotion
+	{
+		const auto _enPassant = create_board_from_fen("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+		ASSERT(see(_enPassant, Move{ (File::e, Rank::r5), (File::d, Rank::r6) }) == 100);
+
+		const auto _promotion = create_board_from_fen("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+		ASSERT(see(_promotion, Move{ (File::b, Rank::r7), (File::b, Rank::r8), Piece::queen }) == 800);
+
+		const auto _defendedPromotion = create_board_from_fen("2k5/1P6/8/8/8/8/8/4K3 w - - 0 1");
+		ASSERT(see(_defendedPromotion, Move{ (File::b, Rank::r7), (File::b, Rank::r8), Piece::queen }) == -100);
+	};
+
+	PASS();
+};
+
+int subtest_bounded_by_first_capture()
+{
+	NEWTEST();
+
+	// Declining to recapture is always allowed, so a move can never win more than it takes
+	std::mt19937 _rng{ 5 };
+	size_t _captures = 0;
+	size_t _losing = 0;
+	const auto _start = create_board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	for (int _game = 0; _game != 20; ++_game)
+	{
+		auto _board = _start;
+		for (int _ply = 0; _ply != 60; ++_ply)
+		{
+			const auto _moves = find_possible_moves(_board);
+			if (_moves.empty())
+			{
+				break;
+			};
+
+			for (auto& m : _moves)
+			{
+				const auto _packed = pack_move(_board, m);
+				Rating _taken = see_piece_value(_board.get(m.to));
+				if (_packed.kind() == MoveKind::en_passant)
+				{
+					_taken = see_piece_value(Piece::pawn);
+				};
+				if (_packed.is_promotion())
+				{
+					_taken += see_piece_value(m.promotion) - see_piece_value(Piece::pawn);
+				};
+
+				const auto _value = see(_board, m);
+				ASSERT(_value <= _taken, "exchange won more than the first capture");
+				if (_packed.is_capture())
+				{
+					++_captures;
+					_losing += is_losing_capture(_board, m);
+				};
+			};
+			apply_move(_board, _moves.at(_rng() % _moves.size()));
+		};
+	};
+
+	std::cout << _losing << " of " << _captures << " captures lose material\n";
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_known_exchanges);
+	SUBTEST(subtest_bounded_by_first_capture);
+	PASS();
+};
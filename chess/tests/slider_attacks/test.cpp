@@ -0,0 +1,116 @@
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/move_validation.hpp>
+#include <lambdex/chess/board/piece_board.hpp>
+
+#include <jclib-test.hpp>
+
+#include <array>
+#include <random>
+#include <iostream>
+
+using namespace lbx::chess;
+
+/**
+ * @brief A board with some random squares filled in along with its occupancy bits
+*/
+struct RandomOccupancy
+{
+	PieceBoard board{};
+	BitBoard bits{};
+};
+
+std::vector<RandomOccupancy> make_random_occupancies(size_t _count)
+{
+	// Fixed seed so failures can be reproduced
+	std::mt19937_64 _rng{ 0x5EED };
+	std::vector<RandomOccupancy> _out(_count);
+	for (auto& o : _out)
+	{
+		// Mix of sparse and crowded boards
+		auto _bits = _rng() & _rng();
+		if (_rng() & 1)
+		{
+			_bits &= _rng();
+		};
+		o.bits = BitBoard{ _bits };
+		for (Position p{}; p != Position::end(); ++p)
+		{
+			if (o.bits.at(p))
+			{
+				o.board[p] = Piece::pawn_white;
+			};
+		};
+	};
+	return _out;
+};
+
+/**
+ * @brief Finds the squares a slider attacks the way move generation used to, by
+ * classifying every square and scanning the path to it.
+*/
+BitBoard path_scan_attacks(const PieceBoard& _board, Position _from, bool _orthogonal, bool _diagonal)
+{
+	BitBoard _out{};
+	for (Position _to{}; _to != Position::end(); ++_to)
+	{
+		if (_to == _from)
+		{
+			continue;
+		};
+
+		const auto _class = classify_movement(_from, _to);
+		const bool _slides =
+			(_class == MovementClass::diagonal && _diagonal) ||
+			((_class == MovementClass::file || _class == MovementClass::rank) && _orthogonal);
+		if (_slides && !find_piece_in_path(_board, _from, _to, _class))
+		{
+			_out.set(_to);
+		};
+	};
+	return _out;
+};
+
+
+
+int subtest_backend(SliderAttackBackend _backend)
+{
+	NEWTEST();
+
+	if (!set_slider_attack_backend(_backend))
+	{
+		std::cout << "backend " << static_cast<int>(_backend) << " not supported on this CPU, skipping\n";
+		PASS();
+	};
+
+	const auto _occupancies = make_random_occupancies(200);
+	for (auto& o : _occupancies)
+	{
+		for (Position p{}; p != Position::end(); ++p)
+		{
+			ASSERT(rook_attacks(p, o.bits) == path_scan_attacks(o.board, p, true, false), "rook attacks don't match path scan");
+			ASSERT(bishop_attacks(p, o.bits) == path_scan_attacks(o.board, p, false, true), "bishop attacks don't match path scan");
+			ASSERT(queen_attacks(p, o.bits) == path_scan_attacks(o.board, p, true, true), "queen attacks don't match path scan");
+		};
+	};
+
+	PASS();
+};
+
+int subtest_magic()
+{
+	return subtest_backend(SliderAttackBackend::magic);
+};
+int subtest_pext()
+{
+	return subtest_backend(SliderAttackBackend::pext);
+};
+
+int main()
+{
+	NEWTEST();
+	const auto _defaultBackend = get_slider_attack_backend();
+	SUBTEST(subtest_magic);
+	SUBTEST(subtest_pext);
+	set_slider_attack_backend(_defaultBackend);
+	PASS();
+};
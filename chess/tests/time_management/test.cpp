@@ -0,0 +1,52 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/time_management.hpp>
+
+using namespace lbx::chess;
+using std::chrono::milliseconds;
+
+int subtest_budgets()
+{
+	NEWTEST();
+
+	// One minute bullet, the time is shared over the expected moves left
+	{
+		const GameClock _clock{ milliseconds{ 60000 }, milliseconds{ 60000 }, milliseconds{ 0 }, milliseconds{ 0 } };
+		const auto _budget = budget_move_time(_clock, Color::white);
+		ASSERT(_budget.soft == (milliseconds{ 60000 } - move_overhead_v) / expected_moves_left_v);
+		ASSERT(_budget.hard == _budget.soft * 4);
+	};
+
+	// Only the player's own clock counts
+	{
+		const GameClock _clock{ milliseconds{ 1000 }, milliseconds{ 180000 }, milliseconds{ 0 }, milliseconds{ 2000 } };
+		const auto _white = budget_move_time(_clock, Color::white);
+		const auto _black = budget_move_time(_clock, Color::black);
+		ASSERT(_white.soft < _black.soft);
+		ASSERT(_black.soft == (milliseconds{ 180000 } - move_overhead_v) / expected_moves_left_v + milliseconds{ 1500 });
+	};
+
+	// Nearly flagged with a big increment, never spend more than half of what is left
+	{
+		const GameClock _clock{ milliseconds{ 300 }, milliseconds{ 300 }, milliseconds{ 5000 }, milliseconds{ 5000 } };
+		const auto _budget = budget_move_time(_clock, Color::black);
+		ASSERT(_budget.hard == (milliseconds{ 300 } - move_overhead_v) / 2);
+		ASSERT(_budget.soft <= _budget.hard);
+	};
+
+	// Out of time
+	{
+		const GameClock _clock{ milliseconds{ 50 }, milliseconds{ 50 }, milliseconds{ 0 }, milliseconds{ 0 } };
+		const auto _budget = budget_move_time(_clock, Color::white);
+		ASSERT(_budget.soft == milliseconds{ 0 } && _budget.hard == milliseconds{ 0 });
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_budgets);
+	PASS();
+};
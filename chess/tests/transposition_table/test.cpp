@@ -0,0 +1,226 @@
+#include <jclib-test.hpp>
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/search.hpp>
+#include <lambdex/chess/fused_rater.hpp>
+#include <lambdex/chess/transposition_table.hpp>
+
+#include <random>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <iostream>
+
+using namespace lbx::chess;
+
+namespace
+{
+	using TestRater = BoardRater_Fused<BoardRater_PieceSquare, BoardRater_CastleOpportunity, BoardRater_Mobility>;
+};
+
+int subtest_store_and_probe()
+{
+	NEWTEST();
+
+	TranspositionTable _table{ 1 };
+	ASSERT(_table.size() == 1024 * 1024 / 16);
+
+	const ZobristKey _key = 0x0123456789ABCDEFull;
+	const PackedMove _move{ Move{ (File::e, Rank::r2), (File::e, Rank::r4) } };
+	ASSERT(!_table.probe(_key));
+
+	ASSERT(!_table.store(_key, _move, -mate_rating_v + 3, 7, Bound::lower));
+	{
+		const auto _entry = _table.probe(_key);
+		ASSERT(_entry);
+		ASSERT(_entry->move == _move);
+		ASSERT(_entry->rating == -mate_rating_v + 3);
+		ASSERT(_entry->depth == 7);
+		ASSERT(_entry->bound == Bound::lower);
+		ASSERT(_entry->age == _table.age());
+	};
+
+	// Same bucket but a different position
+	ASSERT(!_table.probe(_key ^ 0x8000000000000000ull));
+
+	// A shallower bound doesn't replace a deeper result from the same search
+	_table.store(_key, PackedMove{}, 50, 2, Bound::upper);
+	ASSERT(_table.probe(_key)->depth == 7);
+
+	// A result without a move keeps the move already stored
+	_table.store(_key, PackedMove{}, 120, 9, Bound::exact);
+	{
+		const auto _entry = _table.probe(_key);
+		ASSERT(_entry->rating == 120 && _entry->depth == 9 && _entry->bound == Bound::exact);
+		ASSERT(_entry->best_move() == _move.unpack());
+	};
+
+	_table.clear();
+	ASSERT(!_table.probe(_key));
+
+	PASS();
+};
+
+int subtest_replacement()
+{
+	NEWTEST();
+
+	TranspositionTable _table{ 1 };
+	const auto _buckets = _table.size() / TranspositionTable::bucket_size_v;
+
+	// Keys that all land in bucket 5
+	const auto _key = [_buckets](uint64_t n) -> ZobristKey
+	{
+		return 5 + (n + 1) * _buckets;
+	};
+
+	for (uint64_t n = 0; n != TranspositionTable::bucket_size_v; ++n)
+	{
+		ASSERT(!_table.store(_key(n), PackedMove{}, 0, 10 + static_cast<int>(n), Bound::exact), "filling empty entries isn't a collision");
+	};
+
+	// The shallowest entry goes first
+	ASSERT(_table.store(_key(10), PackedMove{}, 0, 20, Bound::exact), "replacing an entry from this search is a collision");
+	ASSERT(!_table.probe(_key(0)));
+	ASSERT(_table.probe(_key(1)) && _table.probe(_key(10)));
+
+	// Entries from an earlier search go before deeper ones from this search
+	_table.new_search();
+	ASSERT(_table.fill_rate() == 0.0);
+	ASSERT(!_table.store(_key(11), PackedMove{}, 0, 10, Bound::exact), "replacing an old entry isn't a collision");
+	ASSERT(!_table.store(_key(12), PackedMove{}, 0, 10, Bound::exact));
+	ASSERT(_table.probe(_key(11)) && _table.probe(_key(12)));
+	ASSERT(_table.probe(_key(10)), "the deepest old entry should still be there");
+	ASSERT(_table.fill_rate() > 0.0);
+
+	PASS();
+};
+
+int subtest_threads()
+{
+	NEWTEST();
+
+	// Small enough that the threads keep overwriting each other's entries
+	TranspositionTable _table{ 1 };
+
+	constexpr size_t key_count_v = 1 << 18;
+	std::vector<ZobristKey> _keys(key_count_v);
+	std::mt19937_64 _rnd{ 1234 };
+	for (auto& _key : _keys)
+	{
+		_key = _rnd();
+	};
+
+	// The stored data is worked out from the key so a hit can be checked
+	const auto _ratingFor = [](ZobristKey _key) { return static_cast<Rating>(_key >> 44); };
+	const auto _depthFor = [](ZobristKey _key) { return static_cast<int>((_key >> 20) & 0xFF); };
+
+	std::atomic<uint64_t> _hits{ 0 };
+	std::atomic<uint64_t> _bad{ 0 };
+	std::vector<std::thread> _threads{};
+	for (int t = 0; t != 4; ++t)
+	{
+		_threads.emplace_back([&, t]()
+		{
+			std::mt19937_64 _rnd{ static_cast<uint64_t>(t) };
+			uint64_t _myHits = 0;
+			uint64_t _myBad = 0;
+			for (int n = 0; n != 400000; ++n)
+			{
+				const auto _key = _keys[_rnd() % key_count_v];
+				if (n % 2 == 0)
+				{
+					_table.store(_key, PackedMove{ static_cast<PackedMove::value_type>(_key) }, _ratingFor(_key), _depthFor(_key), Bound::exact);
+				}
+				else if (const auto _entry = _table.probe(_key); _entry)
+				{
+					++_myHits;
+					if (_entry->rating != _ratingFor(_key) || _entry->depth != _depthFor(_key) ||
+						_entry->move.get() != static_cast<PackedMove::value_type>(_key))
+					{
+						++_myBad;
+					};
+				};
+			};
+			_hits += _myHits;
+			_bad += _myBad;
+		});
+	};
+	for (auto& _thread : _threads)
+	{
+		_thread.join();
+	};
+
+	ASSERT(_hits != 0);
+	ASSERT(_bad == 0, "a hit returned data written for a different position");
+
+	PASS();
+};
+
+int subtest_search()
+{
+	NEWTEST();
+
+	using std::chrono::milliseconds;
+
+	TranspositionTable _table{ 16, true };
+	std::cout << "16MB table, " << _table.size() << " entries, huge pages " << (_table.uses_huge_pages() ? "on" : "off") << '\n';
+
+	// Mate ratings are stored relative to the node and must come back out relative to the root
+	{
+		Searcher<TestRater> _searcher{ _table };
+		const auto _board = create_board_from_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1");
+		for (int n = 0; n != 2; ++n)
+		{
+			_table.new_search();
+			const auto _result = _searcher.search(_board, 5);
+			ASSERT(_result.best_move == Move((File::c, Rank::r6), (File::b, Rank::r6)));
+			ASSERT(_result.rating == mate_rating_v - 3, "mate in two rated wrong");
+		};
+	};
+
+	// The table saves work within a search and on the next turn
+	const char* const _positions[] =
+	{
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+	};
+	constexpr int _depth = 5;
+	const TimeBudget _budget{ milliseconds{ 600000 }, milliseconds{ 600000 } };
+	for (auto _fen : _positions)
+	{
+		_table.clear();
+		const auto _board = create_board_from_fen(_fen);
+
+		Searcher<TestRater> _plain{};
+		Searcher<TestRater> _searcher{ _table };
+		const auto _without = _plain.search(_board, _depth, _budget);
+		const auto _with = _searcher.search(_board, _depth, _budget);
+		ASSERT(_with.best_move && _with.depth == _depth);
+		ASSERT(_with.stats.nodes < _without.stats.nodes, "the table should save nodes");
+		ASSERT(_with.stats.table.hits != 0 && _with.stats.table.stores != 0);
+
+		// Searching again, as on the next turn, starts from what is already stored
+		_table.new_search();
+		const auto _again = _searcher.search(_board, _depth, _budget);
+		ASSERT(_again.stats.nodes < _with.stats.nodes);
+
+		const auto _totals = _table.stats();
+		std::cout << _fen << "\n\tdepth " << _depth << " : " << _without.stats.nodes << " nodes without the table, "
+			<< _with.stats.nodes << " with it, " << _again.stats.nodes << " searching again. hit rate "
+			<< _totals.hit_rate() * 100.0 << "%, fill rate " << _table.fill_rate() * 100.0 << "%, "
+			<< _totals.collisions << " collisions in " << _totals.stores << " stores\n";
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_store_and_probe);
+	SUBTEST(subtest_replacement);
+	SUBTEST(subtest_threads);
+	SUBTEST(subtest_search);
+	PASS();
+};
@@ -0,0 +1,222 @@
+#include "perft.hpp"
+
+#include "utility/io.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/apply_move.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+	constexpr auto start_fen_v = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+	void print_usage()
+	{
+		lbx::println("usage: deeper_blue-perft [options] [moves...]");
+		lbx::println("\t--fen <fen>        position to start from, defaults to the starting position");
+		lbx::println("\t--depth <n>        depth in plies, defaults to 5");
+		lbx::println("\t--divide           print the node count below each root move");
+		lbx::println("\t--threads <n>      split the root moves across n worker threads");
+		lbx::println("\t--hash <mb>        cache node counts in a hash table of this size");
+		lbx::println("\t--no-bulk          make every leaf move instead of counting them");
+		lbx::println("\t--expect <n>       exit with an error if the node count differs");
+		lbx::println("\t--suite            check the standard positions against their known counts");
+		lbx::println("\t--max-nodes <n>    skip suite entries with more nodes than this");
+		lbx::println("\tmoves...           moves to play from the position before counting, ie. e2e4 e7e5");
+	};
+
+	template <typename T>
+	std::optional<T> parse_number(std::string_view _str)
+	{
+		T _value{};
+		const auto _result = std::from_chars(_str.data(), _str.data() + _str.size(), _value);
+		if (_result.ec != std::errc{} || _result.ptr != _str.data() + _str.size())
+		{
+			return std::nullopt;
+		};
+		return _value;
+	};
+
+	void print_result(const lbx::chess::PerftResult& _result)
+	{
+		lbx::println("Nodes searched: {}", _result.nodes);
+		lbx::println("Time: {:.3f}s ({:.0f} nodes/s)", _result.seconds, _result.nodes_per_second());
+	};
+
+	/**
+	 * @brief Runs the suite of standard positions
+	 * @return True if every count matched
+	*/
+	bool run_suite(const lbx::chess::PerftOptions& _options, uint64_t _maxNodes)
+	{
+		using namespace lbx::chess;
+
+		bool _passed = true;
+		uint64_t _totalNodes = 0;
+		double _totalSeconds = 0.0;
+		for (auto& e : perft_suite())
+		{
+			if (e.nodes > _maxNodes)
+			{
+				continue;
+			};
+
+			const auto _result = perft(create_board_from_fen(e.fen), e.depth, _options);
+			const bool _matched = _result.nodes == e.nodes;
+			_passed = _passed && _matched;
+			_totalNodes += _result.nodes;
+			_totalSeconds += _result.seconds;
+
+			lbx::println("{:<12} depth {} : {:>10} nodes {:>8.3f}s {:>12.0f} nodes/s {}",
+				e.name, e.depth, _result.nodes, _result.seconds, _result.nodes_per_second(),
+				(_matched) ? "ok" : lbx::format("FAILED (expected {})", e.nodes));
+		};
+
+		lbx::println("Total: {} nodes in {:.3f}s ({:.0f} nodes/s)", _totalNodes, _totalSeconds,
+			(_totalSeconds > 0.0) ? static_cast<double>(_totalNodes) / _totalSeconds : 0.0);
+		return _passed;
+	};
+};
+
+int main(int _nargs, char* _vargs[])
+{
+	using namespace lbx::chess;
+
+	std::string _fen = start_fen_v;
+	int _depth = 5;
+	bool _divide = false;
+	bool _suite = false;
+	std::optional<uint64_t> _expected{};
+	uint64_t _maxNodes = UINT64_MAX;
+	std::vector<std::string_view> _moves{};
+	PerftOptions _options{};
+
+	for (int n = 1; n < _nargs; ++n)
+	{
+		const std::string_view _arg = _vargs[n];
+
+		// Gets the value following an option
+		const auto next_value = [&n, _nargs, _vargs, _arg]() -> std::optional<std::string_view>
+		{
+			if (n + 1 >= _nargs)
+			{
+				lbx::println("missing value for {}", _arg);
+				return std::nullopt;
+			};
+			return std::string_view{ _vargs[++n] };
+		};
+
+		if (_arg == "--fen")
+		{
+			const auto _value = next_value();
+			if (!_value) { return -1; };
+			_fen = *_value;
+		}
+		else if (_arg == "--depth" || _arg == "--threads" || _arg == "--hash" || _arg == "--expect" || _arg == "--max-nodes")
+		{
+			const auto _value = next_value();
+			const auto _number = (_value) ? parse_number<uint64_t>(*_value) : std::nullopt;
+			if (!_number)
+			{
+				lbx::println("expected a number for {}", _arg);
+				return -1;
+			};
+
+			if (_arg == "--depth")
+			{
+				_depth = static_cast<int>(*_number);
+			}
+			else if (_arg == "--threads")
+			{
+				_options.threads = std::max<size_t>(*_number, 1);
+			}
+			else if (_arg == "--hash")
+			{
+				_options.hash_mb = *_number;
+			}
+			else if (_arg == "--expect")
+			{
+				_expected = *_number;
+			}
+			else
+			{
+				_maxNodes = *_number;
+			};
+		}
+		else if (_arg == "--divide")
+		{
+			_divide = true;
+		}
+		else if (_arg == "--no-bulk")
+		{
+			_options.bulk_counting = false;
+		}
+		else if (_arg == "--suite")
+		{
+			_suite = true;
+		}
+		else if (_arg == "--help" || _arg == "-h")
+		{
+			print_usage();
+			return 0;
+		}
+		else if (_arg.starts_with("--"))
+		{
+			lbx::println("unrecognized option \"{}\"", _arg);
+			print_usage();
+			return -1;
+		}
+		else
+		{
+			_moves.push_back(_arg);
+		};
+	};
+
+	if (_suite)
+	{
+		return (run_suite(_options, _maxNodes)) ? 0 : 1;
+	};
+
+	if (_depth < 1)
+	{
+		lbx::println("depth must be at least 1");
+		return -1;
+	};
+
+	auto _board = create_board_from_fen(_fen);
+
+	for (auto& ms : _moves)
+	{
+		Move _move{};
+		if (from_chars(ms, _move).ec != std::errc{})
+		{
+			lbx::println("invalid move \"{}\"", ms);
+			return -1;
+		};
+		apply_move(_board, _move);
+	};
+
+	const auto _result = perft(_board, _depth, _options);
+	if (_divide)
+	{
+		for (auto& e : _result.divide)
+		{
+			lbx::println("{}: {}", e.move, e.nodes);
+		};
+		lbx::println("");
+	};
+	print_result(_result);
+
+	if (_expected && *_expected != _result.nodes)
+	{
+		lbx::println("FAILED, expected {} nodes", *_expected);
+		return 1;
+	};
+	return 0;
+};
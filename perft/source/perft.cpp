@@ -0,0 +1,196 @@
+#include "perft.hpp"
+
+#include "utility/io.hpp"
+#include "utility/thread_pool.hpp"
+
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <bit>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <functional>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Shared table of node counts keyed by position and depth.
+		 *
+		 * Each entry stores its key XOR'd with its data so a torn write from another
+		 * thread just looks like a miss, no locking is needed.
+		*/
+		class PerftHashTable
+		{
+		public:
+
+			bool probe(ZobristKey _key, int _depth, uint64_t& _nodes) const noexcept
+			{
+				const auto& _entry = this->entries_[_key & this->mask_];
+				const auto _data = _entry.data.load(std::memory_order_relaxed);
+				const auto _check = _entry.check.load(std::memory_order_relaxed);
+				if ((_check ^ _data) == _key && static_cast<int>(_data & 0xFF) == _depth)
+				{
+					_nodes = _data >> 8;
+					return true;
+				};
+				return false;
+			};
+
+			void store(ZobristKey _key, int _depth, uint64_t _nodes) noexcept
+			{
+				auto& _entry = this->entries_[_key & this->mask_];
+				const auto _data = (_nodes << 8) | static_cast<uint64_t>(_depth);
+				_entry.data.store(_data, std::memory_order_relaxed);
+				_entry.check.store(_key ^ _data, std::memory_order_relaxed);
+			};
+
+			/**
+			 * @brief Allocates the table
+			 * @param _megabytes Table size, rounded down to a power of two entries
+			*/
+			explicit PerftHashTable(size_t _megabytes)
+			{
+				const auto _wanted = std::max<size_t>((_megabytes * 1024 * 1024) / sizeof(Entry), 1);
+				const auto _count = std::bit_floor(_wanted);
+				this->entries_ = std::make_unique<Entry[]>(_count);
+				this->mask_ = _count - 1;
+			};
+
+		private:
+
+			struct Entry
+			{
+				std::atomic<uint64_t> check{ 0 };
+				std::atomic<uint64_t> data{ 0 };
+			};
+
+			std::unique_ptr<Entry[]> entries_;
+			size_t mask_ = 0;
+		};
+
+		uint64_t count_nodes(BoardWithState& _board, int _depth, bool _bulk, PerftHashTable* _hash)
+		{
+			if (_depth == 0)
+			{
+				return 1;
+			};
+
+			const auto _moves = find_possible_moves(_board);
+			const auto _count = _moves.size();
+			if (_bulk && _depth == 1)
+			{
+				return _count;
+			};
+
+			const auto _key = _board.zobrist_key();
+			uint64_t _nodes = 0;
+			if (_hash && _depth > 1 && _hash->probe(_key, _depth, _nodes))
+			{
+				return _nodes;
+			};
+
+			for (size_t n = 0; n != _count; ++n)
+			{
+				const auto _undo = make_move(_board, _moves[n]);
+				_nodes += count_nodes(_board, _depth - 1, _bulk, _hash);
+				unmake_move(_board, _moves[n], _undo);
+			};
+
+			if (_hash && _depth > 1)
+			{
+				_hash->store(_key, _depth, _nodes);
+			};
+			return _nodes;
+		};
+	};
+
+	/**
+	 * @brief Counts the leaf nodes of the legal move tree
+	 * @param _board Board to start from
+	 * @param _depth Depth in plies, must be at least 1
+	 * @param _options Perft settings
+	 * @return Node counts and timing
+	*/
+	PerftResult perft(const BoardWithState& _board, int _depth, const PerftOptions& _options)
+	{
+		JCLIB_ASSERT(_depth >= 1);
+		JCLIB_ASSERT(_options.threads != 0);
+
+		const auto _start = std::chrono::steady_clock::now();
+
+		std::unique_ptr<PerftHashTable> _hash{};
+		if (_options.hash_mb != 0)
+		{
+			_hash = std::make_unique<PerftHashTable>(_options.hash_mb);
+		};
+
+		PerftResult _out{};
+		for (auto& m : find_possible_moves(_board))
+		{
+			_out.divide.push_back(PerftDivideEntry{ m, 0 });
+		};
+
+		const auto count_root_move = [&_board, _depth, &_options, &_hash](PerftDivideEntry& _entry)
+		{
+			auto _child = _board;
+			make_move(_child, _entry.move);
+			_entry.nodes = count_nodes(_child, _depth - 1, _options.bulk_counting, _hash.get());
+		};
+
+		if (_options.threads == 1)
+		{
+			for (auto& e : _out.divide)
+			{
+				count_root_move(e);
+			};
+		}
+		else
+		{
+			// Each root move is its own task, entries don't move so the workers can write straight into them
+			worker_pool _pool{ _options.threads };
+			for (auto& e : _out.divide)
+			{
+				_pool.assign_work([&count_root_move, &e]()
+					{
+						count_root_move(e);
+					});
+			};
+			_pool.wait_until_all_finished();
+		};
+
+		for (auto& e : _out.divide)
+		{
+			_out.nodes += e.nodes;
+		};
+		_out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+		return _out;
+	};
+
+	/**
+	 * @brief Gets the standard perft positions along with their known node counts
+	 * @return Suite entries, ordered from smallest to largest count for each position
+	*/
+	std::span<const PerftSuiteEntry> perft_suite()
+	{
+		constexpr static auto _suite = std::array
+		{
+			PerftSuiteEntry{ "start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281 },
+			PerftSuiteEntry{ "start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609 },
+			PerftSuiteEntry{ "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862 },
+			PerftSuiteEntry{ "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603 },
+			PerftSuiteEntry{ "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624 },
+			PerftSuiteEntry{ "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083 },
+			PerftSuiteEntry{ "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467 },
+			PerftSuiteEntry{ "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+			PerftSuiteEntry{ "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379 },
+			PerftSuiteEntry{ "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+			PerftSuiteEntry{ "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890 },
+			PerftSuiteEntry{ "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 },
+		};
+		return _suite;
+	};
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+	Counts the leaf nodes of the legal move tree to a fixed depth (perft), used to check
+	the move generator against known node counts and to measure its speed.
+*/
+
+#include <lambdex/chess/move.hpp>
+#include <lambdex/chess/board/board_with_state.hpp>
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Settings for a perft run
+	*/
+	struct PerftOptions
+	{
+		/**
+		 * @brief Number of worker threads to split the root moves across, 1 runs on the calling thread
+		*/
+		size_t threads = 1;
+
+		/**
+		 * @brief Size of the node count hash table in megabytes, 0 disables hashing
+		*/
+		size_t hash_mb = 0;
+
+		/**
+		 * @brief Count the moves at depth 1 instead of making each of them
+		*/
+		bool bulk_counting = true;
+	};
+
+	/**
+	 * @brief Node count below a single root move
+	*/
+	struct PerftDivideEntry
+	{
+		Move move;
+		uint64_t nodes;
+	};
+
+	/**
+	 * @brief Result of a perft run
+	*/
+	struct PerftResult
+	{
+		/**
+		 * @brief Total leaf nodes
+		*/
+		uint64_t nodes = 0;
+
+		/**
+		 * @brief Leaf nodes below each root move, in generation order
+		*/
+		std::vector<PerftDivideEntry> divide{};
+
+		/**
+		 * @brief Wall clock time taken
+		*/
+		double seconds = 0.0;
+
+		/**
+		 * @brief Gets the nodes counted per second
+		*/
+		double nodes_per_second() const noexcept
+		{
+			return (this->seconds > 0.0) ? static_cast<double>(this->nodes) / this->seconds : 0.0;
+		};
+	};
+
+	/**
+	 * @brief Counts the leaf nodes of the legal move tree
+	 * @param _board Board to start from
+	 * @param _depth Depth in plies, must be at least 1
+	 * @param _options Perft settings
+	 * @return Node counts and timing
+	*/
+	PerftResult perft(const BoardWithState& _board, int _depth, const PerftOptions& _options);
+
+	/**
+	 * @brief A position with a known node count
+	*/
+	struct PerftSuiteEntry
+	{
+		std::string_view name;
+		std::string_view fen;
+		int depth;
+		uint64_t nodes;
+	};
+
+	/**
+	 * @brief Gets the standard perft positions along with their known node counts
+	 * @return Suite entries, ordered from smallest to largest count for each position
+	*/
+	std::span<const PerftSuiteEntry> perft_suite();
+};
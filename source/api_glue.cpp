@@ -113,7 +113,7 @@ namespace lbx
 		const std::string _gameID = _event.at("game").at("id");
 
 		// Assign a new engine to the game
-		this->assign_to_game(_gameID, jc::make_unique<chess::ChessEngine_Baby>(this->tree_build_pool_));
+		this->assign_to_game(_gameID, jc::make_unique<chess::ChessEngine_Search>(this->search_resources_));
 	};
 
 	/**
@@ -9,6 +9,7 @@
 
 #include "chess/engines/random_engine.hpp"
 #include "chess/engines/baby_engine.hpp"
+#include "chess/engines/search_engine.hpp"
 #include "chess/engines/neural_engine.hpp"
 
 #include "utility/io.hpp"
@@ -20,10 +21,12 @@
 #include <jclib/thread.h>
 #include <jclib/timer.h>
 
+#include <chrono>
 #include <random>
 #include <ranges>
 #include <fstream>
 #include <iterator>
+#include <optional>
 #include <algorithm>
 #include <iostream>
 
@@ -67,6 +70,41 @@ namespace lbx::chess
 		return _moves;
 	};
 
+	/**
+	 * @brief Reads the clock from a lichess game state
+	 * See https://lichess.org/api#operation/botGameStream
+	 * @param _state Game state json, holds the time left and increments in milliseconds
+	 * @return The clock, or nullopt if the game isn't timed
+	*/
+	inline std::optional<GameClock> parse_game_clock(const lbx::json& _state)
+	{
+		const auto _millis = [&_state](const char* _key) -> std::optional<std::chrono::milliseconds>
+		{
+			if (const auto it = _state.find(_key); it != _state.end() && it->is_number())
+			{
+				return std::chrono::milliseconds{ it->get<int64_t>() };
+			}
+			else
+			{
+				return std::nullopt;
+			};
+		};
+
+		const auto _wtime = _millis("wtime");
+		const auto _btime = _millis("btime");
+		if (!_wtime || !_btime)
+		{
+			return std::nullopt;
+		};
+
+		GameClock _out{};
+		_out.white_time = *_wtime;
+		_out.black_time = *_btime;
+		_out.white_increment = _millis("winc").value_or(std::chrono::milliseconds{ 0 });
+		_out.black_increment = _millis("binc").value_or(std::chrono::milliseconds{ 0 });
+		return _out;
+	};
+
 	/**
 	 * @brief Recreates a chess board state from a move string
 	 * @param _movesString String containing a series of moves
@@ -179,6 +217,15 @@ namespace lbx
 				return format("game_{}", this->api_->game_id_);
 			};
 
+			/**
+			 * @brief Gets the game clock as of the last game state lichess sent
+			 * @return The clock, or nullopt if the game isn't timed
+			*/
+			std::optional<lbx::chess::GameClock> get_clock() final
+			{
+				return this->api_->clock_;
+			};
+
 			Interface(GameAPI* _api) :
 				api_{ _api }
 			{};
@@ -203,6 +250,7 @@ namespace lbx
 		std::ofstream error_log_file_{ SOURCE_ROOT "/errlog.txt" };
 		chess::BoardWithState board_{};
 		chess::Color my_color_ = chess::Color::white;
+		std::optional<chess::GameClock> clock_{};
 
 
 		/**
@@ -261,6 +309,7 @@ namespace lbx
 
 			// Recreate board state
 			this->recreate_board_from_move_string(_event.at("state").at("moves"));
+			this->clock_ = chess::parse_game_clock(_event.at("state"));
 
 			// If it is our turn to play, make the move and submit
 			if (this->is_my_turn())
@@ -287,6 +336,7 @@ namespace lbx
 
 				// Recreate board from moves
 				this->recreate_board_from_move_string(_event.at("moves"));
+				this->clock_ = chess::parse_game_clock(_event);
 
 				// Process turn if it is our turn
 				if (this->is_my_turn())
@@ -412,9 +462,9 @@ namespace lbx
 		chess::ControllerHost controller_;
 
 		/**
-		 * @brief TEMPORARY thread pool for tree building.
+		 * @brief Transposition table and search threads shared by every game being played.
 		*/
-		std::shared_ptr<chess::TreeBuildPool> tree_build_pool_{ new chess::TreeBuildPool{ 8 } };
+		std::shared_ptr<chess::SearchEngineResources> search_resources_{ new chess::SearchEngineResources{} };
 	};
 
 };
\ No newline at end of file
@@ -15,7 +15,7 @@ namespace lbx::chess
 	/**
 	 *  Returns all (supposedly) valid moves randomly shuffled
 	*/
-	lbx::arena<Move> ChessEngine_Random::calculate_multiple_moves(const BoardWithState& _board, Color _player)
+	MoveList ChessEngine_Random::calculate_multiple_moves(const BoardWithState& _board, Color _player)
 	{
 		// Find all possible moves
 		auto _moves = find_possible_moves(_board);
@@ -23,7 +23,7 @@ namespace lbx::chess
 		// Randomize found moves
 		static thread_local std::random_device rd{};
 		static thread_local std::mt19937 g(rd());
-		std::shuffle(_moves.data(), _moves.data() + _moves.size(), g);
+		std::shuffle(_moves.begin(), _moves.end(), g);
 
 		// Return randomized moves
 		return _moves;
@@ -32,7 +32,7 @@ namespace lbx::chess
 	void ChessEngine_Random::play_turn(IGameInterface& _game)
 	{
 		auto _moves = this->calculate_multiple_moves(_game.get_board(), _game.get_color());
-		for (auto& m : std::span{ _moves.data(), _moves.size() })
+		for (auto& m : _moves)
 		{
 			const auto _good = _game.submit_move(m);
 			if (_good)
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <lambdex/chess/chess_engine.hpp>
-#include <lambdex/utility/arena.hpp>
+#include <lambdex/chess/move_list.hpp>
 
 namespace lbx::chess
 {
@@ -15,7 +15,7 @@ namespace lbx::chess
 		/**
 		 *  Returns all (supposedly) valid moves randomly shuffled
 		*/
-		lbx::arena<Move> calculate_multiple_moves(const BoardWithState& _board, Color _player);
+		MoveList calculate_multiple_moves(const BoardWithState& _board, Color _player);
 
 		/**
 		 *	Returns a random but (hopefully) valid move
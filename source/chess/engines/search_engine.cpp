@@ -0,0 +1,120 @@
+#include "search_engine.hpp"
+
+#include "utility/io.hpp"
+
+#include <jclib/timer.h>
+
+namespace lbx::chess
+{
+	namespace
+	{
+		/**
+		 * @brief Budget for untimed games, the search stops at its depth long before this runs out
+		*/
+		constexpr TimeBudget untimed_budget_v{ std::chrono::hours{ 24 }, std::chrono::hours{ 24 } };
+	};
+
+	/**
+	 * @brief Takes helper threads from the budget
+	 * @param _wanted Most helper threads to take
+	 * @return Helper threads taken, may be 0, give them back with release_threads()
+	*/
+	size_t SearchEngineResources::acquire_threads(size_t _wanted) noexcept
+	{
+		auto _free = this->free_helpers_.load(std::memory_order_relaxed);
+		size_t _taken = 0;
+		do
+		{
+			_taken = std::min(_free, _wanted);
+		}
+		while (!this->free_helpers_.compare_exchange_weak(_free, _free - _taken, std::memory_order_relaxed));
+		return _taken;
+	};
+
+	/**
+	 * @brief Gives helper threads back to the budget
+	 * @param _count Helper threads to give back, as returned by acquire_threads()
+	*/
+	void SearchEngineResources::release_threads(size_t _count) noexcept
+	{
+		this->free_helpers_.fetch_add(_count, std::memory_order_relaxed);
+	};
+
+	/**
+	 * @brief Constructs the shared state
+	 * @param _threads Threads shared between the games, defaults to one per hardware thread
+	 * @param _tableMegabytes Size of the transposition table
+	 * @param _hugePages Ask for the transposition table to be backed by huge pages
+	*/
+	SearchEngineResources::SearchEngineResources(size_t _threads, size_t _tableMegabytes, bool _hugePages) :
+		table_{ _tableMegabytes, _hugePages },
+		max_threads_{ std::max<size_t>(_threads, 1) },
+		free_helpers_{ max_threads_ - 1 }
+	{};
+
+
+
+	/**
+	 * @brief Searches a board for the best move.
+	 * @param _board The state of the chess board, the engine plays the side whose turn it is.
+	 * @param _clock The game clock, nullopt if the game isn't timed.
+	 * @return Search result, the best move is nullopt if there are no legal moves.
+	*/
+	SearchResult ChessEngine_Search::determine_best_move(const BoardWithState& _board, const std::optional<GameClock>& _clock)
+	{
+		// Other games may be searching too, only take the threads they aren't using
+		const auto _helpers = this->resources_->acquire_threads(this->searcher_.thread_count() - 1);
+		this->last_threads_ = _helpers + 1;
+
+		this->resources_->table().new_search();
+		SearchResult _result{};
+		if (_clock)
+		{
+			_result = this->searcher_.search(_board, max_search_ply_v, budget_move_time(*_clock, _board.turn), this->last_threads_);
+		}
+		else
+		{
+			const auto _depth = static_cast<int>(search_depth_for_board(_board));
+			_result = this->searcher_.search(_board, _depth, untimed_budget_v, this->last_threads_);
+		};
+
+		this->resources_->release_threads(_helpers);
+		return _result;
+	};
+
+	void ChessEngine_Search::play_turn(IGameInterface& _game)
+	{
+		println("playing turn for game {}", _game.get_game_name());
+
+		jc::timer _tm{};
+		_tm.start();
+		const auto _result = this->determine_best_move(_game.get_board(), _game.get_clock());
+		const auto _seconds = std::chrono::duration_cast<std::chrono::duration<double>>(_tm.elapsed()).count();
+
+		println("searched depth {} ({} plies with captures) with {} threads in {}s, {} nodes, rating {}",
+			_result.depth, _result.stats.max_ply, this->last_threads_, _seconds, _result.stats.nodes, _result.rating);
+		println("transposition table hit rate {}%, fill rate {}%, {} collisions",
+			_result.stats.table.hit_rate() * 100.0, this->resources_->table().fill_rate() * 100.0, _result.stats.table.collisions);
+
+		if (!_result.best_move || !_game.submit_move(*_result.best_move))
+		{
+			_game.resign();
+		};
+	};
+
+	/**
+	 * @brief Constructs the engine
+	 * @param _resources Table and thread budget to search with, may be shared with other engines
+	*/
+	ChessEngine_Search::ChessEngine_Search(std::shared_ptr<SearchEngineResources> _resources) :
+		resources_{ std::move(_resources) },
+		searcher_{ resources_->table(), resources_->max_threads() }
+	{};
+
+	/**
+	 * @brief Constructs the engine with a table and thread budget of its own
+	*/
+	ChessEngine_Search::ChessEngine_Search() :
+		ChessEngine_Search{ std::make_shared<SearchEngineResources>() }
+	{};
+};
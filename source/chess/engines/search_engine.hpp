@@ -0,0 +1,137 @@
+#pragma once
+
+#include "tree_engine/tree_build.hpp"
+
+#include <lambdex/chess/search.hpp>
+#include <lambdex/chess/parallel_search.hpp>
+#include <lambdex/chess/time_management.hpp>
+#include <lambdex/chess/transposition_table.hpp>
+#include <lambdex/chess/chess_engine.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+namespace lbx::chess
+{
+	/**
+	 * @brief Search state shared by every ChessEngine_Search playing at once.
+	 *
+	 * Games played at the same time share one transposition table, so memory use doesn't grow
+	 * with the number of games, and draw their search threads from one budget so together
+	 * they don't start more threads than the hardware has. A turn takes whatever threads are
+	 * free when it starts and hands them back when it ends. If none are free it still searches
+	 * on the thread playing the turn.
+	*/
+	class SearchEngineResources
+	{
+	public:
+
+		/**
+		 * @brief Gets the shared transposition table
+		*/
+		TranspositionTable& table() noexcept
+		{
+			return this->table_;
+		};
+
+		/**
+		 * @brief Gets the most threads a single search may use, the thread playing the turn included
+		*/
+		size_t max_threads() const noexcept
+		{
+			return this->max_threads_;
+		};
+
+		/**
+		 * @brief Takes helper threads from the budget
+		 * @param _wanted Most helper threads to take
+		 * @return Helper threads taken, may be 0, give them back with release_threads()
+		*/
+		size_t acquire_threads(size_t _wanted) noexcept;
+
+		/**
+		 * @brief Gives helper threads back to the budget
+		 * @param _count Helper threads to give back, as returned by acquire_threads()
+		*/
+		void release_threads(size_t _count) noexcept;
+
+		/**
+		 * @brief Constructs the shared state
+		 * @param _threads Threads shared between the games, defaults to one per hardware thread
+		 * @param _tableMegabytes Size of the transposition table
+		 * @param _hugePages Ask for the transposition table to be backed by huge pages
+		*/
+		explicit SearchEngineResources(size_t _threads = std::max(std::thread::hardware_concurrency(), 1u),
+			size_t _tableMegabytes = 64, bool _hugePages = true);
+
+	private:
+
+		TranspositionTable table_;
+		size_t max_threads_;
+
+		/**
+		 * @brief Helper threads not in use, the thread playing each turn isn't counted
+		*/
+		std::atomic<size_t> free_helpers_;
+	};
+
+	/**
+	 * @brief Plays the best move found by a depth first alpha-beta search.
+	 *
+	 * Unlike ChessEngine_Baby no move tree is built, the search walks a single board and
+	 * only keeps the current line, so memory use stays flat however deep it goes. In timed
+	 * games the search is deepened one ply at a time until the time budgeted from the clock
+	 * runs out, otherwise the depth is picked the same way as the baby engine's. Results
+	 * are kept in a transposition table from one turn to the next, which is also how the
+	 * search threads share their work (see ParallelSearcher). The table and the threads come
+	 * from SearchEngineResources, which may be shared with other games.
+	*/
+	class ChessEngine_Search : public IChessEngine
+	{
+	public:
+
+		/**
+		 * @brief Searches a board for the best move.
+		 * @param _board The state of the chess board, the engine plays the side whose turn it is.
+		 * @param _clock The game clock, nullopt if the game isn't timed.
+		 * @return Search result, the best move is nullopt if there are no legal moves.
+		*/
+		SearchResult determine_best_move(const BoardWithState& _board, const std::optional<GameClock>& _clock = std::nullopt);
+
+		/**
+		 * @brief Plays a turn using this chess engine
+		 * @param _game The game to play a turn in.
+		*/
+		void play_turn(IGameInterface& _game) final;
+
+		/**
+		 * @brief Constructs the engine
+		 * @param _resources Table and thread budget to search with, may be shared with other engines
+		*/
+		explicit ChessEngine_Search(std::shared_ptr<SearchEngineResources> _resources);
+
+		/**
+		 * @brief Constructs the engine with a table and thread budget of its own
+		*/
+		ChessEngine_Search();
+
+	private:
+
+		/**
+		 * @brief Table and thread budget, shared with other games
+		*/
+		std::shared_ptr<SearchEngineResources> resources_;
+
+		/**
+		 * @brief Searcher used for every turn
+		*/
+		ParallelSearcher<BoardRater_Complete> searcher_;
+
+		/**
+		 * @brief Threads used by the last search, the thread playing the turn included
+		*/
+		size_t last_threads_ = 1;
+	};
+};
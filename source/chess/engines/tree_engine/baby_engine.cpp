@@ -5,6 +5,7 @@
 
 #include <lambdex/chess/chess.hpp>
 #include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/search.hpp>
 #include <lambdex/chess/piece_movement.hpp>
 
 #include <jclib/guard.h>
@@ -28,41 +29,25 @@ namespace lbx::chess
 
 	size_t ChessEngine_Baby::determine_search_depth(const BoardWithState& _board, TurnStats* _stats) const
 	{
-		const auto _complexity = rate_complexity(_board);
-		size_t _treeDepth = 3;
-
-		if (_complexity <= 50)
-		{
-			_treeDepth = 7;
-		}
-		else if (_complexity <= 100)
-		{
-			_treeDepth = 6;
-		}
-		else if (_complexity <= 150)
-		{
-			_treeDepth = 5;
-		}
-		else if (_complexity <= 500)
-		{
-			_treeDepth = 4;
-		}
-		else
+		if (_stats)
 		{
-			_treeDepth = 3;
+			_stats->complexity = rate_complexity(_board);
 		};
-
-		return _treeDepth;
+		return search_depth_for_board(_board);
 	};
 
 	MoveTree ChessEngine_Baby::construct_move_tree(const BoardWithState& _board, size_t _depth, TurnStats* _stats)
 	{
 		TreeBuilder _builder{};
+		_builder.eval_cache = this->eval_cache_.get();
+		_builder.prune_losing_captures = true;
 
 		if (_depth <= 2)
 		{
 			// Construct tree in this thread
-			return _builder.make_move_tree(_board, _depth);
+			auto _moveTree = _builder.make_move_tree(_board, _depth);
+			_builder.flush_eval_stats();
+			return _moveTree;
 		}
 		else
 		{
@@ -70,25 +55,42 @@ namespace lbx::chess
 
 			// Create the initial set of responses
 			auto _moveTree = _builder.make_move_tree(_board);
+			_builder.flush_eval_stats();
 
 			// Fill out branches
 			{
 				auto& _buildPool = *this->build_pool_;
+				TreeBuildScheduler _scheduler{ _buildPool.size() };
 
-				// Assign nodes out to the threads
+				// Deal the root moves out between the threads, the rest is shared out as the threads
+				// split their subtrees
+				size_t _worker = 0;
 				for (auto& m : _moveTree)
 				{
-					// Create the task
-					auto _board = _moveTree.initial_board_;
-					apply_move(_board, m.get_move());
-					TreeBuildTask _task{ _board, m, _depth - 1 };
+					TreeBuildJob _job{ _moveTree.initial_board_, &m, _depth - 1 };
+					apply_move(_job.board, m.get_move());
+					_scheduler.push(_worker, std::move(_job));
+					_worker = (_worker + 1) % _scheduler.worker_count();
+				};
 
-					// Assign work to pool
-					_buildPool.assign_work(std::move(_task));
+				// Start every thread on the scheduler
+				for (size_t n = 0; n != _scheduler.worker_count(); ++n)
+				{
+					_buildPool.assign_work(TreeBuildTask{ jc::reference_ptr{ _scheduler }, n, this->eval_cache_.get(), true });
 				};
 
 				// Wait until pool is finished
 				_buildPool.wait_until_all_finished();
+
+				if (_stats)
+				{
+					_stats->tree_build_busy_durations.resize(_scheduler.worker_count());
+					for (size_t n = 0; n != _scheduler.worker_count(); ++n)
+					{
+						_stats->tree_build_busy_durations[n] = _scheduler.busy_time(n);
+						_stats->tree_build_steals += _scheduler.steal_count(n);
+					};
+				};
 			};
 
 			// Return finished tree
@@ -111,20 +113,24 @@ namespace lbx::chess
 		_turnTime.start();
 		
 		// Determine how deep to search
-		const auto _treeDepth = this->determine_search_depth(_board);
+		const auto _treeDepth = this->determine_search_depth(_board, _stats);
 		if (_stats)
 		{
 			_stats->search_depth = _treeDepth;
 		};
 
 		// Build our move tree
-		auto _moveTree = this->construct_move_tree(_board, _treeDepth);
+		const auto _evalStatsBefore = this->eval_cache_->stats();
+		auto _moveTree = this->construct_move_tree(_board, _treeDepth, _stats);
 		const auto _treeTime = _tm.elapsed();
 
 		if (_stats)
 		{
+			const auto _evalStats = this->eval_cache_->stats();
 			_stats->move_tree_node_count = _moveTree.child_count();
 			_stats->tree_build_duration = _treeTime;
+			_stats->eval_cache_hits = _evalStats.hits - _evalStatsBefore.hits;
+			_stats->eval_cache_misses = _evalStats.misses - _evalStatsBefore.misses;
 		};
 		
 		_tm.start();
@@ -189,15 +195,31 @@ namespace lbx::chess
 			_times["turn"] = _stats.turn_duration.count();
 			_times["tree_build"] = _stats.tree_build_duration.count();
 			_times["tree_search"] = _stats.tree_search_duration.count();
+
+			json _busy = json::array();
+			for (auto& _duration : _stats.tree_build_busy_durations)
+			{
+				_busy.push_back(_duration.count());
+			};
+			_times["tree_build_busy"] = _busy;
 			_json["times"] = _times;
 		};
 
 		{
 			json _tree = json::object();
 			_tree["depth"] = _stats.search_depth;
+			_tree["complexity"] = _stats.complexity;
 			_tree["size"] = _stats.move_tree_node_count;
+			_tree["steals"] = _stats.tree_build_steals;
 			_json["tree"] = _tree;
 		};
+
+		{
+			json _cache = json::object();
+			_cache["hits"] = _stats.eval_cache_hits;
+			_cache["misses"] = _stats.eval_cache_misses;
+			_json["eval_cache"] = _cache;
+		};
 		
 		{
 			json _lines = json::array();
@@ -261,7 +283,8 @@ namespace lbx::chess
 
 
 	ChessEngine_Baby::ChessEngine_Baby(std::shared_ptr<TreeBuildPool> _pool) :
-		build_pool_{ std::move(_pool) }
+		build_pool_{ std::move(_pool) },
+		eval_cache_{ std::make_unique<EvalCache>(eval_cache_mb_v) }
 	{
 		JCLIB_ASSERT(this->build_pool_);
 	};
@@ -49,6 +49,17 @@ namespace lbx::chess
 			*/
 			std::chrono::duration<double> tree_search_duration{ 0.0f };
 
+			/**
+			 * @brief The time each tree building thread spent building, in thread order. Time spent
+			 * waiting for work isn't counted. Empty if the tree was built on a single thread.
+			*/
+			std::vector<std::chrono::duration<double>> tree_build_busy_durations{};
+
+			/**
+			 * @brief The number of subtrees threads took from each other while building the move tree.
+			*/
+			uint64_t tree_build_steals = 0;
+
 			/**
 			 * @brief The list of move lines the engine searched down sorted from best to worst.
 			*/
@@ -59,6 +70,21 @@ namespace lbx::chess
 			*/
 			size_t search_depth = 0;
 
+			/**
+			 * @brief Eval cache lookups that found a rating while building the move tree.
+			*/
+			uint64_t eval_cache_hits = 0;
+
+			/**
+			 * @brief Eval cache lookups that had to rate the board while building the move tree.
+			*/
+			uint64_t eval_cache_misses = 0;
+
+			/**
+			 * @brief The board complexity used to pick the search depth, see rate_complexity().
+			*/
+			Rating complexity = 0;
+
 			/**
 			 * @brief The total number of nodes constructed in the move tree.
 			*/
@@ -175,5 +201,15 @@ namespace lbx::chess
 		*/
 		std::shared_ptr<TreeBuildPool> build_pool_;
 
+		/**
+		 * @brief Size of the eval cache in megabytes
+		*/
+		constexpr static size_t eval_cache_mb_v = 16;
+
+		/**
+		 * @brief Board ratings kept between turns, shared by the tree building threads
+		*/
+		std::unique_ptr<EvalCache> eval_cache_;
+
 	};
 };
\ No newline at end of file
@@ -3,65 +3,225 @@
 #include "chess/engines/random_engine.hpp"
 
 #include <span>
+#include <array>
+#include <algorithm>
 
 
 namespace lbx::chess
 {
 
-	std::vector<RatedMove> TreeBuilder::rank_possible_moves(const BoardWithState& _board)
+	namespace
 	{
-		// Generate possible boards from 1 move
-		auto _randomMoves = ChessEngine_Random{}.calculate_multiple_moves(_board, _board.turn);
-		std::vector<RatedMove> _rankedMoves(_randomMoves.size());
-		auto _it = _rankedMoves.begin();
+		using RatedMoveBuffer = std::array<RatedMove, MoveList::capacity_v>;
+
+		/**
+		 * @brief Pairs each move in a scored move list with its score
+		 * @param _moves Moves scored by their rating
+		 * @param _buffer Storage for the rated moves
+		 * @return Span over the rated moves written into the buffer
+		*/
+		std::span<const RatedMove> as_rated_moves(const MoveList& _moves, RatedMoveBuffer& _buffer)
+		{
+			for (size_t n = 0; n != _moves.size(); ++n)
+			{
+				_buffer[n] = RatedMove{ _moves[n], _moves.score(n) };
+			};
+			return std::span{ _buffer.data(), _moves.size() };
+		};
+
+		/**
+		 * @brief Moves captures that lose material by static exchange to the end, keeping the order otherwise
+		 * @param _board Board the moves are for
+		 * @param _moves Moves to reorder
+		 * @param _prune If true, the losing captures are dropped instead unless that would leave no moves
+		 * @return Reordered moves
+		*/
+		MoveList order_losing_captures(const BoardWithState& _board, const MoveList& _moves, bool _prune)
+		{
+			MoveList _out{};
+			MoveList _losing{};
+			for (size_t n = 0; n != _moves.size(); ++n)
+			{
+				auto& _list = (is_losing_capture(_board, _moves[n])) ? _losing : _out;
+				_list.push_back(_moves[n], _moves.score(n));
+			};
+
+			if (!_prune || _out.empty())
+			{
+				for (size_t n = 0; n != _losing.size(); ++n)
+				{
+					_out.push_back(_losing[n], _losing.score(n));
+				};
+			};
+			return _out;
+		};
+	};
 
-		for (auto& m : std::span{ _randomMoves.data(), _randomMoves.size() })
+	MoveList TreeBuilder::rank_possible_moves(BoardWithState& _board, bool _pruneLosingCaptures)
+	{
+		// Generate possible boards from 1 move
+		auto _moves = ChessEngine_Random{}.calculate_multiple_moves(_board, _board.turn);
+		if (this->eval_cache)
+		{
+			const BoardRater_Cached<BoardRater_Complete> _rater{ *this->eval_cache, {}, &this->eval_stats };
+			rate_children(_board, _moves, _rater);
+		}
+		else
 		{
-			*_it = rate_move<BoardRater_Complete>(_board, m);
-			++_it;
+			rate_children<BoardRater_Complete>(_board, _moves);
 		};
 
-		// Sort by value
-		std::ranges::sort(_rankedMoves, jc::greater);
-		return _rankedMoves;
+		// Sort by value, captures that lose the exchange go last
+		_moves.sort_by_score();
+		return order_losing_captures(_board, _moves, _pruneLosingCaptures);
 	};
 
 
-	void TreeBuilder::calculate_move_tree_node_responses(const BoardWithState& _board, MoveTree::Node* _previous)
+	void TreeBuilder::calculate_move_tree_node_responses(BoardWithState& _board, MoveTree::Node* _previous)
 	{
-		if (_previous->get_rating() < -10000 || _previous->get_rating() > 10000)
+		// Only checkmates end a line. Won endgames are rated far above the normal evaluation too,
+		// but they still have to be played out or a move that hangs the winning piece looks as
+		// good as any other.
+		const auto _mateRating = BoardRater_Checkmate{}.checkmate_value / 2;
+		if (_previous->get_rating() <= -_mateRating || _previous->get_rating() >= _mateRating)
 		{
 			return;
 		}
 		else
 		{
-			auto _moves = this->rank_possible_moves(_board);
-			_previous->set_responses(_moves);
+			const auto _moves = this->rank_possible_moves(_board, this->prune_losing_captures);
+			RatedMoveBuffer _buffer;
+			_previous->set_responses(as_rated_moves(_moves, _buffer));
 		};
 	};
-	void TreeBuilder::calculate_move_tree_node_responses(const BoardWithState& _board, MoveTree::Node* _previous, size_t _depth)
+	void TreeBuilder::calculate_move_tree_node_responses(BoardWithState& _board, MoveTree::Node* _previous, size_t _depth)
 	{
 		this->calculate_move_tree_node_responses(_board, _previous);
 		if (_depth != 0 && _previous->has_responses())
 		{
 			--_depth;
+			if (this->scheduler && _depth >= this->split_depth)
+			{
+				// Big enough to be worth sharing, idle threads can steal these
+				for (auto& r : _previous->responses())
+				{
+					TreeBuildJob _job{ _board, &r, _depth };
+					apply_move(_job.board, r.get_move());
+					this->scheduler->push(this->worker, std::move(_job));
+				};
+				return;
+			};
+
 			for (auto& r : _previous->responses())
 			{
-				BoardWithState _newBoard{ _board };
-				apply_move(_newBoard, r.get_move());
-				this->calculate_move_tree_node_responses(_newBoard, &r, _depth);
+				const auto _undo = make_move(_board, r.get_move());
+				this->calculate_move_tree_node_responses(_board, &r, _depth);
+				unmake_move(_board, r.get_move(), _undo);
+			};
+		};
+	};
+
+	void TreeBuildScheduler::push(size_t _worker, TreeBuildJob _job)
+	{
+		this->pending_.fetch_add(1, std::memory_order_relaxed);
+		auto& _queue = this->workers_[_worker];
+		auto _lck = std::unique_lock{ _queue.mtx };
+		_queue.jobs.push_back(std::move(_job));
+	};
+
+	std::optional<TreeBuildJob> TreeBuildScheduler::pop(size_t _worker)
+	{
+		auto& _queue = this->workers_[_worker];
+		auto _lck = std::unique_lock{ _queue.mtx };
+		if (_queue.jobs.empty())
+		{
+			return std::nullopt;
+		};
+		auto _job = std::move(_queue.jobs.back());
+		_queue.jobs.pop_back();
+		return _job;
+	};
+
+	std::optional<TreeBuildJob> TreeBuildScheduler::steal(size_t _worker)
+	{
+		// Find the deepest job waiting at the front of a queue
+		size_t _victim = _worker;
+		size_t _victimDepth = 0;
+		for (size_t n = 1; n != this->worker_count_; ++n)
+		{
+			const auto _other = (_worker + n) % this->worker_count_;
+			auto& _queue = this->workers_[_other];
+			auto _lck = std::unique_lock{ _queue.mtx };
+			if (!_queue.jobs.empty() && (_victim == _worker || _queue.jobs.front().depth > _victimDepth))
+			{
+				_victim = _other;
+				_victimDepth = _queue.jobs.front().depth;
+			};
+		};
+		if (_victim == _worker)
+		{
+			return std::nullopt;
+		};
+
+		// It may have been taken in the meantime, the next try will look again
+		auto& _queue = this->workers_[_victim];
+		auto _lck = std::unique_lock{ _queue.mtx };
+		if (_queue.jobs.empty())
+		{
+			return std::nullopt;
+		};
+		auto _job = std::move(_queue.jobs.front());
+		_queue.jobs.pop_front();
+		++this->workers_[_worker].steals;
+		return _job;
+	};
+
+	void TreeBuildScheduler::work(size_t _worker, TreeBuilder& _builder)
+	{
+		using clock = std::chrono::steady_clock;
+
+		JCLIB_ASSERT(_builder.scheduler == this && _builder.worker == _worker);
+		auto& _self = this->workers_[_worker];
+		while (this->pending_.load(std::memory_order_acquire) != 0)
+		{
+			auto _job = this->pop(_worker);
+			if (!_job)
+			{
+				_job = this->steal(_worker);
+				if (!_job)
+				{
+					std::this_thread::yield();
+					continue;
+				};
 			};
+
+			const auto _start = clock::now();
+			_builder.calculate_move_tree_node_responses(_job->board, _job->node, _job->depth);
+			_self.busy += clock::now() - _start;
+
+			// Any subtrees split off were pushed before this, so pending can't reach zero early
+			this->pending_.fetch_sub(1, std::memory_order_acq_rel);
 		};
 	};
 
+	TreeBuildScheduler::TreeBuildScheduler(size_t _workers) :
+		workers_{ std::make_unique<Worker[]>(_workers) },
+		worker_count_{ _workers }
+	{
+		JCLIB_ASSERT(_workers != 0);
+	};
+
+
+
 	MoveTree TreeBuilder::make_move_tree(const BoardWithState& _board)
 	{
 		MoveTree _out{};
 		_out.initial_board_ = _board;
 
-		auto _moves = this->rank_possible_moves(_board);
-		_out.moves_.resize(_moves.size());
-		std::ranges::copy(_moves, _out.moves_.begin());
+		const auto _moves = this->rank_possible_moves(_out.initial_board_);
+		RatedMoveBuffer _buffer;
+		const auto _rated = as_rated_moves(_moves, _buffer);
+		_out.moves_.assign(_rated.begin(), _rated.end());
 
 		return _out;
 	};
@@ -71,11 +231,14 @@ namespace lbx::chess
 		if (_depth != 0)
 		{
 			--_depth;
+
+			// Walk a single board, moves are unmade on the way back up
+			BoardWithState _workBoard{ _board };
 			for (auto& r : _out.moves_)
 			{
-				BoardWithState _newBoard{ _board };
-				apply_move(_newBoard, r.get_move());
-				this->calculate_move_tree_node_responses(_newBoard, &r, _depth);
+				const auto _undo = make_move(_workBoard, r.get_move());
+				this->calculate_move_tree_node_responses(_workBoard, &r, _depth);
+				unmake_move(_workBoard, r.get_move(), _undo);
 			};
 		};
 		return _out;
@@ -5,10 +5,19 @@
 
 
 #include <lambdex/chess/move_tree.hpp>
+#include <lambdex/chess/see.hpp>
+#include <lambdex/chess/endgame.hpp>
+#include <lambdex/chess/move_list.hpp>
+#include <lambdex/chess/eval_cache.hpp>
+#include <lambdex/chess/fused_rater.hpp>
 
 #include <jclib/guard.h>
 
+#include <span>
+#include <deque>
 #include <mutex>
+#include <chrono>
+#include <memory>
 #include <atomic>
 #include <thread>
 #include <vector>
@@ -22,98 +31,56 @@ namespace lbx::chess
 	using RatedLine = std::vector<RatedMove>;
 
 	/**
-	 * @brief Rates a board based on if castling is possible for the players.
+	 * @brief Rates a board using material, piece placement, checkmates, castling rights, mobility and king safety.
+	 *
+	 * Known endgames like KRK or KPK are rated by their specialised evaluation instead, see rate_endgame().
 	*/
-	struct BoardRater_CastleOpportunity
+	struct BoardRater_Complete
 	{
-	public:
-
-		/**
-		 * @brief The rating value for being able to castle kingside.
-		*/
-		Rating kingside_value = 1;
-
-		/**
-		 * @brief The rating value for being able to castle queenside.
-		*/
-		Rating queenside_value = 1;
-
-		/**
-		 * @brief Rates a board based on if castling is possible for the players.
-		 *
-		 * @param _board Board to rate.
-		 * @param _player Player whose POV to rate from.
-		 *
-		 * @return Rating based on opportunity to castle.
-		*/
-		Rating rate(const BoardWithState& _board, Color _player) const
+		int rate(const BoardWithState& _board, Color _player) const
 		{
-			const auto _myPoints =
-				(this->queenside_value * _board.can_player_castle_queenside(_player)) +
-				(this->kingside_value * _board.can_player_castle_kingside(_player));
-			const auto _opponentPoints =
-				(this->queenside_value * _board.can_player_castle_queenside(!_player)) +
-				(this->kingside_value * _board.can_player_castle_kingside(!_player));
-			return _myPoints - _opponentPoints;
+			if (const auto _endgame = rate_endgame(_board, _player))
+			{
+				return *_endgame;
+			};
+			const auto _final = this->terms_.rate(_board, _player);
+			const auto _limit = this->terms_.get<1>().checkmate_value;
+			return std::clamp(_final, -_limit, _limit);
 		};
-	};
-	static_assert(cx_board_rater<BoardRater_CastleOpportunity>);
 
-	/**
-	 * @brief Rates a board based on if a player is in checkmate.
-	*/
-	struct BoardRater_Checkmate
-	{
-	public:
-
-		/**
-		 * @brief The rating value for putting the opponent in checkmate.
-		*/
-		Rating checkmate_value = 1000000;
-
-		/**
-		 * @brief Rates a board based on if any of the players are in checkmate.
-		 *
-		 * @param _board Board to rate.
-		 * @param _player Player whose POV to rate from.
-		 *
-		 * @return Rating based on checkmates.
-		*/
-		Rating rate(const BoardWithState& _board, Color _player) const
+		int rate(const BoardWithState& _board, Color _player, RatingWindow _window, LazyEvalStats* _stats = nullptr) const
 		{
-			if (is_checkmate(_board, _player))
-			{
-				return -this->checkmate_value;
-			}
-			else if (is_checkmate(_board, !_player))
+			if (const auto _endgame = rate_endgame(_board, _player))
 			{
-				return this->checkmate_value;
-			}
-			else
-			{
-				return 0;
+				return *_endgame;
 			};
+			const auto _final = this->terms_.rate(_board, _player, _window, _stats);
+			const auto _limit = this->terms_.get<1>().checkmate_value;
+			return std::clamp(_final, -_limit, _limit);
 		};
 
-	};
-	static_assert(cx_board_rater<BoardRater_Checkmate>);
-
-	struct BoardRater_Complete
-	{
-		int rate(const BoardWithState& _board, Color _player) const
+		void rate_batch(std::span<const BoardWithState> _boards, Color _player, std::span<Rating> _out) const
 		{
-			const auto _materialRating = chess::rate<BoardRater_Material>(_board, _player);
-			const auto _checkmateRating = chess::rate(_board, _player, this->checkmate_rater_);
-			const auto _castleOpportunityRating = chess::rate<BoardRater_CastleOpportunity>(_board, _player);
-
-			const auto _final = _materialRating + _checkmateRating + _castleOpportunityRating;
-			return std::clamp(_final, -this->checkmate_rater_.checkmate_value, this->checkmate_rater_.checkmate_value);
+			this->terms_.rate_batch(_boards, _player, _out);
+			const auto _limit = this->terms_.get<1>().checkmate_value;
+			for (size_t n = 0; n != _boards.size(); ++n)
+			{
+				const auto _endgame = rate_endgame(_boards[n], _player);
+				_out[n] = (_endgame) ? *_endgame : std::clamp(_out[n], -_limit, _limit);
+			};
 		};
 
-
-		BoardRater_Checkmate checkmate_rater_{};
+		// Material is in centipawns, castling rights are worth a fifth of a pawn. Mobility and
+		// king safety share their attack sets through the fused rater's context.
+		BoardRater_Fused<BoardRater_PieceSquare, BoardRater_Checkmate, BoardRater_CastleOpportunity,
+			BoardRater_Mobility, BoardRater_KingSafety> terms_
+		{
+			BoardRater_PieceSquare{}, BoardRater_Checkmate{}, BoardRater_CastleOpportunity{ 20, 20 },
+			BoardRater_Mobility{}, BoardRater_KingSafety{}
+		};
 	};
-	static_assert(cx_board_rater<BoardRater_Complete>);
+	static_assert(cx_batch_rater<BoardRater_Complete>);
+	static_assert(cx_windowed_rater<BoardRater_Complete>);
 
 
 
@@ -154,18 +121,192 @@ namespace lbx::chess
 
 
 
+	struct TreeBuilder;
+
+	/**
+	 * @brief A subtree of a move tree waiting to be built
+	*/
+	struct TreeBuildJob
+	{
+		/**
+		 * @brief The state of the board after applying the move at node
+		*/
+		BoardWithState board;
+
+		/**
+		 * @brief The node to fill out the responses to
+		*/
+		MoveTree::Node* node = nullptr;
+
+		/**
+		 * @brief How deep to build below the node
+		*/
+		size_t depth = 0;
+	};
+
+	/**
+	 * @brief Shares out the subtrees of a single move tree between several threads.
+	 *
+	 * Each thread has its own queue of jobs. A builder splitting a node pushes the child
+	 * subtrees onto the back of its own queue and keeps working from the back, so it goes
+	 * depth first through its own work. A thread whose queue runs dry steals from the front
+	 * of the queue holding the deepest job, which is the largest subtree waiting anywhere.
+	 *
+	 * Threads keep looking for work until every job pushed has been finished.
+	*/
+	class TreeBuildScheduler
+	{
+	public:
+
+		/**
+		 * @brief Adds a job to a thread's queue
+		 * @param _worker Index of the thread whose queue to add to
+		 * @param _job Job to add
+		*/
+		void push(size_t _worker, TreeBuildJob _job);
+
+		/**
+		 * @brief Runs jobs on the calling thread until every job pushed has been finished
+		 * @param _worker Index of the calling thread
+		 * @param _builder Builder to run the jobs with, any subtrees it splits off go to this thread's queue
+		*/
+		void work(size_t _worker, TreeBuilder& _builder);
+
+		/**
+		 * @brief Gets the number of threads work is shared between
+		*/
+		size_t worker_count() const noexcept
+		{
+			return this->worker_count_;
+		};
+
+		/**
+		 * @brief Gets the time a thread spent running jobs, time spent looking for work isn't counted
+		 * @param _worker Index of the thread
+		*/
+		std::chrono::duration<double> busy_time(size_t _worker) const noexcept
+		{
+			return this->workers_[_worker].busy;
+		};
+
+		/**
+		 * @brief Gets the number of jobs a thread took from the other threads' queues
+		 * @param _worker Index of the thread
+		*/
+		uint64_t steal_count(size_t _worker) const noexcept
+		{
+			return this->workers_[_worker].steals;
+		};
+
+		/**
+		 * @brief Constructs the scheduler
+		 * @param _workers Number of threads work is shared between, at least 1
+		*/
+		explicit TreeBuildScheduler(size_t _workers);
+
+	private:
+
+		/**
+		 * @brief Takes the newest job from a thread's own queue
+		*/
+		std::optional<TreeBuildJob> pop(size_t _worker);
+
+		/**
+		 * @brief Takes the oldest job from whichever other thread's queue holds the deepest one
+		*/
+		std::optional<TreeBuildJob> steal(size_t _worker);
+
+		/**
+		 * @brief Queue and timing for one thread, aligned so no two threads share a cache line
+		*/
+		struct alignas(64) Worker
+		{
+			std::mutex mtx{};
+			std::deque<TreeBuildJob> jobs{};
+			std::chrono::duration<double> busy{ 0.0 };
+			uint64_t steals = 0;
+		};
+
+		std::unique_ptr<Worker[]> workers_;
+		size_t worker_count_;
+
+		/**
+		 * @brief Jobs pushed that haven't been finished yet
+		*/
+		alignas(64) std::atomic<size_t> pending_{ 0 };
+	};
+
+
+
 	struct TreeBuilder
 	{
-		std::vector<RatedMove> rank_possible_moves(const BoardWithState& _board);
+		/**
+		 * @brief Optional cache of board ratings, may be shared with other builders
+		*/
+		EvalCache* eval_cache = nullptr;
+
+		/**
+		 * @brief Eval cache hits and misses seen by this builder, see flush_eval_stats()
+		*/
+		EvalCacheStats eval_stats{};
+
+		/**
+		 * @brief If true, captures that lose material by static exchange are left out of a node's
+		 * responses. The first set of moves from the root is never pruned.
+		*/
+		bool prune_losing_captures = false;
+
+		/**
+		 * @brief Optional scheduler to hand subtrees to so idle threads can help build them
+		*/
+		TreeBuildScheduler* scheduler = nullptr;
+
+		/**
+		 * @brief Index of this builder's thread in the scheduler
+		*/
+		size_t worker = 0;
+
+		/**
+		 * @brief Subtrees at least this deep are handed to the scheduler instead of being built
+		 * straight away, smaller ones aren't worth the trip through a queue.
+		*/
+		size_t split_depth = 2;
+
+		/**
+		 * @brief Adds this builder's eval cache hits and misses to the cache's totals and resets them
+		*/
+		void flush_eval_stats()
+		{
+			if (this->eval_cache)
+			{
+				this->eval_cache->add_stats(this->eval_stats);
+			};
+			this->eval_stats = {};
+		};
+
+		/**
+		 * @brief Rates each possible move for the player whose turn it is
+		 *
+		 * @param _board Board to find moves for, moves are made and unmade on it so it is left unchanged.
+		 * @param _pruneLosingCaptures If true, captures that lose material by static exchange are left out
+		 * unless there is nothing else to play.
+		 * @return Possible moves scored by their rating, sorted from best to worst with captures that
+		 * lose material by static exchange moved to the end.
+		*/
+		MoveList rank_possible_moves(BoardWithState& _board, bool _pruneLosingCaptures = false);
 
 		/**
 		 * @brief Fills out the response nodes for a given move tree node
 		 *
-		 * @param _board Board state after applying the move at _forNode.
+		 * If the builder has a scheduler, subtrees of at least split_depth are pushed to it instead
+		 * of being built here.
+		 *
+		 * @param _board Board state after applying the move at _forNode, moves are made and unmade on it
+		 * so it is left unchanged.
 		 * @param _forNode Node to fill out the responses to.
 		 * @param _depth How deep to fill responses out for. Depth of 0 means just this node.
 		*/
-		void calculate_move_tree_node_responses(const BoardWithState& _board, MoveTree::Node* _forNode, size_t _depth);
+		void calculate_move_tree_node_responses(BoardWithState& _board, MoveTree::Node* _forNode, size_t _depth);
 		
 		/**
 		 * @brief Fills out the response nodes for a given move tree node
@@ -173,7 +314,7 @@ namespace lbx::chess
 		 * @param _board Board state after applying the move at _forNode.
 		 * @param _forNode Node to fill out the responses to.
 		*/
-		void calculate_move_tree_node_responses(const BoardWithState& _board, MoveTree::Node* _forNode);
+		void calculate_move_tree_node_responses(BoardWithState& _board, MoveTree::Node* _forNode);
 
 		MoveTree make_move_tree(const BoardWithState& _board);
 		MoveTree make_move_tree(const BoardWithState& _board, size_t _depth);
@@ -205,18 +346,49 @@ namespace lbx::chess
 		void invoke()
 		{
 			TreeBuilder _builder{};
-			auto& _board = this->board_;
-			_builder.calculate_move_tree_node_responses(_board, this->node_.get(), this->depth_);
+			_builder.eval_cache = this->eval_cache_;
+			_builder.prune_losing_captures = this->prune_losing_captures_;
+			if (this->scheduler_)
+			{
+				_builder.scheduler = this->scheduler_;
+				_builder.worker = this->worker_;
+				this->scheduler_->work(this->worker_, _builder);
+			}
+			else
+			{
+				auto& _board = this->board_;
+				_builder.calculate_move_tree_node_responses(_board, this->node_, this->depth_);
+			};
+			_builder.flush_eval_stats();
 		};
 		void operator()()
 		{
 			this->invoke();
 		};
 
-		TreeBuildTask(BoardWithState _board, jc::reference_ptr<MoveTree::Node> _node, size_t _depth) :
+		TreeBuildTask(BoardWithState _board, jc::reference_ptr<MoveTree::Node> _node, size_t _depth,
+			EvalCache* _evalCache = nullptr, bool _pruneLosingCaptures = false) :
 			board_{ _board },
-			node_{ _node },
-			depth_{ _depth }
+			node_{ _node.get() },
+			depth_{ _depth },
+			eval_cache_{ _evalCache },
+			prune_losing_captures_{ _pruneLosingCaptures }
+		{};
+
+		/**
+		 * @brief Creates a task that runs a scheduler's jobs until they are all finished
+		 * @param _scheduler Scheduler to take jobs from, must outlive the task
+		 * @param _worker Index of the thread the task runs on in the scheduler
+		*/
+		TreeBuildTask(jc::reference_ptr<TreeBuildScheduler> _scheduler, size_t _worker,
+			EvalCache* _evalCache = nullptr, bool _pruneLosingCaptures = false) :
+			board_{},
+			node_{ nullptr },
+			depth_{ 0 },
+			eval_cache_{ _evalCache },
+			prune_losing_captures_{ _pruneLosingCaptures },
+			scheduler_{ _scheduler.get() },
+			worker_{ _worker }
 		{};
 
 	private:
@@ -229,12 +401,32 @@ namespace lbx::chess
 		/**
 		 * @brief The node to start building from
 		*/
-		jc::reference_ptr<MoveTree::Node> node_;
+		MoveTree::Node* node_;
 
 		/**
 		 * @brief How deep to build
 		*/
 		size_t depth_;
+
+		/**
+		 * @brief Optional cache of board ratings shared between tasks
+		*/
+		EvalCache* eval_cache_;
+
+		/**
+		 * @brief Passed on to TreeBuilder::prune_losing_captures
+		*/
+		bool prune_losing_captures_;
+
+		/**
+		 * @brief Scheduler to take jobs from, if set the board, node and depth are unused
+		*/
+		TreeBuildScheduler* scheduler_ = nullptr;
+
+		/**
+		 * @brief Index of the thread the task runs on in the scheduler
+		*/
+		size_t worker_ = 0;
 	};
 
 	using TreeBuildThread = basic_worker_thread<TreeBuildTask>;
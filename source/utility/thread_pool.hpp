@@ -435,6 +435,14 @@ namespace lbx
 			};
 		};
 
+		/**
+		 * @brief Gets the number of worker threads in this pool
+		*/
+		size_type size() const noexcept
+		{
+			return this->workers_.size();
+		};
+
 
 
 
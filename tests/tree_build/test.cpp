@@ -0,0 +1,132 @@
+#include <jclib-test.hpp>
+
+#include "chess/engines/tree_engine/tree_build.hpp"
+
+#include <lambdex/chess/fen.hpp>
+#include <lambdex/chess/search.hpp>
+#include <lambdex/chess/attacks.hpp>
+#include <lambdex/chess/apply_move.hpp>
+#include <lambdex/chess/piece_movement.hpp>
+
+#include <string>
+#include <cstdlib>
+#include <optional>
+
+using namespace lbx::chess;
+
+namespace
+{
+	/**
+	 * @brief Checks if any reply to a move can capture a piece, the move is made on a copy
+	*/
+	bool hangs_piece(const BoardWithState& _board, Move _move, Piece _piece)
+	{
+		auto _after = _board;
+		apply_move(_after, _move);
+		for (auto& m : find_possible_moves(_after))
+		{
+			if (_after.get(m.to) == _piece)
+			{
+				return true;
+			};
+		};
+		return false;
+	};
+
+	/**
+	 * @brief Builds a move tree the way the baby engine does and gets the move it would play
+	*/
+	std::optional<Move> pick_move(const BoardWithState& _board)
+	{
+		TreeBuilder _builder{};
+		_builder.prune_losing_captures = true;
+		const auto _tree = _builder.make_move_tree(_board, search_depth_for_board(_board));
+		const auto _lines = _builder.pick_best_from_tree(_tree);
+		if (_lines.empty())
+		{
+			return std::nullopt;
+		};
+		return _lines.front().front().get_move();
+	};
+};
+
+int subtest_won_endgames_expand()
+{
+	NEWTEST();
+
+	// Won endgames are rated well above the normal evaluation, their lines must still be played out
+	TreeBuilder _builder{};
+	const auto _tree = _builder.make_move_tree(create_board_from_fen("8/8/4k3/8/3Q4/8/8/K7 w - - 0 1"), 4);
+	for (auto& m : _tree)
+	{
+		ASSERT(m.has_responses(), "a won endgame line was not expanded");
+	};
+
+	PASS();
+};
+
+int subtest_keeps_piece()
+{
+	NEWTEST();
+
+	// Positions where a move next to the lone king gives the piece away
+	const char* const _fens[] =
+	{
+		"8/8/8/4k3/2Q5/2K5/8/8 w - - 0 1",
+		"8/8/8/R3k3/8/5K2/8/8 w - - 0 1",
+		"8/8/4k3/8/3Q4/8/8/K7 w - - 0 1",
+		"8/8/3k4/8/8/8/1R6/6K1 w - - 0 1",
+		"8/4k3/8/8/8/8/8/Q5K1 b - - 0 1",
+	};
+	for (auto _fen : _fens)
+	{
+		const auto _board = create_board_from_fen(_fen);
+		const auto _move = pick_move(_board);
+		ASSERT(_move.has_value());
+		ASSERT(!hangs_piece(_board, *_move, Piece::queen | Color::white), "queen left hanging");
+		ASSERT(!hangs_piece(_board, *_move, Piece::rook | Color::white), "rook left hanging");
+	};
+
+	// The piece on every square within two king moves of the lone king, where it can step next to it
+	for (auto _letter : { 'Q', 'R' })
+	{
+		const auto _piece = ((_letter == 'Q') ? Piece::queen : Piece::rook) | Color::white;
+		for (int p = 0; p != 64; ++p)
+		{
+			// White king on a1, black king on e5
+			if (std::abs(p % 8 - 4) > 2 || std::abs(p / 8 - 4) > 2 || p == 36)
+			{
+				continue;
+			};
+			std::string _squares(64, '1');
+			_squares[0] = 'K';
+			_squares[36] = 'k';
+			_squares[p] = _letter;
+
+			std::string _fen{};
+			for (int _rank = 7; _rank >= 0; --_rank)
+			{
+				_fen += _squares.substr(_rank * 8, 8);
+				_fen += (_rank == 0) ? " w - - 0 1" : "/";
+			};
+
+			const auto _board = create_board_from_fen(_fen);
+			if (square_attacked_by(_board, Position{ 36 }, Color::white).any())
+			{
+				continue;
+			};
+			const auto _move = pick_move(_board);
+			ASSERT(_move && !hangs_piece(_board, *_move, _piece), "piece left hanging");
+		};
+	};
+
+	PASS();
+};
+
+int main()
+{
+	NEWTEST();
+	SUBTEST(subtest_won_endgames_expand);
+	SUBTEST(subtest_keeps_piece);
+	PASS();
+};